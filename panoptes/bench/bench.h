@@ -0,0 +1,251 @@
+#ifndef BENCH_BENCH_H_
+#define BENCH_BENCH_H_
+
+// What the benchmarks share: the harness that times them and counts their
+// heap allocations, and their inputs (the conjugations file's lemmas, a fixed
+// Zipfian mix of them, and sayable verbs over that mix).
+//
+// Every benchmark is one source file, which includes this once (it replaces
+// the global operator new).  Each takes its required arguments, then
+// optionally [min_seconds] [filter]: each case runs for at least min_seconds
+// (default 1), after one warm-up pass over its inputs, and if filter is given
+// only the cases whose names contain it are run.  Results go to stdout as
+// JSON, and a summary to stderr, so runs can be compared across commits.
+
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "cc/base/file.h"
+#include "cc/base/time.h"
+#include "cc/core/ling/verb/internal/conjugation/conjugator.h"
+#include "cc/core/ling/verb/internal/parsing/flat_vwc_fields.h"
+#include "cc/core/ling/verb/internal/parsing/verb_parser.h"
+#include "cc/core/ling/verb/internal/saying/verb_sayer.h"
+#include "cc/format/json_writer.h"
+
+using std::atomic;
+using std::discrete_distribution;
+using std::memory_order_relaxed;
+using std::mt19937;
+using std::string;
+using std::vector;
+
+#define SEED 1337
+
+// -----------------------------------------------------------------------------
+// Allocation counting.
+
+static atomic<uint64_t> NUM_ALLOCS(0);
+
+void* operator new(size_t size) {
+    NUM_ALLOCS.fetch_add(1, memory_order_relaxed);
+    void* p = malloc(size ? size : 1);
+    if (!p) {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+void* operator new[](size_t size) {
+    NUM_ALLOCS.fetch_add(1, memory_order_relaxed);
+    void* p = malloc(size ? size : 1);
+    if (!p) {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+void operator delete(void* p) noexcept {
+    free(p);
+}
+
+void operator delete[](void* p) noexcept {
+    free(p);
+}
+
+// -----------------------------------------------------------------------------
+// Harness.
+
+struct BenchResult {
+    string name;
+    uint64_t num_ops;
+    uint64_t nanos;
+    uint64_t num_allocs;
+
+    double ns_per_op() const {
+        return static_cast<double>(nanos) / static_cast<double>(num_ops);
+    }
+};
+
+struct BenchOptions {
+    uint64_t min_nanos;
+    const char* filter;
+};
+
+// Parse the [min_seconds] [filter] after the num_args required arguments.
+// Returns false (having printed usage) if there are too few or too many.
+inline bool InitBenchOptions(int argc, char* argv[], int num_args,
+                             const char* usage, BenchOptions* options) {
+    if (argc < 1 + num_args || 3 + num_args < argc) {
+        fprintf(stderr, "Usage: %s %s [min_seconds] [filter]\n", argv[0],
+                usage);
+        return false;
+    }
+    options->min_nanos = 1000000000;
+    if (2 + num_args <= argc) {
+        options->min_nanos =
+            static_cast<uint64_t>(atof(argv[1 + num_args]) * 1e9);
+    }
+    options->filter = argc == 3 + num_args ? argv[2 + num_args] : NULL;
+    return true;
+}
+
+// Run op(i) over i = 0 .. num_inputs - 1 once to warm up, then over and over
+// (wrapping around) in doubling rounds until it has taken min_nanos.  Returns
+// the result, or NULL if filtered out.
+template <typename Op>
+const BenchResult* Run(const BenchOptions& options, const char* name,
+                       size_t num_inputs, Op op,
+                       vector<BenchResult>* results) {
+    if (options.filter && !strstr(name, options.filter)) {
+        return NULL;
+    }
+
+    for (size_t i = 0; i < num_inputs; ++i) {
+        op(i);
+    }
+
+    BenchResult r;
+    r.name = name;
+    r.num_ops = 0;
+    r.nanos = 0;
+    r.num_allocs = 0;
+    size_t next = 0;
+    for (uint64_t round = 1; r.nanos < options.min_nanos; round *= 2) {
+        uint64_t allocs_begin = NUM_ALLOCS.load(memory_order_relaxed);
+        uint64_t begin = Time::MonotonicNanos();
+        for (uint64_t j = 0; j < round; ++j) {
+            op(next);
+            if (++next == num_inputs) {
+                next = 0;
+            }
+        }
+        r.nanos += Time::MonotonicNanos() - begin;
+        r.num_allocs += NUM_ALLOCS.load(memory_order_relaxed) - allocs_begin;
+        r.num_ops += round;
+    }
+
+    double num_ops = static_cast<double>(r.num_ops);
+    fprintf(stderr, "%-32s %14.1f ops/sec %14.1f ns/op %12.2f allocs/op\n",
+            name, num_ops / (static_cast<double>(r.nanos) / 1e9),
+            r.ns_per_op(), static_cast<double>(r.num_allocs) / num_ops);
+    results->emplace_back(r);
+    return &results->back();
+}
+
+inline void WriteResults(const vector<BenchResult>& results,
+                         size_t num_lemmas) {
+    json::Writer w(stdout);
+    w.BeginObject();
+    w.WriteKey("seed");
+    w.WriteUInt(SEED);
+    w.WriteKey("num_lemmas");
+    w.WriteUInt(num_lemmas);
+    w.WriteKey("benchmarks");
+    w.BeginArray();
+    for (auto& r : results) {
+        double num_ops = static_cast<double>(r.num_ops);
+        w.BeginObject();
+        w.WriteKey("name");
+        w.WriteString(r.name);
+        w.WriteKey("ops");
+        w.WriteUInt(r.num_ops);
+        w.WriteKey("nanos");
+        w.WriteUInt(r.nanos);
+        w.WriteKey("ops_per_sec");
+        w.WriteDouble(num_ops / (static_cast<double>(r.nanos) / 1e9), 6);
+        w.WriteKey("ns_per_op");
+        w.WriteDouble(r.ns_per_op(), 6);
+        w.WriteKey("allocs_per_op");
+        w.WriteDouble(static_cast<double>(r.num_allocs) / num_ops, 6);
+        w.EndObject();
+    }
+    w.EndArray();
+    w.EndObject();
+    w.Flush();
+    printf("\n");
+}
+
+// -----------------------------------------------------------------------------
+// Inputs.
+
+// Read the conjugations file, and its lemmas in file order (be, have, do
+// first).
+inline bool LoadConjugations(const char* conjugations_f,
+                             ConjugationSpecConfig* config,
+                             vector<string>* lemmas) {
+    string s;
+    if (!File::FileToString(conjugations_f, &s)) {
+        fprintf(stderr, "Could not read [%s].\n", conjugations_f);
+        return false;
+    }
+    config->FromString(s);
+    lemmas->clear();
+    for (size_t i = 0; i < config->size(); ++i) {
+        lemmas->emplace_back(config->lemma(i).ToString());
+    }
+    return true;
+}
+
+// Lemma indexes, Zipfian over the order of the lemmas.
+inline void MakeLemmaMix(size_t num_lemmas, size_t count, mt19937* rng,
+                         vector<size_t>* mix) {
+    vector<double> weights;
+    for (size_t i = 0; i < num_lemmas; ++i) {
+        weights.emplace_back(1.0 / static_cast<double>(i + 1));
+    }
+    discrete_distribution<size_t> zipf(weights.begin(), weights.end());
+
+    mix->clear();
+    for (size_t i = 0; i < count; ++i) {
+        mix->emplace_back(zipf(*rng));
+    }
+}
+
+// Sayable verbs over the lemma mix, one each, with the other fields drawn as
+// the parser's tables enumerate them until it is sayable.  Pro-verbs (whose
+// words are wrapped in "<...-pv>") only if with_pro_verbs.
+inline void MakeVerbs(const VerbSayer& sayer, const vector<string>& lemmas,
+                      const vector<size_t>& mix, bool with_pro_verbs,
+                      mt19937* rng, vector<VerbWithContext>* vwcs) {
+    const vector<uint8_t>& num_options = VerbParser::NumOptionsPerField();
+    vwcs->clear();
+    vector<uint8_t> values(num_options.size());
+    size_t i = 0;
+    while (vwcs->size() < mix.size()) {
+        for (size_t j = 0; j < values.size(); ++j) {
+            values[j] = static_cast<uint8_t>((*rng)() % num_options[j]);
+        }
+        if (!with_pro_verbs) {
+            values[FLAT_IS_PRO_VERB] = 0;
+        }
+        vector<string> one_lemma = {lemmas[mix[i]]};
+
+        VerbWithContext vwc;
+        vwc.InitFromVector(values, one_lemma);
+        VerbSayResult r;
+        if (sayer.Say(vwc, &r) != VSS_OK) {
+            continue;
+        }
+        vwcs->emplace_back(vwc);
+        ++i;
+    }
+}
+
+#endif  // BENCH_BENCH_H_
@@ -0,0 +1,113 @@
+// CollapseToWildcards() vs SimpleCollapseToWildcards() on the tuples behind
+// the VerbParser's fir table (every verb said as the placeholder lemma).
+//
+// Usage: collapse_bench <conjugations_f> <modalities_f> <modal_past_tense_f>
+//                       [min_seconds] [filter]
+//
+// Each op collapses a copy of one key's tuples.  Fails if the two disagree.
+
+#include <cstdio>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "bench/bench.h"
+#include "cc/base/combinatorics.h"
+#include "cc/base/parallel.h"
+#include "cc/core/ling/verb/internal/conjugation/conjugator.h"
+#include "cc/core/ling/verb/internal/parsing/lookup_table.h"
+#include "cc/core/ling/verb/internal/parsing/verb_parser.h"
+#include "cc/core/ling/verb/internal/saying/verb_sayer.h"
+
+using std::map;
+using std::string;
+using std::vector;
+
+typedef void (*CollapseFunc)(const vector<uint8_t>&, vector<vector<uint8_t> >*);
+
+// Collapse a copy of each key's tuples.
+static void CollapseAll(
+        CollapseFunc collapse,
+        const vector<const vector<vector<uint8_t> >*>& key_tuples,
+        vector<vector<vector<uint8_t> > >* key_results) {
+    key_results->clear();
+    for (auto& tuples : key_tuples) {
+        key_results->emplace_back(*tuples);
+        collapse(VerbParser::NumOptionsPerField(), &key_results->back());
+    }
+}
+
+int main(int argc, char* argv[]) {
+    BenchOptions options;
+    if (!InitBenchOptions(argc, argv, 3, "<conjugations_f> <modalities_f> "
+                          "<modal_past_tense_f>", &options)) {
+        return 1;
+    }
+
+    ConjugationSpecConfig config;
+    vector<string> lemmas;
+    if (!LoadConjugations(argv[1], &config, &lemmas)) {
+        return 1;
+    }
+
+    Conjugator conj;
+    if (!conj.InitFromConfig(config)) {
+        return 1;
+    }
+    VerbSayer sayer;
+    if (!sayer.Init(&conj, argv[2], argv[3])) {
+        return 1;
+    }
+
+    LookupTableConfig cfg;
+    cfg.Init(VerbParser::NumOptionsPerField(), {"<ints>"}, {false});
+    map<string, vector<vector<uint8_t> > > key2tuples;
+    LookupTable::SayAll(cfg, &sayer, Parallel::DefaultNumThreads(),
+                        &key2tuples);
+
+    vector<const vector<vector<uint8_t> >*> key_tuples;
+    size_t num_tuples = 0;
+    size_t max_tuples = 0;
+    for (auto& it : key2tuples) {
+        key_tuples.emplace_back(&it.second);
+        num_tuples += it.second.size();
+        if (max_tuples < it.second.size()) {
+            max_tuples = it.second.size();
+        }
+    }
+
+    vector<vector<vector<uint8_t> > > simple_results;
+    CollapseAll(Combinatorics::SimpleCollapseToWildcards<uint8_t>, key_tuples,
+                &simple_results);
+    vector<vector<vector<uint8_t> > > packed_results;
+    CollapseAll(Combinatorics::CollapseToWildcards<uint8_t>, key_tuples,
+                &packed_results);
+    if (simple_results != packed_results) {
+        fprintf(stderr, "MISMATCH\n");
+        return 1;
+    }
+
+    size_t num_collapsed = 0;
+    for (auto& tuples : packed_results) {
+        num_collapsed += tuples.size();
+    }
+    fprintf(stderr, "%zu keys, %zu tuples (at most %zu per key) -> %zu.\n",
+            key2tuples.size(), num_tuples, max_tuples, num_collapsed);
+
+    vector<BenchResult> results;
+    Run(options, "combinatorics.simple_collapse", key_tuples.size(),
+        [&](size_t i) {
+        vector<vector<uint8_t> > tuples = *key_tuples[i];
+        Combinatorics::SimpleCollapseToWildcards(
+            VerbParser::NumOptionsPerField(), &tuples);
+    }, &results);
+
+    Run(options, "combinatorics.collapse", key_tuples.size(), [&](size_t i) {
+        vector<vector<uint8_t> > tuples = *key_tuples[i];
+        Combinatorics::CollapseToWildcards(VerbParser::NumOptionsPerField(),
+                                           &tuples);
+    }, &results);
+
+    WriteResults(results, lemmas.size());
+    return 0;
+}
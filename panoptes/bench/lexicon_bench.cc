@@ -0,0 +1,136 @@
+// Full-form lexicon size, build time and lookup speed at scale.
+//
+// Usage: lexicon_bench <conjugations_f> <num_lemmas> [min_seconds] [filter]
+//
+// Grows the conjugations file to num_lemmas (e.g. 100000) made-up verbs by
+// prefixing copies of every verb's forms, then compares conjugating and
+// identifying known forms through the lexicon against deriving them.
+
+#include <cstdio>
+#include <cstdlib>
+#include <initializer_list>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "bench/bench.h"
+#include "cc/base/file.h"
+#include "cc/base/string.h"
+#include "cc/base/time.h"
+#include "cc/core/ling/verb/internal/conjugation/conjugator.h"
+
+using std::mt19937;
+using std::string;
+using std::vector;
+
+#define NUM_INPUTS 100000
+
+// 0 -> "a", 25 -> "z", 26 -> "ab", etc.
+static string MakePrefix(size_t x) {
+    string s;
+    do {
+        s += static_cast<char>('a' + x % 26);
+        x /= 26;
+    } while (x);
+    return s;
+}
+
+// Every line again with each word prefixed, until there are num_lemmas lines.
+static void GrowConjugations(const string& s, size_t num_lemmas,
+                             string* grown) {
+    vector<string> lines;
+    String::Split(s, '\n', &lines);
+    if (!lines.empty() && lines.back().empty()) {
+        lines.pop_back();
+    }
+
+    *grown = s;
+    size_t count = lines.size();
+    for (size_t i = 0; count < num_lemmas; ++i) {
+        string prefix = MakePrefix(i);
+        for (size_t j = 0; j < lines.size() && count < num_lemmas; ++j) {
+            *grown += prefix;
+            for (auto& c : lines[j]) {
+                *grown += c;
+                if (c == '\t' || c == '|') {
+                    *grown += prefix;
+                }
+            }
+            *grown += '\n';
+            ++count;
+        }
+    }
+}
+
+int main(int argc, char* argv[]) {
+    BenchOptions options;
+    if (!InitBenchOptions(argc, argv, 2, "<conjugations_f> <num_lemmas>",
+                          &options)) {
+        return 1;
+    }
+    size_t num_lemmas = strtoul(argv[2], NULL, 10);
+
+    string s;
+    if (!File::FileToString(argv[1], &s)) {
+        fprintf(stderr, "Could not read [%s].\n", argv[1]);
+        return 1;
+    }
+    string grown;
+    GrowConjugations(s, num_lemmas, &grown);
+    ConjugationSpecConfig config;
+    config.FromString(grown);
+
+    uint64_t begin = Time::MonotonicNanos();
+    Conjugator conj;
+    if (!conj.InitFromConfig(config)) {
+        return 1;
+    }
+    uint64_t init_nanos = Time::MonotonicNanos() - begin;
+
+    FullFormLexiconStats stats;
+    uint64_t build_micros;
+    conj.GetLexiconStats(&stats, &build_micros);
+    fprintf(stderr, "%zu lemmas, %zu forms, %zu entries.\n", stats.num_lemmas,
+            stats.num_forms, stats.num_entries);
+    fprintf(stderr, "lexicon: %.1f MB (%.0f bytes/lemma), built in %.1f ms "
+                    "of %.1f ms init.\n",
+            static_cast<double>(stats.num_bytes) / (1 << 20),
+            static_cast<double>(stats.num_bytes) /
+                static_cast<double>(stats.num_lemmas),
+            static_cast<double>(build_micros) / 1e3,
+            static_cast<double>(init_nanos) / 1e6);
+
+    // Known (lemma, field) pairs, uniformly over the lexicon, and their forms.
+    mt19937 rng(SEED);
+    vector<string> lemmas;
+    vector<unsigned> field_indexes;
+    vector<string> words;
+    for (size_t i = 0; i < NUM_INPUTS; ++i) {
+        lemmas.emplace_back(config.lemma(rng() % config.size()).ToString());
+        field_indexes.emplace_back(static_cast<unsigned>(rng() % 15));
+        string word;
+        conj.Conjugate(lemmas.back(), field_indexes.back(), &word);
+        words.emplace_back(word);
+    }
+
+    vector<BenchResult> results;
+    string conjugated;
+    IdentifyWordScratch scratch;
+    vector<LemmaViewAndIndex> lemmas_idxs;
+    for (bool use_lexicon : {true, false}) {
+        conj.SetUseLexicon(use_lexicon);
+        string suffix = use_lexicon ? ".lexicon" : ".derived";
+        string name = "conjugator.conjugate" + suffix;
+        Run(options, name.c_str(), lemmas.size(), [&](size_t i) {
+            conj.Conjugate(lemmas[i], field_indexes[i], &conjugated);
+        }, &results);
+
+        name = "conjugator.identify_word" + suffix;
+        Run(options, name.c_str(), words.size(), [&](size_t i) {
+            conj.IdentifyWordViews(words[i], true, &scratch, &lemmas_idxs);
+        }, &results);
+    }
+
+    WriteResults(results, stats.num_lemmas);
+    return 0;
+}
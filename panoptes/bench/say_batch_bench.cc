@@ -0,0 +1,103 @@
+// Throughput of VerbSayer::SayBatch() against calling Say() in a loop.
+//
+// Usage: say_batch_bench <conjugations_f> <modalities_f> <modal_past_tense_f>
+//                        [min_seconds] [filter]
+//
+// Each verb_sayer.say op says one verb into a new result, and each
+// verb_sayer.say_batch op says all of them into reused results.  Fails if the
+// two say any verb differently.
+
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "bench/bench.h"
+#include "cc/core/ling/verb/internal/conjugation/conjugator.h"
+#include "cc/core/ling/verb/internal/saying/verb_sayer.h"
+
+using std::mt19937;
+using std::string;
+using std::vector;
+
+#define NUM_VWCS 1000
+
+static size_t CountDiffs(const vector<VerbSayResult>& aa,
+                         const vector<VerbSayStatus>& a_statuses,
+                         const vector<VerbSayResult>& bb,
+                         const vector<VerbSayStatus>& b_statuses) {
+    size_t num_diffs = 0;
+    for (size_t i = 0; i < aa.size(); ++i) {
+        if (a_statuses[i] != b_statuses[i] ||
+                aa[i].pre_words != bb[i].pre_words ||
+                aa[i].main_words != bb[i].main_words) {
+            ++num_diffs;
+        }
+    }
+    return num_diffs;
+}
+
+int main(int argc, char* argv[]) {
+    BenchOptions options;
+    if (!InitBenchOptions(argc, argv, 3, "<conjugations_f> <modalities_f> "
+                          "<modal_past_tense_f>", &options)) {
+        return 1;
+    }
+
+    ConjugationSpecConfig config;
+    vector<string> lemmas;
+    if (!LoadConjugations(argv[1], &config, &lemmas)) {
+        return 1;
+    }
+
+    Conjugator conj;
+    if (!conj.InitFromConfig(config)) {
+        return 1;
+    }
+    VerbSayer sayer;
+    if (!sayer.Init(&conj, argv[2], argv[3])) {
+        return 1;
+    }
+
+    mt19937 rng(SEED);
+    vector<size_t> mix;
+    MakeLemmaMix(lemmas.size(), NUM_VWCS, &rng, &mix);
+    vector<VerbWithContext> vwcs;
+    MakeVerbs(sayer, lemmas, mix, false, &rng, &vwcs);
+
+    vector<BenchResult> results;
+    vector<VerbSayResult> single_rr(vwcs.size());
+    vector<VerbSayStatus> single_statuses(vwcs.size());
+    const BenchResult* single = Run(options, "verb_sayer.say", vwcs.size(),
+        [&](size_t i) {
+        VerbSayResult r;
+        single_statuses[i] = sayer.Say(vwcs[i], &r);
+        single_rr[i] = r;
+    }, &results);
+    // Read it now, as the next Run() may move it.
+    double single_ns = single ? single->ns_per_op() : 0.0;
+
+    vector<VerbSayResult> batch_rr;
+    vector<VerbSayStatus> batch_statuses;
+    const BenchResult* batch = Run(options, "verb_sayer.say_batch", 1,
+        [&](size_t) {
+        sayer.SayBatch(vwcs.data(), vwcs.size(), &batch_rr, &batch_statuses);
+    }, &results);
+
+    if (single_ns > 0 && batch) {
+        double batch_ns = batch->ns_per_op() / static_cast<double>(vwcs.size());
+        fprintf(stderr, "%zu verbs: single %.1f ns/verb, batch %.1f ns/verb "
+                        "(%.2fx)\n", vwcs.size(), single_ns, batch_ns,
+                single_ns / batch_ns);
+        size_t num_diffs = CountDiffs(single_rr, single_statuses, batch_rr,
+                                      batch_statuses);
+        if (num_diffs) {
+            fprintf(stderr, "MISMATCH: %zu verbs said differently.\n",
+                    num_diffs);
+            return 1;
+        }
+    }
+
+    WriteResults(results, lemmas.size());
+    return 0;
+}
@@ -0,0 +1,79 @@
+// Say() throughput with and without the Conjugator's derived spec cache, and
+// with the full-form lexicon (which the cache is then only a fallback to).
+//
+// Usage: say_cache_bench <conjugations_f> <modalities_f> <modal_past_tense_f>
+//                        [min_seconds] [filter]
+
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "bench/bench.h"
+#include "cc/core/ling/verb/internal/conjugation/conjugator.h"
+#include "cc/core/ling/verb/internal/saying/verb_sayer.h"
+
+using std::mt19937;
+using std::string;
+using std::vector;
+
+#define NUM_VWCS 1000
+#define CACHE_CAPACITY 4096
+
+int main(int argc, char* argv[]) {
+    BenchOptions options;
+    if (!InitBenchOptions(argc, argv, 3, "<conjugations_f> <modalities_f> "
+                          "<modal_past_tense_f>", &options)) {
+        return 1;
+    }
+
+    ConjugationSpecConfig config;
+    vector<string> lemmas;
+    if (!LoadConjugations(argv[1], &config, &lemmas)) {
+        return 1;
+    }
+
+    Conjugator conj;
+    if (!conj.InitFromConfig(config)) {
+        return 1;
+    }
+    VerbSayer sayer;
+    if (!sayer.Init(&conj, argv[2], argv[3])) {
+        return 1;
+    }
+
+    mt19937 rng(SEED);
+    vector<size_t> mix;
+    MakeLemmaMix(lemmas.size(), NUM_VWCS, &rng, &mix);
+    vector<VerbWithContext> vwcs;
+    MakeVerbs(sayer, lemmas, mix, false, &rng, &vwcs);
+
+    vector<BenchResult> results;
+    VerbSayResult r;
+    auto say = [&](size_t i) {
+        sayer.Say(vwcs[i], &r);
+    };
+
+    conj.SetUseLexicon(false);
+    conj.SetSpecCacheCapacity(0);
+    Run(options, "verb_sayer.say.uncached", vwcs.size(), say, &results);
+
+    conj.SetSpecCacheCapacity(CACHE_CAPACITY);
+    Run(options, "verb_sayer.say.cached", vwcs.size(), say, &results);
+
+    ConjugationSpecCacheStats stats;
+    conj.GetSpecCacheStats(&stats);
+
+    conj.SetUseLexicon(true);
+    Run(options, "verb_sayer.say.lexicon", vwcs.size(), say, &results);
+
+    fprintf(stderr, "cache: %llu hits, %llu misses, %llu evictions, "
+                    "%zu/%zu entries\n",
+            static_cast<unsigned long long>(stats.hits),
+            static_cast<unsigned long long>(stats.misses),
+            static_cast<unsigned long long>(stats.evictions), stats.size,
+            stats.capacity);
+
+    WriteResults(results, lemmas.size());
+    return 0;
+}
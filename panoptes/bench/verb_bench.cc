@@ -0,0 +1,332 @@
+// Benchmark suite for the verb engine (see bench.h for how it runs).
+//
+// Times each stage on fixed-seed inputs, with lemmas drawn from a Zipfian
+// distribution over the order they appear in the conjugations file (be, have,
+// do first).
+//
+// Usage: verb_bench <conjugations_f> <modalities_f> <modal_past_tense_f>
+//                   <verb_parses_f> [min_seconds] [filter]
+//
+// Fails if a warm Say() into a reused result makes any heap allocations (for
+// words short enough to be stored inline), or a warm ParseBatch() into a
+// reused arena does (for any words).  The verb_parser.* round trip of the
+// parser's tables needs verb_parses_f to be JSON (as generated), not a
+// snapshot.
+
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "bench/bench.h"
+#include "cc/base/combinatorics.h"
+#include "cc/base/file.h"
+#include "cc/core/ling/verb/internal/conjugation/conjugator.h"
+#include "cc/core/ling/verb/internal/parsing/lookup_table.h"
+#include "cc/core/ling/verb/internal/parsing/verb_parser.h"
+#include "cc/core/ling/verb/internal/saying/verb_sayer.h"
+#include "cc/core/ling/verb/verb_manager.h"
+#include "cc/core/ling/verb/verb_parse_arena.h"
+#include "cc/ds/generalizing_suffix_tree.h"
+
+using std::make_pair;
+using std::map;
+using std::mt19937;
+using std::string;
+using std::vector;
+
+#define NUM_INPUTS 4096
+
+// Verbs whose forms are all longer than std::string keeps inline (15 bytes in
+// libstdc++), conjugated by derivation.
+static const vector<string> LONG_LEMMAS = {
+    "institutionalize",
+    "compartmentalize",
+    "internationalize",
+    "intercommunicate",
+    "deinstitutionalize"
+};
+
+// -----------------------------------------------------------------------------
+// Inputs.
+
+// Each lemma's derivation (its ConjSpecDerivation hash, numbered), as the
+// Conjugator's suffix tree maps them.
+static void MakeLemma2Derivation(const ConjugationSpecConfig& config,
+                                 map<string, size_t>* lemma2derivx) {
+    map<Hash, size_t> hash2derivx;
+    ConjugationSpec spec;
+    for (size_t i = 0; i < config.size(); ++i) {
+        config.GetSpec(i, &spec);
+        ConjSpecDerivation deriv;
+        deriv.Init(spec);
+        auto it = hash2derivx.insert(
+            make_pair(deriv.HashCode(), hash2derivx.size())).first;
+        (*lemma2derivx)[config.lemma(i).ToString()] = it->second;
+    }
+}
+
+// -----------------------------------------------------------------------------
+// Checks.
+
+// Exit if a benchmark that must not allocate did.
+static void CheckNoAllocs(const BenchResult* r, const char* what) {
+    if (r && r->num_allocs) {
+        fprintf(stderr, "%s allocated.\n", what);
+        exit(1);
+    }
+}
+
+// -----------------------------------------------------------------------------
+
+int main(int argc, char* argv[]) {
+    BenchOptions options;
+    if (!InitBenchOptions(argc, argv, 4, "<conjugations_f> <modalities_f> "
+                          "<modal_past_tense_f> <verb_parses_f>", &options)) {
+        return 1;
+    }
+
+    ConjugationSpecConfig config;
+    vector<string> lemmas;
+    if (!LoadConjugations(argv[1], &config, &lemmas)) {
+        return 1;
+    }
+
+    VerbManager vm;
+    if (!vm.Init(argv[1], argv[3], argv[2], argv[4])) {
+        return 1;
+    }
+    const Conjugator& conj = vm.conjugator();
+    VerbSayer sayer;
+    if (!sayer.Init(&conj, argv[2], argv[3])) {
+        return 1;
+    }
+
+    mt19937 rng(SEED);
+    vector<size_t> mix;
+    MakeLemmaMix(lemmas.size(), NUM_INPUTS, &rng, &mix);
+
+    vector<BenchResult> results;
+
+    // Conjugation, and back.
+    vector<unsigned> field_indexes;
+    vector<string> words;
+    for (auto& lemma_index : mix) {
+        unsigned field_index = static_cast<unsigned>(rng() % 15);
+        string word;
+        conj.Conjugate(lemmas[lemma_index], field_index, &word);
+        field_indexes.emplace_back(field_index);
+        words.emplace_back(word);
+    }
+
+    string conjugated;
+    Run(options, "conjugator.conjugate", mix.size(), [&](size_t i) {
+        conj.Conjugate(lemmas[mix[i]], field_indexes[i], &conjugated);
+    }, &results);
+
+    IdentifyWordScratch scratch;
+    vector<LemmaViewAndIndex> lemmas_idxs;
+    Run(options, "conjugator.identify_word", words.size(), [&](size_t i) {
+        conj.IdentifyWordViews(words[i], true, &scratch, &lemmas_idxs);
+    }, &results);
+
+    // The same without the full-form lexicon, deriving every form.
+    Conjugator derived;
+    if (!derived.InitFromConfig(config)) {
+        return 1;
+    }
+    derived.SetUseLexicon(false);
+    Run(options, "conjugator.conjugate.derived", mix.size(), [&](size_t i) {
+        derived.Conjugate(lemmas[mix[i]], field_indexes[i], &conjugated);
+    }, &results);
+
+    Run(options, "conjugator.identify_word.derived", words.size(),
+        [&](size_t i) {
+        derived.IdentifyWordViews(words[i], true, &scratch, &lemmas_idxs);
+    }, &results);
+
+    map<string, size_t> lemma2derivx;
+    MakeLemma2Derivation(config, &lemma2derivx);
+    GeneralizingSuffixTree<size_t> tree;
+    tree.InitFromDict(lemma2derivx);
+    size_t derivx;
+    Run(options, "suffix_tree.get", mix.size(), [&](size_t i) {
+        tree.Get(lemmas[mix[i]], &derivx);
+    }, &results);
+
+    // Saying.
+    vector<VerbWithContext> vwcs;
+    MakeVerbs(sayer, lemmas, mix, true, &rng, &vwcs);
+    vector<VerbSayResult> rr;
+    Run(options, "verb_sayer.get_all_say_options", vwcs.size(),
+        [&](size_t i) {
+        rr.clear();
+        vm.GetAllSayOptions(vwcs[i], ~0ul, &rr);
+    }, &results);
+
+    // Warm Say() must not allocate, pro-verbs included.  This only holds while
+    // every word fits in std::string's inline buffer (15 bytes in libstdc++),
+    // which for a pro-verb means "<" + form + "-pv>", so forms of up to 10
+    // bytes.  Rendering resizes the result's word vectors, which frees the
+    // buffers of the words dropped, so longer words are reallocated whenever
+    // the number of words grows back.  verb_sayer.say.long_words measures
+    // that case.
+    VerbSayResult said;
+    const BenchResult* say = Run(options, "verb_sayer.say", vwcs.size(),
+        [&](size_t i) {
+        vm.Say(vwcs[i], &said);
+    }, &results);
+    CheckNoAllocs(say, "Warm Say()");
+
+    // The same with words too long to be stored inline in a string, which is
+    // not held to zero allocations (see above).
+    vector<size_t> long_mix;
+    for (size_t i = 0; i < NUM_INPUTS; ++i) {
+        long_mix.emplace_back(i % LONG_LEMMAS.size());
+    }
+    vector<VerbWithContext> long_vwcs;
+    MakeVerbs(sayer, LONG_LEMMAS, long_mix, true, &rng, &long_vwcs);
+    Run(options, "verb_sayer.say.long_words", long_vwcs.size(),
+        [&](size_t i) {
+        vm.Say(long_vwcs[i], &said);
+    }, &results);
+
+    // Parsing what was said.
+    vector<VerbSayResult> vsrs(vwcs.size());
+    for (size_t i = 0; i < vwcs.size(); ++i) {
+        vm.Say(vwcs[i], &vsrs[i]);
+    }
+    vector<VerbWithContext> parses;
+    Run(options, "verb_parser.parse", vsrs.size(), [&](size_t i) {
+        vm.Parse(vsrs[i], &parses);
+    }, &results);
+
+    // The same through ParseBatch() into a reused arena, one input a batch so
+    // that it compares with Parse() (which uses a new arena every time).
+    // Once warm, it must not allocate, even for lemmas too long to be stored
+    // inline in a string.
+    VerbParseArena arena;
+    const BenchResult* parse_batch = Run(options, "verb_parser.parse_batch",
+                                         vsrs.size(), [&](size_t i) {
+        vm.ParseBatch(&vsrs[i], 1, &arena);
+    }, &results);
+    CheckNoAllocs(parse_batch, "Warm ParseBatch()");
+
+    vector<VerbSayResult> long_vsrs(long_vwcs.size());
+    for (size_t i = 0; i < long_vwcs.size(); ++i) {
+        vm.Say(long_vwcs[i], &long_vsrs[i]);
+    }
+    parse_batch = Run(options, "verb_parser.parse_batch.long_words",
+                      long_vsrs.size(), [&](size_t i) {
+        vm.ParseBatch(&long_vsrs[i], 1, &arena);
+    }, &results);
+    CheckNoAllocs(parse_batch, "Warm ParseBatch() of long words");
+
+    // Parser table generation, on the pro-verb table (single-threaded, so
+    // it measures the work rather than the machine).
+    LookupTableConfig cfg;
+    cfg.Init(VerbParser::NumOptionsPerField(), {"see"}, {true});
+    LookupTable table;
+    Run(options, "lookup_table.generate", 1, [&](size_t) {
+        table.Generate(cfg, &sayer, 1);
+    }, &results);
+
+    // Collapsing the tuples behind each of its keys (including copying them,
+    // as collapsing is destructive).
+    map<string, vector<vector<uint8_t> > > key2tuples;
+    LookupTable::SayAll(cfg, &sayer, 1, &key2tuples);
+    vector<const vector<vector<uint8_t> >*> key_tuples;
+    for (auto& it : key2tuples) {
+        key_tuples.emplace_back(&it.second);
+    }
+    Run(options, "combinatorics.collapse", key_tuples.size(), [&](size_t i) {
+        vector<vector<uint8_t> > tuples = *key_tuples[i];
+        Combinatorics::CollapseToWildcards(VerbParser::NumOptionsPerField(),
+                                           &tuples);
+    }, &results);
+
+    // Round-tripping one lookup table as JSON.  The JSON is made up front as
+    // well, so that from_json can run alone.
+    string table_json;
+    table.ToJSON(&table_json);
+    Run(options, "lookup_table.to_json", 1, [&](size_t) {
+        table.ToJSON(&table_json);
+    }, &results);
+
+    LookupTable loaded;
+    Run(options, "lookup_table.from_json", 1, [&](size_t) {
+        if (!loaded.FromJSON(table_json)) {
+            fprintf(stderr, "JSON round trip failed.\n");
+            exit(1);
+        }
+    }, &results);
+
+    // The parser's whole state, the way VerbParser::Init() loads it from
+    // verb_parses_f: all three tables from JSON, then the snapshot of them
+    // and the deverbed key set, then mapping that.
+    if (VerbParserSnapshot::IsSnapshotFile(argv[4])) {
+        fprintf(stderr, "Skipping verb_parser.* round trip: [%s] is a "
+                        "snapshot, not JSON.\n", argv[4]);
+    } else {
+        string tables_json;
+        if (!File::FileToString(argv[4], &tables_json)) {
+            fprintf(stderr, "Could not read [%s].\n", argv[4]);
+            return 1;
+        }
+
+        // Each step's input is made up front, so that any step can run
+        // alone.
+        VerbParser::Tables tables;
+        string bytes;
+        if (!tables.FromJSON(tables_json) ||
+                !VerbParser::BuildSnapshot(tables, &bytes)) {
+            fprintf(stderr, "Loading the tables failed.\n");
+            return 1;
+        }
+
+        VerbParser::Tables parsed;
+        Run(options, "verb_parser.from_json", 1, [&](size_t) {
+            if (!parsed.FromJSON(tables_json)) {
+                fprintf(stderr, "Parsing the tables failed.\n");
+                exit(1);
+            }
+        }, &results);
+
+        string tables_json_out;
+        tables.ToJSON(&tables_json_out);
+        Run(options, "verb_parser.to_json", 1, [&](size_t) {
+            tables.ToJSON(&tables_json_out);
+        }, &results);
+
+        string rebuilt;
+        Run(options, "verb_parser.build_snapshot", 1, [&](size_t) {
+            if (!VerbParser::BuildSnapshot(tables, &rebuilt)) {
+                fprintf(stderr, "Snapshotting the tables failed.\n");
+                exit(1);
+            }
+        }, &results);
+
+        VerbParserSnapshot snapshot;
+        Run(options, "verb_parser.load_snapshot", 1, [&](size_t) {
+            if (!snapshot.InitFromBytes(bytes)) {
+                fprintf(stderr, "Loading the snapshot failed.\n");
+                exit(1);
+            }
+        }, &results);
+
+        VerbParser::Tables reloaded;
+        if (!reloaded.FromJSON(tables_json_out) ||
+                reloaded.to_be.key2vwcs() != tables.to_be.key2vwcs() ||
+                reloaded.pro_verbs.key2vwcs() !=
+                    tables.pro_verbs.key2vwcs() ||
+                reloaded.fir.key2vwcs() != tables.fir.key2vwcs()) {
+            fprintf(stderr, "Tables JSON round trip failed.\n");
+            return 1;
+        }
+    }
+
+    WriteResults(results, lemmas.size());
+    return 0;
+}
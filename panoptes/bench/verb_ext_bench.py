@@ -0,0 +1,192 @@
+"""
+Per-call Python overhead of the verb_ext extension.
+
+Times each single-item function called in a loop against its *_many batch
+variant over the same inputs, checks they agree, and reports ns per item for
+both.  The difference is the per-call overhead that batching saves.
+
+Usage: python verb_ext_bench.py <conjugations_f> <modal_past_tense_f> \\
+           <modalities_f> <verb_parses_f> [num_items]
+
+Expects the extension built by `make all` (in panoptes/build/).
+"""
+
+import os
+import random
+import sys
+import time
+
+sys.path.insert(0, os.path.join(os.path.dirname(os.path.abspath(__file__)),
+                                '..', 'build'))
+import verb_ext
+
+
+SEED = 1337
+NUM_RUNS = 3
+NUM_VERB_FIELDS = 15
+
+# Field options of random VerbWithContexts (see the EnumStrings in cc/).
+BOOLS = [False, True]
+THROOLS = ['FALSE', 'TRUE']
+TENSES = ['PAST', 'PRESENT', 'FUTURE']
+MODAL_FLAVORS = [
+    'INDICATIVE', 'SUBJUNCTIVE_CF', 'DEDUCTIVE', 'ALMOST_CERTAIN', 'PROBABLE',
+    'POSSIBLE', 'IMPERATIVE', 'SUBJUNCTIVE_IMP', 'ABILITY', 'PERMISSIVE',
+    'NORMATIVE', 'NECESSITY']
+VERB_FORMS = ['FINITE', 'BARE_INF', 'TO_INF', 'GERUND', 'SUBJLESS_GERUND']
+VOICES = ['ACTIVE', 'PASSIVE']
+CONJS = ['S1', 'S2', 'S3', 'P1', 'P2', 'P3']
+RELATIVE_CONTS = ['ZERO', 'WORD', 'NO']
+SBJ_HANDLINGS = ['WERE_SBJ', 'WAS_SBJ']
+
+
+def load_lemmas(conjugations_f):
+    """
+    conjugations file -> lemmas in file order (be, have, do first).
+    """
+    lemmas = []
+    for line in open(conjugations_f):
+        line = line.strip()
+        if line and not line.startswith('#'):
+            lemmas.append(line.split()[0])
+    return lemmas
+
+
+def zipfian(rng, items, num):
+    """
+    Pick num items with weight 1 / rank.
+    """
+    cumulative = []
+    total = 0.0
+    for i in xrange(len(items)):
+        total += 1.0 / (i + 1)
+        cumulative.append(total)
+    rr = []
+    for _ in xrange(num):
+        x = rng.random() * total
+        lo = 0
+        hi = len(cumulative) - 1
+        while lo < hi:
+            mid = (lo + hi) / 2
+            if cumulative[mid] < x:
+                lo = mid + 1
+            else:
+                hi = mid
+        rr.append(items[lo])
+    return rr
+
+
+def random_vwc(rng, lemma):
+    """
+    -> VerbWithContext dict, as laid out by VerbWithContext::ToJSON().
+    """
+    return {
+        'verb': {
+            'lemma': lemma,
+            'polarity': {
+                'tf': rng.choice(BOOLS),
+                'is_contrary': rng.choice(THROOLS),
+            },
+            'tense': rng.choice(TENSES),
+            'aspect': {
+                'is_perf': rng.choice(BOOLS),
+                'is_prog': rng.choice(BOOLS),
+            },
+            'modality': {
+                'flavor': rng.choice(MODAL_FLAVORS),
+                'is_cond': rng.choice(BOOLS),
+            },
+            'verb_form': rng.choice(VERB_FORMS),
+            'is_pro_verb': False,
+        },
+        'voice': rng.choice(VOICES),
+        'conj': rng.choice(CONJS),
+        'is_split': rng.choice(BOOLS),
+        'relative_cont': rng.choice(RELATIVE_CONTS),
+        'contract_not': rng.choice(THROOLS),
+        'split_inf': rng.choice(THROOLS),
+        'sbj_handling': rng.choice(SBJ_HANDLINGS),
+    }
+
+
+def best_ns_per_item(f, num_items):
+    """
+    Fastest of NUM_RUNS runs of f, in ns per item.
+    """
+    best = None
+    for _ in xrange(NUM_RUNS):
+        t = time.time()
+        f()
+        t = time.time() - t
+        if best is None or t < best:
+            best = t
+    return best * 1e9 / max(num_items, 1)
+
+
+def conjugate_each(items):
+    conjugate = verb_ext.conjugate
+    return [conjugate(lemma, index) for lemma, index in items]
+
+
+def lemmatize_each(items):
+    lemmatize = verb_ext.lemmatize
+    return [lemmatize(word) for word in items]
+
+
+def say_each(items):
+    say = verb_ext.say
+    return [say(vwc) for vwc in items]
+
+
+def parse_each(items):
+    parse = verb_ext.parse
+    return [parse(pre_words, main_words) for pre_words, main_words in items]
+
+
+def bench(name, each, many, items):
+    """
+    Time and compare one function's single and batch forms.
+    """
+    assert each(items) == many(items), name
+    single_ns = best_ns_per_item(lambda: each(items), len(items))
+    batch_ns = best_ns_per_item(lambda: many(items), len(items))
+    print '%-10s %7d items  single %9.0f ns  batch %9.0f ns  ' \
+          'overhead %8.0f ns/call (%.2fx)' % (
+              name, len(items), single_ns, batch_ns, single_ns - batch_ns,
+              single_ns / batch_ns)
+
+
+def main():
+    if len(sys.argv) not in (5, 6):
+        print __doc__
+        sys.exit(1)
+    conjugations_f, modal_past_tense_f, modalities_f, verb_parses_f = \
+        sys.argv[1:5]
+    num_items = int(sys.argv[5]) if len(sys.argv) == 6 else 10000
+
+    assert verb_ext.init(conjugations_f, modal_past_tense_f, modalities_f,
+                         verb_parses_f)
+
+    rng = random.Random(SEED)
+    lemmas = zipfian(rng, load_lemmas(conjugations_f), num_items)
+    conjugate_items = [(lemma, rng.randrange(NUM_VERB_FIELDS))
+                       for lemma in lemmas]
+    words = verb_ext.conjugate_many(conjugate_items)
+
+    # Random sayable verbs, and what they say to parse back.
+    vwcs = []
+    while len(vwcs) < num_items:
+        vwc = random_vwc(rng, lemmas[len(vwcs)])
+        if verb_ext.is_valid(vwc):
+            vwcs.append(vwc)
+    parse_items = verb_ext.say_many(vwcs)
+
+    bench('conjugate', conjugate_each, verb_ext.conjugate_many,
+          conjugate_items)
+    bench('lemmatize', lemmatize_each, verb_ext.lemmatize_many, words)
+    bench('say', say_each, verb_ext.say_many, vwcs)
+    bench('parse', parse_each, verb_ext.parse_many, parse_items)
+
+
+if __name__ == '__main__':
+    main()
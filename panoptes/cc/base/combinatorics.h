@@ -22,10 +22,27 @@ template <typename T>
 bool NextChooseOneFromEach(
     const vector<T>& num_options_per_field, vector<T>* values);
 
+// How many different values NextChooseOneFromEach() will step through.
+template <typename T>
+uint64_t CountChooseOneFromEach(const vector<T>& num_options_per_field);
+
+// Jump to the n-th (zero-based) values NextChooseOneFromEach() would return, so
+// that the space can be split into ranges and walked independently.
+template <typename T>
+void NthChooseOneFromEach(
+    const vector<T>& num_options_per_field, uint64_t n, vector<T>* values);
+
+// Shrink the tuples by replacing runs of every value of a field with a wildcard
+// (num_options), greedily by whichever field shrinks them the most.
 template <typename T>
 void CollapseToWildcards(
     const vector<T>& num_options_per_field, vector<vector<T> >* tuples);
 
+// The straightforward version, used for tuples too wide to pack.
+template <typename T>
+void SimpleCollapseToWildcards(
+    const vector<T>& num_options_per_field, vector<vector<T> >* tuples);
+
 }  // namespace Combinatorics
 
 #include "combinatorics_impl.h"
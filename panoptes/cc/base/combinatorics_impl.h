@@ -3,12 +3,18 @@
 
 #include "combinatorics.h"
 
+#include <algorithm>
 #include <cassert>
 #include <cstddef>
 #include <map>
 #include <string>
+#include <utility>
+
+#include "cc/ds/packed_key_map.h"
 
 using std::map;
+using std::pair;
+using std::sort;
 using std::string;
 
 namespace Combinatorics {
@@ -80,6 +86,32 @@ bool NextChooseOneFromEach(
     return true;
 }
 
+template <typename T>
+uint64_t CountChooseOneFromEach(const vector<T>& num_options_per_field) {
+    if (!num_options_per_field.size()) {
+        return 0;
+    }
+
+    uint64_t count = 1;
+    for (size_t i = 0; i < num_options_per_field.size(); ++i) {
+        count *= static_cast<uint64_t>(num_options_per_field[i]);
+    }
+    return count;
+}
+
+template <typename T>
+void NthChooseOneFromEach(
+        const vector<T>& num_options_per_field, uint64_t n, vector<T>* values) {
+    assert(n < CountChooseOneFromEach(num_options_per_field));
+
+    // Field 0 is the least significant digit.
+    values->resize(num_options_per_field.size());
+    for (size_t i = 0; i < num_options_per_field.size(); ++i) {
+        (*values)[i] = static_cast<T>(n % num_options_per_field[i]);
+        n /= num_options_per_field[i];
+    }
+}
+
 template <typename T>
 static void StringFromPointerAndSize(const T* t, size_t size, string* r) {
     const char* s = reinterpret_cast<const char*>(t);
@@ -109,7 +141,7 @@ void TupleFromKey(const string& key, vector<T>* v) {
 // 1 -> A*D B1D B1E  <- chosen
 // 2 -> A1D A2D A3D B1D B1E
 template <typename T>
-void CollapseToWildcards(
+void SimpleCollapseToWildcards(
         const vector<T>& num_options_per_field, vector<vector<T> >* tuples) {
     // Keep shrinking tuples until we can't anymore.
     while (true) {
@@ -226,6 +258,293 @@ void CollapseToWildcards(
     }
 }
 
+// CollapseToWildcards() on tuples packed into integers, keeping each field's
+// candidate collapse up to date as tuples come and go instead of recomputing
+// every candidate each iteration.
+//
+// Packing puts field 0 in the most significant bits, with room in each field
+// for the wildcard.  For each field (past the first, which is never collapsed
+// on), tuples are grouped by everything but that field, with a bitmask of which
+// values each group has.  A group becomes one tuple if it has them all, else
+// one tuple per value, which gives the size of the collapse on that field.
+// Tuples already wildcarded on a field are left out of its groups (and so
+// dropped if that field is chosen), as in SimpleCollapseToWildcards().
+template <typename T>
+class WildcardCollapser {
+  public:
+    // Returns false if the tuples can't be packed into 63 bits.
+    bool Init(const vector<T>& num_options_per_field);
+
+    void Collapse(vector<vector<T> >* tuples);
+
+  private:
+    uint64_t Pack(const vector<T>& v) const;
+    void Unpack(uint64_t tuple, vector<T>* v) const;
+
+    uint64_t GetField(uint64_t tuple, size_t f) const {
+        return (tuple >> field2shift_[f]) & field2max_[f];
+    }
+    uint64_t SetField(uint64_t tuple, size_t f, uint64_t value) const {
+        return (tuple & ~(field2max_[f] << field2shift_[f])) |
+               (value << field2shift_[f]);
+    }
+
+    // How many tuples a group with the values in the bitmask becomes.
+    size_t GroupSize(size_t f, uint64_t is_presents) const;
+
+    void AddTuple(uint64_t tuple);
+    void RemoveTuple(uint64_t tuple);
+
+    // Replace the tuples with their collapse on the field.
+    void CollapseOnField(size_t f);
+
+    // The tuple, reordered to sort the way the collapse on the field is
+    // ordered: by the other fields in order, then by the field.
+    uint64_t SortKey(uint64_t tuple, size_t f) const;
+
+    vector<T> num_options_per_field_;
+    vector<uint64_t> field2shift_;
+    vector<uint64_t> field2bits_;
+    vector<uint64_t> field2max_;
+    vector<uint64_t> field2all_present_;
+
+    PackedKeyMap<uint8_t> tuples_;
+
+    // Field -> tuple with that field zeroed -> bitmask of values present.
+    vector<PackedKeyMap<uint64_t> > field2groups_;
+
+    // Field -> how many tuples collapsing on it would leave.
+    vector<size_t> field2collapsed_size_;
+
+    // Field -> how many tuples are already wildcarded on it.
+    vector<size_t> field2num_wildcards_;
+};
+
+template <typename T>
+bool WildcardCollapser<T>::Init(const vector<T>& num_options_per_field) {
+    // Keys are compared bytewise.
+    if (sizeof(T) != 1) {
+        return false;
+    }
+
+    num_options_per_field_ = num_options_per_field;
+    size_t num_fields = num_options_per_field.size();
+    field2shift_.resize(num_fields);
+    field2bits_.resize(num_fields);
+    field2max_.resize(num_fields);
+    field2all_present_.resize(num_fields);
+    uint64_t total_bits = 0;
+    for (size_t f = num_fields; f--; ) {
+        uint64_t num_options = static_cast<uint64_t>(num_options_per_field[f]);
+        if (!num_options || 64 < num_options) {
+            return false;
+        }
+
+        // Values go up to num_options (the wildcard).
+        uint64_t bits = 0;
+        while (num_options >> bits) {
+            ++bits;
+        }
+        field2shift_[f] = total_bits;
+        field2bits_[f] = bits;
+        field2max_[f] = (1ull << bits) - 1;
+        field2all_present_[f] = num_options == 64 ? ~0ull :
+            (1ull << num_options) - 1;
+        total_bits += bits;
+        if (63 < total_bits) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+template <typename T>
+uint64_t WildcardCollapser<T>::Pack(const vector<T>& v) const {
+    uint64_t tuple = 0;
+    for (size_t f = 0; f < v.size(); ++f) {
+        tuple |= static_cast<uint64_t>(v[f]) << field2shift_[f];
+    }
+    return tuple;
+}
+
+template <typename T>
+void WildcardCollapser<T>::Unpack(uint64_t tuple, vector<T>* v) const {
+    v->resize(num_options_per_field_.size());
+    for (size_t f = 0; f < v->size(); ++f) {
+        (*v)[f] = static_cast<T>(GetField(tuple, f));
+    }
+}
+
+template <typename T>
+size_t WildcardCollapser<T>::GroupSize(size_t f, uint64_t is_presents) const {
+    if (is_presents == field2all_present_[f]) {
+        return 1;
+    }
+    return static_cast<size_t>(__builtin_popcountll(is_presents));
+}
+
+template <typename T>
+void WildcardCollapser<T>::AddTuple(uint64_t tuple) {
+    if (tuples_.Find(tuple)) {
+        return;
+    }
+    *tuples_.Get(tuple) = 1;
+
+    for (size_t f = 1; f < num_options_per_field_.size(); ++f) {
+        uint64_t value = GetField(tuple, f);
+        if (value == num_options_per_field_[f]) {
+            ++field2num_wildcards_[f];
+            continue;
+        }
+
+        uint64_t* is_presents = field2groups_[f].Get(SetField(tuple, f, 0));
+        field2collapsed_size_[f] -= GroupSize(f, *is_presents);
+        *is_presents |= 1ull << value;
+        field2collapsed_size_[f] += GroupSize(f, *is_presents);
+    }
+}
+
+template <typename T>
+void WildcardCollapser<T>::RemoveTuple(uint64_t tuple) {
+    bool was_present = tuples_.Erase(tuple);
+    assert(was_present);
+    (void)was_present;
+
+    for (size_t f = 1; f < num_options_per_field_.size(); ++f) {
+        uint64_t value = GetField(tuple, f);
+        if (value == num_options_per_field_[f]) {
+            --field2num_wildcards_[f];
+            continue;
+        }
+
+        uint64_t group = SetField(tuple, f, 0);
+        uint64_t* is_presents = field2groups_[f].Get(group);
+        field2collapsed_size_[f] -= GroupSize(f, *is_presents);
+        *is_presents &= ~(1ull << value);
+        if (*is_presents) {
+            field2collapsed_size_[f] += GroupSize(f, *is_presents);
+        } else {
+            field2groups_[f].Erase(group);
+        }
+    }
+}
+
+template <typename T>
+void WildcardCollapser<T>::CollapseOnField(size_t f) {
+    // Tuples already wildcarded on this field are dropped.
+    vector<uint64_t> removes;
+    vector<uint64_t> adds;
+    if (field2num_wildcards_[f]) {
+        uint64_t wildcard = num_options_per_field_[f];
+        tuples_.ForEach([&](uint64_t tuple, uint8_t) {
+            if (GetField(tuple, f) == wildcard) {
+                removes.emplace_back(tuple);
+            }
+        });
+    }
+
+    // Groups with every value become one wildcarded tuple.  The rest stay.
+    field2groups_[f].ForEach([&](uint64_t group, uint64_t is_presents) {
+        if (is_presents != field2all_present_[f]) {
+            return;
+        }
+        for (uint64_t i = 0; i < num_options_per_field_[f]; ++i) {
+            removes.emplace_back(SetField(group, f, i));
+        }
+        adds.emplace_back(SetField(group, f, num_options_per_field_[f]));
+    });
+
+    // Remove first, as a dropped tuple may come right back.
+    for (auto& tuple : removes) {
+        RemoveTuple(tuple);
+    }
+    for (auto& tuple : adds) {
+        AddTuple(tuple);
+    }
+}
+
+template <typename T>
+uint64_t WildcardCollapser<T>::SortKey(uint64_t tuple, size_t f) const {
+    uint64_t shift = field2shift_[f];
+    uint64_t bits = field2bits_[f];
+    uint64_t above = (tuple >> (shift + bits)) << shift;
+    uint64_t below = tuple & ((1ull << shift) - 1);
+    return ((above | below) << bits) | GetField(tuple, f);
+}
+
+template <typename T>
+void WildcardCollapser<T>::Collapse(vector<vector<T> >* tuples) {
+    size_t num_fields = num_options_per_field_.size();
+    tuples_.Clear();
+    tuples_.Reserve(tuples->size());
+    field2groups_.clear();
+    field2groups_.resize(num_fields);
+    field2collapsed_size_.assign(num_fields, 0);
+    field2num_wildcards_.assign(num_fields, 0);
+    for (auto& v : *tuples) {
+        AddTuple(Pack(v));
+    }
+
+    // Keep shrinking tuples until we can't anymore.  The first time around,
+    // duplicates count.
+    size_t num_tuples = tuples->size();
+    size_t last_field = ~0ul;
+    while (true) {
+        // Find which field to collapse on shrinks our tuples the most.
+        size_t min_size = ~0ul;
+        size_t min_field = ~0ul;
+        for (size_t f = 1; f < num_fields; ++f) {
+            size_t size = field2collapsed_size_[f];
+            if (size && size < min_size) {
+                min_size = size;
+                min_field = f;
+            }
+        }
+        assert(min_size != ~0ul);
+
+        // If nobody could shrink the tuples, we're done.
+        if (min_size == num_tuples) {
+            break;
+        }
+
+        CollapseOnField(min_field);
+        assert(tuples_.size() == min_size);
+        num_tuples = min_size;
+        last_field = min_field;
+    }
+
+    // If we never collapsed, the tuples are as given.
+    if (last_field == ~0ul) {
+        return;
+    }
+
+    // Else, they are in the order of the last collapse.
+    vector<pair<uint64_t, uint64_t> > sort_key_tuples;
+    sort_key_tuples.reserve(tuples_.size());
+    tuples_.ForEach([&](uint64_t tuple, uint8_t) {
+        sort_key_tuples.emplace_back(SortKey(tuple, last_field), tuple);
+    });
+    sort(sort_key_tuples.begin(), sort_key_tuples.end());
+
+    tuples->resize(sort_key_tuples.size());
+    for (size_t i = 0; i < sort_key_tuples.size(); ++i) {
+        Unpack(sort_key_tuples[i].second, &(*tuples)[i]);
+    }
+}
+
+template <typename T>
+void CollapseToWildcards(
+        const vector<T>& num_options_per_field, vector<vector<T> >* tuples) {
+    WildcardCollapser<T> collapser;
+    if (!collapser.Init(num_options_per_field)) {
+        SimpleCollapseToWildcards(num_options_per_field, tuples);
+        return;
+    }
+
+    collapser.Collapse(tuples);
+}
+
 }  // namespace
 
 #endif  // CC_BASE_COMBINATORICS_IMPL_H_
@@ -1,13 +1,46 @@
 #include "cc/base/logging.h"
 
-#include <cstdio>
+#include <cinttypes>
 #include <cstdarg>
+#include <cstdlib>
+#include <cstring>
+#include <chrono>
+#include <ctime>
+#include <memory>
+#include <mutex>
+#include <thread>
 
-#include "cc/base/time.h"
+using std::chrono::duration_cast;
+using std::chrono::microseconds;
+using std::chrono::nanoseconds;
+using std::chrono::seconds;
+using std::chrono::steady_clock;
+using std::chrono::system_clock;
+using std::lock_guard;
+using std::memory_order_acquire;
+using std::memory_order_relaxed;
+using std::memory_order_release;
+using std::mutex;
+using std::thread;
+using std::unique_ptr;
 
 EnumStrings<LogLevel> LogLevelStrings = EnumStrings<LogLevel>(
     "FATAL ERROR WARN INFO DEBUG");
 
+// Records in the ring buffer (a power of two).
+#define LOG_RING_SIZE 2048
+
+// Bytes of message text per record (longer messages are truncated).
+#define LOG_MESSAGE_SIZE 480
+
+// Bytes of formatted output the background thread buffers before writing.
+#define LOG_WRITE_BUFFER_SIZE (64 * 1024)
+
+// How long the background thread sleeps when it has nothing to do, after
+// yielding this many times.
+#define LOG_IDLE_YIELDS 64
+#define LOG_IDLE_SLEEP_MICROS 500
+
 namespace {
 
 const char* CONSOLE_COLOR_PREFIXES[] = {
@@ -20,72 +53,376 @@ const char* CONSOLE_COLOR_PREFIXES[] = {
 
 const char* CONSOLE_COLOR_SUFFIX = "\x1B[0m";
 
-FILE* LOG_F = NULL;
+atomic<FILE*> LOG_F(NULL);
+
+atomic<bool> LOG_ASYNC(false);
+
+uint64_t NanosSinceEpoch() {
+    return static_cast<uint64_t>(duration_cast<nanoseconds>(
+        system_clock::now().time_since_epoch()).count());
+}
+
+// -----------------------------------------------------------------------------
+// Formatting.
+
+// The "] [INFO] " part of each level's prefix.
+const string* GetLevelTags() {
+    static const string* tags = [] {
+        string* r = new string[LOG_DEBUG + 1];
+        for (int i = LOG_FATAL; i <= LOG_DEBUG; ++i) {
+            LogLevel level = static_cast<LogLevel>(i);
+            const char* color_prefix = LOGGING_USE_CONSOLE_COLORS ?
+                CONSOLE_COLOR_PREFIXES[level] : "";
+            const char* color_suffix = LOGGING_USE_CONSOLE_COLORS ?
+                CONSOLE_COLOR_SUFFIX : "";
+            r[level] = string("] [") + color_prefix +
+                LogLevelStrings.GetString(level) + color_suffix + "] ";
+        }
+        return r;
+    }();
+    return tags;
+}
+
+// Writes the "[2016-01-02 03:04:05.678] [INFO] " prefix of each message,
+// calling localtime only when the second changes.
+class PrefixFormatter {
+  public:
+    PrefixFormatter() : second_(-1), level_tags_(GetLevelTags()) {}
+
+    void Append(LogLevel level, uint64_t nanos, string* out) {
+        time_t second = static_cast<time_t>(nanos / 1000000000);
+        if (second != second_) {
+            tm t;
+            localtime_r(&second, &t);
+            snprintf(second_s_, sizeof(second_s_),
+                     "[%04d-%02d-%02d %02d:%02d:%02d.", t.tm_year + 1900,
+                     t.tm_mon + 1, t.tm_mday, t.tm_hour, t.tm_min, t.tm_sec);
+            second_ = second;
+        }
+
+        unsigned millis = static_cast<unsigned>(nanos / 1000000 % 1000);
+        char millis_s[3] = {
+            static_cast<char>('0' + millis / 100),
+            static_cast<char>('0' + millis / 10 % 10),
+            static_cast<char>('0' + millis % 10),
+        };
+        out->append(second_s_);
+        out->append(millis_s, sizeof(millis_s));
+        out->append(level_tags_[level]);
+    }
+
+  private:
+    time_t second_;
+    char second_s_[80];
+    const string* level_tags_;
+};
+
+// Append one formatted message.
+void AppendMessage(PrefixFormatter* prefix, LogLevel level, uint64_t nanos,
+                   const char* text, size_t size, bool truncated,
+                   string* out) {
+    prefix->Append(level, nanos, out);
+    out->append(text, size);
+    if (truncated) {
+        out->append("... [truncated]\n");
+    }
+}
+
+// Format a message body into buf.  Returns its size, and whether it was cut
+// short.
+__attribute__((format(printf, 3, 0)))
+size_t FormatText(char* buf, size_t buf_size, const char* fmt, va_list args,
+                  bool* truncated) {
+    int n = vsnprintf(buf, buf_size, fmt, args);
+    if (n < 0) {
+        *truncated = false;
+        return 0;
+    }
+    *truncated = buf_size <= static_cast<size_t>(n);
+    return *truncated ? buf_size - 1 : static_cast<size_t>(n);
+}
+
+// -----------------------------------------------------------------------------
+// Background writer.
+
+// A bounded multi-producer ring of records with a single consumer (the
+// background thread).  Each record's sequence number says whose turn it is: a
+// producer claims position pos when its record's sequence is pos, and publishes
+// it by setting it to pos + 1; the consumer frees it for the next lap by
+// setting it to pos + LOG_RING_SIZE.
+class AsyncWriter {
+  public:
+    AsyncWriter() : records_(new Record[LOG_RING_SIZE]), enqueue_pos_(0),
+                    flushed_pos_(0), num_dropped_(0), stop_(false) {
+        for (uint64_t i = 0; i < LOG_RING_SIZE; ++i) {
+            records_[i].seq.store(i, memory_order_relaxed);
+        }
+    }
+
+    void Start() {
+        thread_ = thread(&AsyncWriter::Run, this);
+    }
+
+    bool IsRunning() const {
+        return thread_.joinable();
+    }
+
+    // Write everything pushed so far, then exit the thread.
+    void Stop() {
+        stop_.store(true, memory_order_release);
+        thread_.join();
+    }
+
+    __attribute__((format(printf, 3, 0)))
+    void Push(LogLevel level, const char* fmt, va_list args) {
+        uint64_t pos = enqueue_pos_.load(memory_order_relaxed);
+        Record* r;
+        while (true) {
+            r = &records_[pos & (LOG_RING_SIZE - 1)];
+            uint64_t seq = r->seq.load(memory_order_acquire);
+            if (seq == pos) {
+                if (enqueue_pos_.compare_exchange_weak(
+                        pos, pos + 1, memory_order_relaxed)) {
+                    break;
+                }
+            } else if (seq < pos) {
+                // Full (the consumer is a lap behind).  Errors wait for room,
+                // the rest are dropped.
+                if (LOG_ERROR < level) {
+                    num_dropped_.fetch_add(1, memory_order_relaxed);
+                    return;
+                }
+                std::this_thread::yield();
+                pos = enqueue_pos_.load(memory_order_relaxed);
+            } else {
+                pos = enqueue_pos_.load(memory_order_relaxed);
+            }
+        }
+
+        r->nanos = NanosSinceEpoch();
+        r->level = level;
+        r->size = FormatText(r->text, sizeof(r->text), fmt, args,
+                             &r->truncated);
+        r->seq.store(pos + 1, memory_order_release);
+    }
+
+    // Wait until everything pushed so far is written and flushed.
+    void Flush() const {
+        uint64_t pos = enqueue_pos_.load(memory_order_acquire);
+        while (flushed_pos_.load(memory_order_acquire) < pos) {
+            std::this_thread::sleep_for(microseconds(LOG_IDLE_SLEEP_MICROS));
+        }
+    }
+
+  private:
+    struct Record {
+        atomic<uint64_t> seq;
+        uint64_t nanos;
+        LogLevel level;
+        size_t size;
+        bool truncated;
+        char text[LOG_MESSAGE_SIZE];
+    };
+
+    static void Write(string* out) {
+        FILE* f = LOG_F.load(memory_order_acquire);
+        if (f && !out->empty()) {
+            fwrite(out->data(), 1, out->size(), f);
+        }
+        out->clear();
+    }
+
+    void Run() {
+        PrefixFormatter prefix;
+        string out;
+        out.reserve(LOG_WRITE_BUFFER_SIZE + LOG_MESSAGE_SIZE * 2);
+        uint64_t pos = flushed_pos_.load(memory_order_relaxed);
+        bool dirty = false;
+        size_t num_idle = 0;
+        while (true) {
+            Record* r = &records_[pos & (LOG_RING_SIZE - 1)];
+            if (r->seq.load(memory_order_acquire) == pos + 1) {
+                AppendMessage(&prefix, r->level, r->nanos, r->text, r->size,
+                              r->truncated, &out);
+                r->seq.store(pos + LOG_RING_SIZE, memory_order_release);
+                ++pos;
+                dirty = true;
+                num_idle = 0;
+                if (LOG_WRITE_BUFFER_SIZE <= out.size()) {
+                    Write(&out);
+                }
+                continue;
+            }
+
+            // Caught up: report drops, and flush.
+            uint64_t num_dropped = num_dropped_.exchange(0);
+            if (num_dropped) {
+                char s[64];
+                size_t size = static_cast<size_t>(snprintf(
+                    s, sizeof(s), "[Logging] Dropped %" PRIu64
+                    " messages.\n", num_dropped));
+                AppendMessage(&prefix, LOG_WARN, NanosSinceEpoch(), s, size,
+                              false, &out);
+                dirty = true;
+            }
+            if (dirty) {
+                Write(&out);
+                FILE* f = LOG_F.load(memory_order_acquire);
+                if (f) {
+                    fflush(f);
+                }
+                dirty = false;
+            }
+            flushed_pos_.store(pos, memory_order_release);
 
-void Log(LogLevel log_level, const char* fmt, va_list argptr) {
+            if (stop_.load(memory_order_acquire) &&
+                    enqueue_pos_.load(memory_order_acquire) == pos) {
+                return;
+            }
+
+            if (++num_idle < LOG_IDLE_YIELDS) {
+                std::this_thread::yield();
+            } else {
+                std::this_thread::sleep_for(
+                    microseconds(LOG_IDLE_SLEEP_MICROS));
+            }
+        }
+    }
+
+    unique_ptr<Record[]> records_;
+
+    // Next position to claim (producers).
+    atomic<uint64_t> enqueue_pos_;
+
+    // Positions before this are written and flushed (consumer).
+    atomic<uint64_t> flushed_pos_;
+
+    // Messages dropped because the ring was full, since last reported.
+    atomic<uint64_t> num_dropped_;
+
+    atomic<bool> stop_;
+    thread thread_;
+};
+
+mutex INIT_MUTEX;
+
+// Never destroyed, as messages may be logged during static destruction.
+AsyncWriter* ASYNC_WRITER = NULL;
+
+void StopAsyncWriter() {
+    lock_guard<mutex> lock(INIT_MUTEX);
+    LOG_ASYNC.store(false, memory_order_release);
+    ASYNC_WRITER->Stop();
+}
+
+// -----------------------------------------------------------------------------
+
+__attribute__((format(printf, 2, 0)))
+void Log(LogLevel log_level, const char* fmt, va_list args) {
     // Quit if no output file.
-    if (!LOG_F) {
+    FILE* f = LOG_F.load(memory_order_relaxed);
+    if (!f) {
         return;
     }
 
-    // Lower is more serious.
-    if (LOGGING_LEVEL < log_level) {
+    if (LOG_ASYNC.load(memory_order_acquire)) {
+        ASYNC_WRITER->Push(log_level, fmt, args);
+        if (log_level == LOG_FATAL) {
+            ASYNC_WRITER->Flush();
+        }
         return;
     }
 
-    // Write meta info.
+    // Synchronous: format the whole message, then write it in one call.  Each
+    // thread keeps its own prefix, so the timestamp is only redone when the
+    // second changes.
+    static thread_local PrefixFormatter prefix;
+    char text[LOG_MESSAGE_SIZE];
+    bool truncated;
+    size_t size = FormatText(text, sizeof(text), fmt, args, &truncated);
     string s;
-    Time::PrettyTime(&s);
-    const string& log_level_s = LogLevelStrings.GetString(log_level);
-    const char* color_prefix = LOGGING_USE_CONSOLE_COLORS ?
-        CONSOLE_COLOR_PREFIXES[log_level] : "";
-    const char* color_suffix = LOGGING_USE_CONSOLE_COLORS ?
-        CONSOLE_COLOR_SUFFIX : "";
-    fprintf(LOG_F, "[%s] [%s%s%s] ", s.c_str(), color_prefix,
-            log_level_s.c_str(), color_suffix);
-
-    // Write message.
-    vfprintf(LOG_F, fmt, argptr);
+    AppendMessage(&prefix, log_level, NanosSinceEpoch(), text, size, truncated,
+                  &s);
+    fwrite(s.data(), 1, s.size(), f);
 }
 
 }  // namespace
 
-void InitLogging(FILE* f) {
-    LOG_F = f;
-}
+void InitLogging(FILE* f, bool async) {
+    lock_guard<mutex> lock(INIT_MUTEX);
 
-void FATAL(const char* fmt, ...) {
-    va_list argptr;
-    va_start(argptr, fmt);
-    Log(LOG_FATAL, fmt, argptr);
-    va_end(argptr);
+    // Finish writing to the old file first.
+    if (LOG_ASYNC.load(memory_order_acquire)) {
+        ASYNC_WRITER->Flush();
+    }
+
+    LOG_F.store(f, memory_order_release);
+
+    if (async && !ASYNC_WRITER) {
+        ASYNC_WRITER = new AsyncWriter();
+        ASYNC_WRITER->Start();
+        atexit(StopAsyncWriter);
+    }
+    LOG_ASYNC.store(async && ASYNC_WRITER->IsRunning(),
+                    memory_order_release);
 }
 
-void ERROR(const char* fmt, ...) {
-    va_list argptr;
-    va_start(argptr, fmt);
-    Log(LOG_ERROR, fmt, argptr);
-    va_end(argptr);
+void FlushLogging() {
+    if (LOG_ASYNC.load(memory_order_acquire)) {
+        ASYNC_WRITER->Flush();
+    } else if (FILE* f = LOG_F.load(memory_order_acquire)) {
+        fflush(f);
+    }
 }
 
-void WARN(const char* fmt, ...) {
+void LogMessage(LogLevel level, const char* fmt, ...) {
     va_list argptr;
     va_start(argptr, fmt);
-    Log(LOG_WARN, fmt, argptr);
+    Log(level, fmt, argptr);
     va_end(argptr);
 }
 
-void INFO(const char* fmt, ...) {
-    va_list argptr;
-    va_start(argptr, fmt);
-    Log(LOG_INFO, fmt, argptr);
-    va_end(argptr);
+// -----------------------------------------------------------------------------
+// Rate limiting.
+
+LogRateLimiter::LogRateLimiter(uint32_t max_per_sec) :
+        max_per_sec_(max_per_sec), second_(0), num_this_second_(0),
+        num_suppressed_(0) {}
+
+bool LogRateLimiter::Allow(uint64_t* num_suppressed) {
+    uint64_t second = static_cast<uint64_t>(duration_cast<seconds>(
+        steady_clock::now().time_since_epoch()).count());
+    uint64_t prev = second_.load(memory_order_relaxed);
+    if (prev != second &&
+            second_.compare_exchange_strong(prev, second,
+                                            memory_order_relaxed)) {
+        num_this_second_.store(0, memory_order_relaxed);
+    }
+
+    if (max_per_sec_ <= num_this_second_.fetch_add(1, memory_order_relaxed)) {
+        num_suppressed_.fetch_add(1, memory_order_relaxed);
+        return false;
+    }
+
+    *num_suppressed = num_suppressed_.exchange(0, memory_order_relaxed);
+    return true;
 }
 
-void DEBUG(const char* fmt, ...) {
+void LogMessageRateLimited(LogRateLimiter* limiter, LogLevel level,
+                           const char* fmt, ...) {
+    uint64_t num_suppressed;
+    if (!limiter->Allow(&num_suppressed)) {
+        return;
+    }
+
+    if (num_suppressed) {
+        LogMessage(level, "[Logging] Suppressed %" PRIu64 " messages from "
+                   "here.\n", num_suppressed);
+    }
+
     va_list argptr;
     va_start(argptr, fmt);
-    Log(LOG_DEBUG, fmt, argptr);
+    Log(level, fmt, argptr);
     va_end(argptr);
 }
 
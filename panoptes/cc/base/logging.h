@@ -1,11 +1,30 @@
 #ifndef CC_BASE_LOGGING_H_
 #define CC_BASE_LOGGING_H_
 
+// Logging.
+//
+// Messages are formatted by the calling thread into a fixed-size record in a
+// lock-free ring buffer, and a background thread adds the timestamp and level
+// and writes them out, so callers never take a lock or touch the output file.
+// If the ring is full, ERROR and FATAL messages wait for room, and the rest are
+// dropped (and counted).  FATAL messages are flushed before returning.
+//
+// Usage:
+//   INFO("[Conjugator] Loaded %zu specs.\n", specs.size());
+//   LOG_RATE_LIMITED(LOG_WARN, 10, "Bad input: [%s].\n", s.c_str());
+//
+// Calls below LOGGING_LEVEL compile to nothing (their arguments are not
+// evaluated).
+
 #include <gflags/gflags.h>
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
 #include <string>
 
 #include "cc/base/enum_strings.h"
 
+using std::atomic;
 using std::string;
 
 enum LogLevel {
@@ -18,23 +37,73 @@ enum LogLevel {
 
 extern EnumStrings<LogLevel> LogLevelStrings;
 
-// Minimum level of criticality for a log message to be written.
-#define LOGGING_LEVEL LOG_DEBUG
+// Minimum level of criticality for a log message to be compiled in.  Define it
+// as LOG_DEBUG (eg, -DLOGGING_LEVEL=LOG_DEBUG) to get debug messages.
+#ifndef LOGGING_LEVEL
+#define LOGGING_LEVEL LOG_INFO
+#endif
 
 // Console-colorize logging output.
 #define LOGGING_USE_CONSOLE_COLORS true
 
-void InitLogging(FILE* f=stderr);
+// Write log messages to f.  If async, they are written by a background thread
+// (started on first use, and drained at exit), else directly by the caller.
+void InitLogging(FILE* f=stderr, bool async=true);
+
+// Block until every message logged so far has been written and flushed.
+void FlushLogging();
+
+// Log a message regardless of LOGGING_LEVEL (use the macros below instead).
+void LogMessage(LogLevel level, const char* fmt, ...)
+    __attribute__((format(printf, 2, 3)));
+
+#define LOG_AT(level, ...)                                                     \
+    do {                                                                       \
+        if ((level) <= LOGGING_LEVEL) {                                        \
+            LogMessage((level), __VA_ARGS__);                                  \
+        }                                                                      \
+    } while (false)
+
+#define FATAL(...) LOG_AT(LOG_FATAL, __VA_ARGS__)
 
-void FATAL(const char* s, ...);
+#define ERROR(...) LOG_AT(LOG_ERROR, __VA_ARGS__)
 
-void ERROR(const char* s, ...);
+#define WARN(...) LOG_AT(LOG_WARN, __VA_ARGS__)
 
-void WARN(const char* s, ...);
+#define INFO(...) LOG_AT(LOG_INFO, __VA_ARGS__)
+
+#define DEBUG(...) LOG_AT(LOG_DEBUG, __VA_ARGS__)
+
+// Limits one call site to a number of messages per second.
+class LogRateLimiter {
+  public:
+    explicit LogRateLimiter(uint32_t max_per_sec);
+
+    // Whether a message may be written now.  If so, also returns how many were
+    // suppressed since the last one that was.
+    bool Allow(uint64_t* num_suppressed);
+
+  private:
+    const uint32_t max_per_sec_;
+    atomic<uint64_t> second_;
+    atomic<uint32_t> num_this_second_;
+    atomic<uint64_t> num_suppressed_;
+};
 
-void INFO(const char* s, ...);
+// Log a message if the limiter allows it (use LOG_RATE_LIMITED instead).
+void LogMessageRateLimited(LogRateLimiter* limiter, LogLevel level,
+                           const char* fmt, ...)
+    __attribute__((format(printf, 3, 4)));
 
-void DEBUG(const char* s, ...);
+// Log at most max_per_sec messages per second from this call site.  The rest
+// are counted, and the count is noted with the next message written.
+#define LOG_RATE_LIMITED(level, max_per_sec, ...)                              \
+    do {                                                                       \
+        if ((level) <= LOGGING_LEVEL) {                                        \
+            static LogRateLimiter logging_limiter(max_per_sec);                \
+            LogMessageRateLimited(&logging_limiter, (level), __VA_ARGS__);     \
+        }                                                                      \
+    } while (false)
 
 string LogToStr(const string& s);
 
@@ -0,0 +1,265 @@
+#include "metrics.h"
+
+#include <cinttypes>
+#include <cstdio>
+#include <map>
+#include <memory>
+#include <mutex>
+
+#include "cc/format/json_writer.h"
+
+using std::lock_guard;
+using std::map;
+using std::memory_order_relaxed;
+using std::mutex;
+using std::unique_ptr;
+
+size_t GetMetricsShard() {
+    static atomic<size_t> next_shard(0);
+    static thread_local size_t shard = METRICS_NUM_SHARDS;
+    if (shard == METRICS_NUM_SHARDS) {
+        shard = next_shard.fetch_add(1, memory_order_relaxed) %
+            METRICS_NUM_SHARDS;
+    }
+    return shard;
+}
+
+// -----------------------------------------------------------------------------
+// Counter.
+
+Counter::Counter(const string& name) : name_(name) {
+    Reset();
+}
+
+uint64_t Counter::Get() const {
+    uint64_t n = 0;
+    for (auto& shard : shards_) {
+        n += shard.value.load(memory_order_relaxed);
+    }
+    return n;
+}
+
+void Counter::Reset() {
+    for (auto& shard : shards_) {
+        shard.value.store(0, memory_order_relaxed);
+    }
+}
+
+// -----------------------------------------------------------------------------
+// Histogram.
+
+uint64_t HistogramSnapshot::GetQuantile(double q) const {
+    if (!count) {
+        return 0;
+    }
+
+    // The rank of the value wanted, counting from 1.
+    uint64_t rank = static_cast<uint64_t>(q * static_cast<double>(count));
+    if (rank < 1) {
+        rank = 1;
+    } else if (count < rank) {
+        rank = count;
+    }
+
+    uint64_t seen = 0;
+    for (size_t i = 0; i < METRICS_NUM_BUCKETS; ++i) {
+        seen += buckets[i];
+        if (rank <= seen) {
+            return Histogram::GetBucketUpperBound(i);
+        }
+    }
+    return Histogram::GetBucketUpperBound(METRICS_NUM_BUCKETS - 1);
+}
+
+double HistogramSnapshot::GetMean() const {
+    return count ? static_cast<double>(sum) / static_cast<double>(count) : 0.0;
+}
+
+Histogram::Histogram(const string& name) : name_(name) {
+    Reset();
+}
+
+size_t Histogram::GetBucket(uint64_t value) {
+    return value ? 64 - static_cast<size_t>(__builtin_clzll(value)) : 0;
+}
+
+uint64_t Histogram::GetBucketUpperBound(size_t bucket) {
+    if (!bucket) {
+        return 0;
+    }
+    if (bucket == 64) {
+        return ~0ull;
+    }
+    return (1ull << bucket) - 1;
+}
+
+void Histogram::Record(uint64_t value) {
+    Shard* shard = &shards_[GetMetricsShard()];
+    shard->count.fetch_add(1, memory_order_relaxed);
+    shard->sum.fetch_add(value, memory_order_relaxed);
+    shard->buckets[GetBucket(value)].fetch_add(1, memory_order_relaxed);
+}
+
+void Histogram::GetSnapshot(HistogramSnapshot* snapshot) const {
+    snapshot->count = 0;
+    snapshot->sum = 0;
+    for (auto& n : snapshot->buckets) {
+        n = 0;
+    }
+
+    for (auto& shard : shards_) {
+        snapshot->count += shard.count.load(memory_order_relaxed);
+        snapshot->sum += shard.sum.load(memory_order_relaxed);
+        for (size_t i = 0; i < METRICS_NUM_BUCKETS; ++i) {
+            snapshot->buckets[i] += shard.buckets[i].load(memory_order_relaxed);
+        }
+    }
+}
+
+void Histogram::Reset() {
+    for (auto& shard : shards_) {
+        shard.count.store(0, memory_order_relaxed);
+        shard.sum.store(0, memory_order_relaxed);
+        for (auto& n : shard.buckets) {
+            n.store(0, memory_order_relaxed);
+        }
+    }
+}
+
+// -----------------------------------------------------------------------------
+// Registry.
+
+namespace {
+
+struct Registry {
+    mutex lock;
+    map<string, unique_ptr<Counter> > counters;
+    map<string, unique_ptr<Histogram> > histograms;
+};
+
+// Never destroyed, as metrics may be updated during static destruction.
+Registry* GetRegistry() {
+    static Registry* registry = new Registry();
+    return registry;
+}
+
+}  // namespace
+
+Counter* Metrics::GetCounter(const string& name) {
+    Registry* r = GetRegistry();
+    lock_guard<mutex> lock(r->lock);
+    unique_ptr<Counter>& counter = r->counters[name];
+    if (!counter) {
+        counter.reset(new Counter(name));
+    }
+    return counter.get();
+}
+
+Histogram* Metrics::GetHistogram(const string& name) {
+    Registry* r = GetRegistry();
+    lock_guard<mutex> lock(r->lock);
+    unique_ptr<Histogram>& histogram = r->histograms[name];
+    if (!histogram) {
+        histogram.reset(new Histogram(name));
+    }
+    return histogram.get();
+}
+
+void Metrics::Reset() {
+    Registry* r = GetRegistry();
+    lock_guard<mutex> lock(r->lock);
+    for (auto& it : r->counters) {
+        it.second->Reset();
+    }
+    for (auto& it : r->histograms) {
+        it.second->Reset();
+    }
+}
+
+void Metrics::ToJSON(json::Writer* w) {
+    Registry* r = GetRegistry();
+    lock_guard<mutex> lock(r->lock);
+
+    w->BeginObject();
+
+    w->WriteKey("counters");
+    w->BeginObject();
+    for (auto& it : r->counters) {
+        w->WriteKey(it.first);
+        w->WriteUInt(it.second->Get());
+    }
+    w->EndObject();
+
+    w->WriteKey("histograms");
+    w->BeginObject();
+    HistogramSnapshot snapshot;
+    for (auto& it : r->histograms) {
+        it.second->GetSnapshot(&snapshot);
+        w->WriteKey(it.first);
+        w->BeginObject();
+        w->WriteKey("count");
+        w->WriteUInt(snapshot.count);
+        w->WriteKey("sum");
+        w->WriteUInt(snapshot.sum);
+        w->WriteKey("mean");
+        w->WriteDouble(snapshot.GetMean(), 6);
+        w->WriteKey("p50");
+        w->WriteUInt(snapshot.GetQuantile(0.5));
+        w->WriteKey("p90");
+        w->WriteUInt(snapshot.GetQuantile(0.9));
+        w->WriteKey("p99");
+        w->WriteUInt(snapshot.GetQuantile(0.99));
+        w->WriteKey("max");
+        w->WriteUInt(snapshot.GetQuantile(1.0));
+
+        // Nonempty buckets, as [upper bound, count].
+        w->WriteKey("buckets");
+        w->BeginArray();
+        for (size_t i = 0; i < METRICS_NUM_BUCKETS; ++i) {
+            if (!snapshot.buckets[i]) {
+                continue;
+            }
+            w->BeginArray();
+            w->WriteUInt(Histogram::GetBucketUpperBound(i));
+            w->WriteUInt(snapshot.buckets[i]);
+            w->EndArray();
+        }
+        w->EndArray();
+        w->EndObject();
+    }
+    w->EndObject();
+
+    w->EndObject();
+}
+
+void Metrics::ToJSON(string* s) {
+    s->clear();
+    json::Writer w(s);
+    ToJSON(&w);
+}
+
+void Metrics::ToText(string* s) {
+    Registry* r = GetRegistry();
+    lock_guard<mutex> lock(r->lock);
+
+    s->clear();
+    char line[512];
+    for (auto& it : r->counters) {
+        snprintf(line, sizeof(line), "%-56s %" PRIu64 "\n", it.first.c_str(),
+                 it.second->Get());
+        *s += line;
+    }
+
+    // Quantiles are bucket upper bounds, so within a factor of two.
+    HistogramSnapshot snapshot;
+    for (auto& it : r->histograms) {
+        it.second->GetSnapshot(&snapshot);
+        snprintf(line, sizeof(line),
+                 "%-56s count=%" PRIu64 " mean=%.1f p50<=%" PRIu64
+                 " p90<=%" PRIu64 " p99<=%" PRIu64 " max<=%" PRIu64 "\n",
+                 it.first.c_str(), snapshot.count, snapshot.GetMean(),
+                 snapshot.GetQuantile(0.5), snapshot.GetQuantile(0.9),
+                 snapshot.GetQuantile(0.99), snapshot.GetQuantile(1.0));
+        *s += line;
+    }
+}
@@ -0,0 +1,147 @@
+#ifndef CC_BASE_METRICS_H_
+#define CC_BASE_METRICS_H_
+
+// Hot-path metrics.
+//
+// Named counters and latency histograms, created on first use and kept for the
+// life of the process.  Updates never lock: each thread adds into its own shard
+// of the metric, and the shards are only summed when a snapshot is taken.
+//
+// Usage:
+//   static Counter* hits = Metrics::GetCounter("verb_parser.hits.fir");
+//   hits->Add(num_matches);
+//
+//   static Histogram* latency = Metrics::GetHistogram("verb_parser.parse_ns");
+//   ScopedLatency timer(latency);
+//
+//   string s;
+//   Metrics::ToText(&s);
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+#include "cc/base/time.h"
+
+using std::atomic;
+using std::string;
+
+namespace json {
+class Writer;
+}  // namespace json
+
+// Shards per metric (threads share them round-robin).
+#define METRICS_NUM_SHARDS 16
+
+// Histogram buckets: bucket 0 counts zeros, and bucket i counts values in
+// [2^(i-1), 2^i).
+#define METRICS_NUM_BUCKETS 65
+
+// Spacing of shards, so that threads don't write to the same cache line.
+#define METRICS_CACHE_LINE_SIZE 64
+
+// The shard the calling thread updates.
+size_t GetMetricsShard();
+
+class Counter {
+  public:
+    explicit Counter(const string& name);
+
+    const string& name() const { return name_; }
+
+    void Add(uint64_t n = 1) {
+        shards_[GetMetricsShard()].value.fetch_add(
+            n, std::memory_order_relaxed);
+    }
+
+    uint64_t Get() const;
+
+    void Reset();
+
+  private:
+    struct Shard {
+        atomic<uint64_t> value;
+        char padding[METRICS_CACHE_LINE_SIZE - sizeof(atomic<uint64_t>)];
+    };
+
+    string name_;
+    Shard shards_[METRICS_NUM_SHARDS];
+};
+
+// Point-in-time totals of a histogram.
+struct HistogramSnapshot {
+    uint64_t count;
+    uint64_t sum;
+    uint64_t buckets[METRICS_NUM_BUCKETS];
+
+    // Upper bound of the bucket holding the given quantile (0 to 1) of the
+    // values, or 0 if empty.
+    uint64_t GetQuantile(double q) const;
+
+    double GetMean() const;
+};
+
+class Histogram {
+  public:
+    explicit Histogram(const string& name);
+
+    const string& name() const { return name_; }
+
+    void Record(uint64_t value);
+
+    void GetSnapshot(HistogramSnapshot* snapshot) const;
+
+    void Reset();
+
+    // Bucket of a value, and the largest value in a bucket.
+    static size_t GetBucket(uint64_t value);
+    static uint64_t GetBucketUpperBound(size_t bucket);
+
+  private:
+    struct Shard {
+        atomic<uint64_t> count;
+        atomic<uint64_t> sum;
+        atomic<uint64_t> buckets[METRICS_NUM_BUCKETS];
+        char padding[METRICS_CACHE_LINE_SIZE - sizeof(atomic<uint64_t>)];
+    };
+
+    string name_;
+    Shard shards_[METRICS_NUM_SHARDS];
+};
+
+// Records the nanoseconds from construction to destruction.
+class ScopedLatency {
+  public:
+    explicit ScopedLatency(Histogram* histogram) :
+        histogram_(histogram), begin_(Time::MonotonicNanos()) {}
+
+    ScopedLatency(const ScopedLatency&) = delete;
+    ScopedLatency& operator=(const ScopedLatency&) = delete;
+
+    ~ScopedLatency() {
+        histogram_->Record(Time::MonotonicNanos() - begin_);
+    }
+
+  private:
+    Histogram* histogram_;
+    uint64_t begin_;
+};
+
+// The process-wide registry.  Thread-safe.
+class Metrics {
+  public:
+    // Get the metric with the given name, creating it if new.  The pointers
+    // stay valid forever, so call sites look them up once.
+    static Counter* GetCounter(const string& name);
+    static Histogram* GetHistogram(const string& name);
+
+    // Zero every metric.
+    static void Reset();
+
+    // Dump a snapshot of every metric, sorted by name.
+    static void ToJSON(json::Writer* w);
+    static void ToJSON(string* s);
+    static void ToText(string* s);
+};
+
+#endif  // CC_BASE_METRICS_H_
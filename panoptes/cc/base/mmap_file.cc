@@ -0,0 +1,49 @@
+#include "mmap_file.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+MmapFile::MmapFile() : data_(NULL), size_(0) {
+}
+
+MmapFile::~MmapFile() {
+    Close();
+}
+
+bool MmapFile::Open(const string& file_name) {
+    Close();
+
+    int fd = open(file_name.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) || st.st_size <= 0) {
+        close(fd);
+        return false;
+    }
+    size_t size = static_cast<size_t>(st.st_size);
+
+    void* p = mmap(NULL, size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (p == MAP_FAILED) {
+        return false;
+    }
+
+    data_ = static_cast<const char*>(p);
+    size_ = size;
+    return true;
+}
+
+void MmapFile::Close() {
+    if (!data_) {
+        return;
+    }
+
+    munmap(const_cast<char*>(data_), size_);
+    data_ = NULL;
+    size_ = 0;
+}
@@ -0,0 +1,31 @@
+#ifndef CC_BASE_MMAP_FILE_H_
+#define CC_BASE_MMAP_FILE_H_
+
+#include <string>
+
+using std::string;
+
+// A whole file mapped read-only into memory.  The pages are shared with every
+// other process mapping the same file.
+class MmapFile {
+  public:
+    MmapFile();
+    ~MmapFile();
+
+    MmapFile(const MmapFile&) = delete;
+    MmapFile& operator=(const MmapFile&) = delete;
+
+    const char* data() const { return data_; }
+    size_t size() const { return size_; }
+
+    // Map the file, unmapping any previous one.  Returns false on error.
+    bool Open(const string& file_name);
+
+    void Close();
+
+  private:
+    const char* data_;
+    size_t size_;
+};
+
+#endif  // CC_BASE_MMAP_FILE_H_
@@ -0,0 +1,37 @@
+#include "parallel.h"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using std::atomic;
+using std::thread;
+using std::vector;
+
+size_t Parallel::DefaultNumThreads() {
+    unsigned n = thread::hardware_concurrency();
+    return n ? n : 1;
+}
+
+void Parallel::For(size_t num_tasks, size_t num_threads,
+                   const function<void(size_t)>& f) {
+    atomic<size_t> next_task(0);
+    auto work = [&]() {
+        for (size_t i = next_task++; i < num_tasks; i = next_task++) {
+            f(i);
+        }
+    };
+
+    if (num_tasks < num_threads) {
+        num_threads = num_tasks;
+    }
+
+    vector<thread> threads;
+    for (size_t i = 1; i < num_threads; ++i) {
+        threads.emplace_back(work);
+    }
+    work();
+    for (auto& t : threads) {
+        t.join();
+    }
+}
@@ -0,0 +1,21 @@
+#ifndef CC_BASE_PARALLEL_H_
+#define CC_BASE_PARALLEL_H_
+
+#include <cstddef>
+#include <functional>
+
+using std::function;
+
+class Parallel {
+  public:
+    // The number of hardware threads, or 1 if unknown.
+    static size_t DefaultNumThreads();
+
+    // Call f(0) .. f(num_tasks - 1) from up to num_threads threads (the
+    // calling thread included), handing out tasks in order as threads free up.
+    // Returns once every call has returned.
+    static void For(size_t num_tasks, size_t num_threads,
+                    const function<void(size_t)>& f);
+};
+
+#endif  // CC_BASE_PARALLEL_H_
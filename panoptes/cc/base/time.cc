@@ -8,6 +8,8 @@
 #include "cc/base/string.h"
 
 using std::chrono::duration_cast;
+using std::chrono::nanoseconds;
+using std::chrono::steady_clock;
 using std::chrono::system_clock;
 using std::string;
 
@@ -30,3 +32,8 @@ uint64_t Time::MicrosSinceEpoch() {
     return static_cast<uint64_t>(duration_cast<std::chrono::microseconds>
         (system_clock::now().time_since_epoch()).count());
 }
+
+uint64_t Time::MonotonicNanos() {
+    return static_cast<uint64_t>(duration_cast<nanoseconds>(
+        steady_clock::now().time_since_epoch()).count());
+}
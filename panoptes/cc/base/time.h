@@ -1,6 +1,7 @@
 #ifndef CC_BASE_TIME_H_
 #define CC_BASE_TIME_H_
 
+#include <cstdint>
 #include <string>
 
 using std::string;
@@ -9,6 +10,9 @@ class Time {
   public:
     static void PrettyTime(string* s);
     static uint64_t MicrosSinceEpoch();
+
+    // Nanoseconds on a clock that never goes backwards (for timing).
+    static uint64_t MonotonicNanos();
 };
 
 #endif  // CC_BASE_TIME_H_
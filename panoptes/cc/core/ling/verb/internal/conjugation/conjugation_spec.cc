@@ -14,108 +14,116 @@ using std::vector;
 
 // -----------------------------------------------------------------------------
 
+namespace {
+
+// "go\tgoing\tgone\tgo|go|goes|go|go|go\twent|went|went|went|went|went" ->
+// the fields in ConjugationSpec::GetField() order.
+void ParseFields(const string& line, vector<string>* fields) {
+    vector<string> pieces;
+    String::Split(line, '\t', &pieces);
+    fields->assign(pieces.begin(), pieces.begin() + 3);
+    vector<string> nonpast;
+    String::Split(pieces[3], '|', &nonpast);
+    fields->insert(fields->end(), nonpast.begin(), nonpast.end());
+    vector<string> past;
+    String::Split(pieces[4], '|', &past);
+    fields->insert(fields->end(), past.begin(), past.end());
+    assert(fields->size() == CONJ_SPEC_NUM_FIELDS);
+}
+
+// Inverse of ParseFields().
+void AppendFields(const StringView* fields, string* s) {
+    for (unsigned i = 0; i < CONJ_SPEC_NUM_FIELDS; ++i) {
+        if (i == 1 || i == 2 || i == 3 || i == 9) {
+            *s += '\t';
+        } else if (i) {
+            *s += '|';
+        }
+        fields[i].AppendTo(s);
+    }
+}
+
+}  // namespace
+
 void ConjugationSpec::Init(
         const string& lemma, const string& pres_part, const string& past_part,
         const vector<string>& nonpast, const vector<string>& past) {
-    lemma_ = lemma;
-    pres_part_ = pres_part;
-    past_part_ = past_part;
-    nonpast_ = nonpast;
-    past_ = past;
-    has_do_support_ = (lemma != "be");
+    assert(nonpast.size() == 6);
+    assert(past.size() == 6);
+    StringView fields[CONJ_SPEC_NUM_FIELDS];
+    fields[0] = lemma;
+    fields[1] = pres_part;
+    fields[2] = past_part;
+    for (unsigned i = 0; i < 6; ++i) {
+        fields[3 + i] = nonpast[i];
+        fields[9 + i] = past[i];
+    }
+    InitFromFields(fields);
 }
 
-void ConjugationSpec::AnnotateAsAux() {
-    for (unsigned i = 0; i < nonpast_.size(); ++i) {
-        nonpast_[i] = "<" + nonpast_[i] + "-aux>";
+void ConjugationSpec::InitFromFields(const StringView* fields) {
+    size_t size = 0;
+    for (unsigned i = 0; i < CONJ_SPEC_NUM_FIELDS; ++i) {
+        size += fields[i].size();
     }
-    for (unsigned i = 0; i < past_.size(); ++i) {
-        past_[i] = "<" + past_[i] + "-aux>";
+    assert(size <= UINT16_MAX);
+
+    string chars;
+    chars.reserve(size);
+    for (unsigned i = 0; i < CONJ_SPEC_NUM_FIELDS; ++i) {
+        fields[i].AppendTo(&chars);
+        ends_[i] = static_cast<uint16_t>(chars.size());
     }
+    chars_.swap(chars);
+    has_do_support_ = (lemma() != "be");
 }
 
-const string& ConjugationSpec::GetField(unsigned f) const {
-    switch (f) {
-    case 0:
-        return lemma_;
-    case 1:
-        return pres_part_;
-    case 2:
-        return past_part_;
-    case 3:
-    case 4:
-    case 5:
-    case 6:
-    case 7:
-    case 8:
-        return nonpast_[f - 3u];
-    case 9:
-    case 10:
-    case 11:
-    case 12:
-    case 13:
-    case 14:
-        return past_[f - 9u];
-    default:
-        assert(false);
-        return lemma_;
+void ConjugationSpec::AnnotateAsAux() {
+    vector<string> words(CONJ_SPEC_NUM_FIELDS);
+    StringView fields[CONJ_SPEC_NUM_FIELDS];
+    for (unsigned i = 0; i < CONJ_SPEC_NUM_FIELDS; ++i) {
+        GetField(i).AssignTo(&words[i]);
+        if (3 <= i) {
+            words[i] = "<" + words[i] + "-aux>";
+        }
+        fields[i] = words[i];
     }
+    InitFromFields(fields);
 }
 
 void ConjugationSpec::ToString(string* s) {
-    s->clear();
-    *s += lemma_ + '\t' + pres_part_ + '\t' + past_part_ + '\t';
-    if (nonpast_.size()) {
-        *s += nonpast_[0];
-    }
-    for (size_t j = 1; j < nonpast_.size(); ++j) {
-        *s += '|' + nonpast_[j];
-    }
-    if (past_.size()) {
-        *s += '\t' + past_[0];
-    }
-    for (size_t j = 1; j < past_.size(); ++j) {
-        *s += '|' + past_[j];
+    StringView fields[CONJ_SPEC_NUM_FIELDS];
+    for (unsigned i = 0; i < CONJ_SPEC_NUM_FIELDS; ++i) {
+        fields[i] = GetField(i);
     }
+    s->clear();
+    AppendFields(fields, s);
 }
 
 void ConjugationSpec::FromString(const string& s) {
-    vector<string> pieces;
-    String::Split(s, '\t', &pieces);
-    string lemma = pieces[0];
-    string pres_part = pieces[1];
-    string past_part = pieces[2];
-    vector<string> nonpast;
-    String::Split(pieces[3], '|', &nonpast);
-    vector<string> past;
-    String::Split(pieces[4], '|', &past);
-    Init(lemma, pres_part, past_part, nonpast, past);
+    vector<string> words;
+    ParseFields(s, &words);
+    StringView fields[CONJ_SPEC_NUM_FIELDS];
+    for (unsigned i = 0; i < CONJ_SPEC_NUM_FIELDS; ++i) {
+        fields[i] = words[i];
+    }
+    InitFromFields(fields);
 }
 
 // -----------------------------------------------------------------------------
 
 void FlatConjSpec::ToConjSpec(ConjugationSpec* spec) {
-    vector<string> nonpast;
-    for (unsigned i = 3; i < 9; ++i) {
-        nonpast.emplace_back(words_[i]);
-    }
-    vector<string> past;
-    for (unsigned i = 9; i < 15; ++i) {
-        past.emplace_back(words_[i]);
+    StringView fields[CONJ_SPEC_NUM_FIELDS];
+    for (unsigned i = 0; i < CONJ_SPEC_NUM_FIELDS; ++i) {
+        fields[i] = words_[i];
     }
-    spec->Init(words_[0], words_[1], words_[2], nonpast, past);
+    spec->InitFromFields(fields);
 }
 
 void FlatConjSpec::FromConjSpec(const ConjugationSpec& spec) {
-    words_.resize(1 + 1 + 1 + 6 + 6);
-    words_[0] = spec.lemma();
-    words_[1] = spec.pres_part();
-    words_[2] = spec.past_part();
-    for (size_t i = 0; i < 6; ++i) {
-        words_[3 + i] = spec.nonpast()[i];
-    }
-    for (size_t i = 0; i < 6; ++i) {
-        words_[9 + i] = spec.past()[i];
+    words_.resize(CONJ_SPEC_NUM_FIELDS);
+    for (unsigned i = 0; i < CONJ_SPEC_NUM_FIELDS; ++i) {
+        spec.GetField(i).AssignTo(&words_[i]);
     }
     s2xx_.clear();
     for (unsigned i = 0; i < words_.size(); ++i) {
@@ -125,32 +133,56 @@ void FlatConjSpec::FromConjSpec(const ConjugationSpec& spec) {
 
 // -----------------------------------------------------------------------------
 
+StringView ConjugationSpecConfig::GetField(size_t spec_index,
+                                           unsigned field_index) const {
+    assert(field_index < CONJ_SPEC_NUM_FIELDS);
+    size_t x = spec_index * CONJ_SPEC_NUM_FIELDS + field_index;
+    uint32_t begin = x ? ends_[x - 1] : 0;
+    return StringView(chars_.data() + begin, ends_[x] - begin);
+}
+
+void ConjugationSpecConfig::GetSpec(size_t spec_index,
+                                    ConjugationSpec* spec) const {
+    StringView fields[CONJ_SPEC_NUM_FIELDS];
+    for (unsigned i = 0; i < CONJ_SPEC_NUM_FIELDS; ++i) {
+        fields[i] = GetField(spec_index, i);
+    }
+    spec->InitFromFields(fields);
+}
+
 void ConjugationSpecConfig::ToString(string* s) {
+    StringView fields[CONJ_SPEC_NUM_FIELDS];
     s->clear();
-    if (specs_.size()) {
-        string tmp;
-        specs_[0].ToString(&tmp);
-        *s += tmp;
+    if (size()) {
+        for (unsigned j = 0; j < CONJ_SPEC_NUM_FIELDS; ++j) {
+            fields[j] = GetField(0, j);
+        }
+        AppendFields(fields, s);
     }
-    for (unsigned i = 0; i < specs_.size(); ++i) {
+    for (size_t i = 0; i < size(); ++i) {
         *s += '\n';
-        string tmp;
-        specs_[i].ToString(&tmp);
-        *s += tmp;
+        for (unsigned j = 0; j < CONJ_SPEC_NUM_FIELDS; ++j) {
+            fields[j] = GetField(i, j);
+        }
+        AppendFields(fields, s);
     }
 }
 
 void ConjugationSpecConfig::FromString(const string& s) {
-    specs_.clear();
+    chars_.clear();
+    ends_.clear();
     vector<string> v;
     String::Split(s, '\n', &v);
+    vector<string> words;
     for (unsigned i = 0; i < v.size() - 1; ++i) {
-        ConjugationSpec spec;
-        spec.FromString(v[i]);
-        specs_.emplace_back(spec);
+        ParseFields(v[i], &words);
+        for (auto& word : words) {
+            chars_ += word;
+            ends_.emplace_back(static_cast<uint32_t>(chars_.size()));
+        }
     }
     INFO("[ConjugationSpecConfig] Loaded %zu verb conjugation specs.\n",
-         specs_.size());
+         size());
 }
 
 // -----------------------------------------------------------------------------
@@ -1,30 +1,46 @@
 #ifndef CC_VERB_INTERNAL_CONJUGATION_CONJUGATION_SPEC_H_
 #define CC_VERB_INTERNAL_CONJUGATION_CONJUGATION_SPEC_H_
 
+#include <cassert>
+#include <cstdint>
 #include <map>
 #include <string>
 #include <vector>
 
+#include "cc/ds/string_view.h"
+
 using std::map;
 using std::string;
 using std::vector;
 
 // -----------------------------------------------------------------------------
 
+// Lemma, pres part, past part, six nonpast and six past.
+#define CONJ_SPEC_NUM_FIELDS 15
+
 // The specification for how to conjugate a verb.
+//
+// All the words live in one buffer, back to back in field order, with the end
+// of each, so a spec is one allocation and fields are handed out as views.
 class ConjugationSpec {
   public:
-    const string& lemma() const { return lemma_; }
-    const string& pres_part() const { return pres_part_; }
-    const string& past_part() const { return past_part_; }
-    const vector<string>& nonpast() const { return nonpast_; }
-    const vector<string>& past() const { return past_; }
+    ConjugationSpec() : ends_(), has_do_support_(true) {}
+
+    StringView lemma() const { return GetField(0); }      // "go".
+    StringView pres_part() const { return GetField(1); }  // "going".
+    StringView past_part() const { return GetField(2); }  // "gone".
     bool has_do_support() const { return has_do_support_; }
 
+    // Six nonpast ("go", "goes") and past ("went") for 3 persons x 2 numbers.
+    // Indicative mood only.  Subjunctive, imperative moods are handled using
+    // indicative's fields.
     void Init(const string& lemma, const string& pres_part,
               const string& past_part, const vector<string>& nonpast,
               const vector<string>& past);
 
+    // From all CONJ_SPEC_NUM_FIELDS fields, in GetField() order.
+    void InitFromFields(const StringView* fields);
+
     void AnnotateAsAux();
 
     // Field index means:
@@ -33,23 +49,20 @@ class ConjugationSpec {
     // * 2    past part
     // * 3-8  nonpast (1S 2S 3S 1P 2P 3P)
     // * 9-15 past (1S 2S 3S 1P 2P 3P)
-    const string& GetField(unsigned field_index) const;
+    StringView GetField(unsigned field_index) const {
+        assert(field_index < CONJ_SPEC_NUM_FIELDS);
+        uint16_t begin = field_index ? ends_[field_index - 1] : 0;
+        return StringView(chars_.data() + begin,
+                          ends_[field_index] - begin);
+    }
 
     void ToString(string* s);
     void FromString(const string& s);
 
   private:
-    // Basics.
-    string lemma_;            // Lemma ("go").
-    string pres_part_;        // Present participle ("going").
-    string past_part_;        // Past participle ("gone").
-
-    // Six nonpast ("go", "goes") and past ("went") for 3 persons x 2 numbers.
-    //
-    // Indicative mood only.  Subjunctive, imperative moods are handled using
-    // indicative's fields..
-    vector<string> nonpast_;
-    vector<string> past_;
+    // The words, and where each ends.
+    string chars_;
+    uint16_t ends_[CONJ_SPEC_NUM_FIELDS];
 
     // Do-support: whether to fall back to auxiliary "do" in negative or
     // interrogative clauses (eg "do you know?" vs "arent' you?").
@@ -76,15 +89,26 @@ class FlatConjSpec {
 
 // -----------------------------------------------------------------------------
 
+// The lexicon of verbs as given, all in one buffer like a ConjugationSpec.
 class ConjugationSpecConfig {
   public:
-    const vector<ConjugationSpec>& specs() const { return specs_; }
+    size_t size() const { return ends_.size() / CONJ_SPEC_NUM_FIELDS; }
+
+    StringView GetField(size_t spec_index, unsigned field_index) const;
+
+    StringView lemma(size_t spec_index) const {
+        return GetField(spec_index, 0);
+    }
+
+    void GetSpec(size_t spec_index, ConjugationSpec* spec) const;
 
     void ToString(string* s);
     void FromString(const string& s);
 
   private:
-    vector<ConjugationSpec> specs_;
+    // Every spec's words, and where each ends.
+    string chars_;
+    vector<uint32_t> ends_;
 };
 
 // -----------------------------------------------------------------------------
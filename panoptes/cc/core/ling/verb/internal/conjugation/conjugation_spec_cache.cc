@@ -0,0 +1,88 @@
+#include "conjugation_spec_cache.h"
+
+#include <functional>
+
+using std::hash;
+using std::lock_guard;
+using std::mutex;
+
+void ConjugationSpecCache::Init(size_t capacity) {
+    capacity_ = capacity;
+    shard_capacity_ = (capacity + NUM_SHARDS - 1) / NUM_SHARDS;
+    Clear();
+}
+
+void ConjugationSpecCache::Clear() {
+    for (size_t i = 0; i < NUM_SHARDS; ++i) {
+        Shard* shard = &shards_[i];
+        lock_guard<mutex> lock(shard->mutex);
+        shard->lru.clear();
+        shard->lemma2entry.clear();
+    }
+    hits_ = 0;
+    misses_ = 0;
+    evictions_ = 0;
+}
+
+ConjugationSpecCache::Shard* ConjugationSpecCache::GetShard(
+        const string& lemma) {
+    hash<string> f;
+    return &shards_[f(lemma) % NUM_SHARDS];
+}
+
+shared_ptr<const ConjugationSpec> ConjugationSpecCache::Get(
+        const string& lemma) {
+    if (!capacity_) {
+        return NULL;
+    }
+
+    Shard* shard = GetShard(lemma);
+    lock_guard<mutex> lock(shard->mutex);
+    auto it = shard->lemma2entry.find(lemma);
+    if (it == shard->lemma2entry.end()) {
+        ++misses_;
+        return NULL;
+    }
+
+    // Move to front.
+    shard->lru.splice(shard->lru.begin(), shard->lru, it->second);
+    ++hits_;
+    return it->second->second;
+}
+
+void ConjugationSpecCache::Put(
+        const string& lemma, const shared_ptr<const ConjugationSpec>& spec) {
+    if (!capacity_) {
+        return;
+    }
+
+    Shard* shard = GetShard(lemma);
+    lock_guard<mutex> lock(shard->mutex);
+
+    // Another thread may have derived it at the same time.
+    if (shard->lemma2entry.find(lemma) != shard->lemma2entry.end()) {
+        return;
+    }
+
+    shard->lru.emplace_front(lemma, spec);
+    shard->lemma2entry[lemma] = shard->lru.begin();
+
+    while (shard_capacity_ < shard->lru.size()) {
+        shard->lemma2entry.erase(shard->lru.back().first);
+        shard->lru.pop_back();
+        ++evictions_;
+    }
+}
+
+void ConjugationSpecCache::GetStats(ConjugationSpecCacheStats* stats) const {
+    stats->hits = hits_;
+    stats->misses = misses_;
+    stats->evictions = evictions_;
+    stats->size = 0;
+    for (size_t i = 0; i < NUM_SHARDS; ++i) {
+        const Shard* shard = &shards_[i];
+        lock_guard<mutex> lock(shard->mutex);
+        stats->size += shard->lru.size();
+    }
+    stats->capacity = capacity_;
+}
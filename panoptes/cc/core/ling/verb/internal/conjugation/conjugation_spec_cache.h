@@ -0,0 +1,74 @@
+#ifndef CC_VERB_INTERNAL_CONJUGATION_CONJUGATION_SPEC_CACHE_H_
+#define CC_VERB_INTERNAL_CONJUGATION_CONJUGATION_SPEC_CACHE_H_
+
+#include <atomic>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+#include "cc/core/ling/verb/internal/conjugation/conjugation_spec.h"
+
+using std::list;
+using std::pair;
+using std::shared_ptr;
+using std::string;
+using std::unordered_map;
+
+struct ConjugationSpecCacheStats {
+    uint64_t hits;
+    uint64_t misses;
+    uint64_t evictions;
+    size_t size;
+    size_t capacity;
+};
+
+// Bounded, thread-safe lemma -> derived ConjugationSpec cache.
+//
+// Sharded by lemma hash, each shard being an LRU list under its own lock.
+// Specs are handed out as shared pointers, so an eviction never pulls a spec
+// out from under a reader.
+class ConjugationSpecCache {
+  public:
+    size_t capacity() const { return capacity_; }
+
+    // Zero capacity disables the cache.  Not thread-safe against lookups.
+    void Init(size_t capacity);
+
+    void Clear();
+
+    // Returns NULL on a miss.
+    shared_ptr<const ConjugationSpec> Get(const string& lemma);
+
+    void Put(const string& lemma,
+             const shared_ptr<const ConjugationSpec>& spec);
+
+    void GetStats(ConjugationSpecCacheStats* stats) const;
+
+  private:
+    static const size_t NUM_SHARDS = 16;
+
+    // Most recently used first.
+    typedef list<pair<string, shared_ptr<const ConjugationSpec> > > LRUList;
+
+    struct Shard {
+        mutable std::mutex mutex;
+        LRUList lru;
+        unordered_map<string, LRUList::iterator> lemma2entry;
+    };
+
+    Shard* GetShard(const string& lemma);
+
+    size_t capacity_ = 0;
+    size_t shard_capacity_ = 0;
+    Shard shards_[NUM_SHARDS];
+
+    std::atomic<uint64_t> hits_{0};
+    std::atomic<uint64_t> misses_{0};
+    std::atomic<uint64_t> evictions_{0};
+};
+
+#endif  // CC_VERB_INTERNAL_CONJUGATION_CONJUGATION_SPEC_CACHE_H_
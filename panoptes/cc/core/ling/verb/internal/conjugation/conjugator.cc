@@ -1,47 +1,68 @@
 #include "conjugator.h"
 
 #include <algorithm>
+#include <cassert>
+#include <cstddef>
 #include <functional>
 #include <map>
+#include <memory>
 #include <set>
 #include <string>
 #include <vector>
 
 #include "cc/base/file.h"
+#include "cc/base/metrics.h"
 #include "cc/base/string.h"
+#include "cc/base/time.h"
 
 using std::hash;
 using std::make_pair;
+using std::make_shared;
 using std::map;
+using std::max;
 using std::pair;
 using std::set;
+using std::shared_ptr;
+using std::sort;
 using std::string;
+using std::swap;
 using std::vector;
 
+// Plenty for the verbs of a typical corpus (be/have/do and the long head).
+#define DEFAULT_SPEC_CACHE_CAPACITY 4096
+
 LemmaAndIndex::LemmaAndIndex(const string& _lemma, uint8_t _index) {
     lemma = _lemma;
     index = _index;
 }
 
+LemmaViewAndIndex::LemmaViewAndIndex(const StringView& _lemma,
+                                     uint8_t _index) {
+    lemma = _lemma;
+    index = _index;
+}
+
 // -----------------------------------------------------------------------------
 
 void ConjSpecDerivation::Init(const ConjugationSpec& spec) {
-    pres_part_.InitFromExample(spec.lemma(), spec.pres_part());
-    past_part_.InitFromExample(spec.lemma(), spec.past_part());
-    nonpast_.resize(spec.nonpast().size());
-    for (unsigned i = 0; i < spec.nonpast().size(); ++i) {
-        nonpast_[i].InitFromExample(spec.lemma(), spec.nonpast()[i]);
+    string lemma = spec.lemma().ToString();
+    pres_part_.InitFromExample(lemma, spec.pres_part().ToString());
+    past_part_.InitFromExample(lemma, spec.past_part().ToString());
+    nonpast_.resize(6);
+    for (unsigned i = 0; i < nonpast_.size(); ++i) {
+        nonpast_[i].InitFromExample(lemma, spec.GetField(3 + i).ToString());
     }
-    past_.resize(spec.past().size());
-    for (unsigned i = 0; i < spec.past().size(); ++i) {
-        past_[i].InitFromExample(spec.lemma(), spec.past()[i]);
+    past_.resize(6);
+    for (unsigned i = 0; i < past_.size(); ++i) {
+        past_[i].InitFromExample(lemma, spec.GetField(9 + i).ToString());
     }
 }
 
 namespace {
 
-void SetOne(const string& lemma, const string& conjugated,
+void SetOne(const string& lemma, StringView conjugated_view,
             SuffixTransform* transform, map<string, SuffixTransform>* cache) {
+    string conjugated = conjugated_view.ToString();
     string key = lemma + ":" + conjugated;
     map<string, SuffixTransform>::iterator it = cache->find(key);
     if (it == cache->end()) {
@@ -56,36 +77,32 @@ void SetOne(const string& lemma, const string& conjugated,
 
 void ConjSpecDerivation::InitUsingTransformCache(
         const ConjugationSpec& spec, map<string, SuffixTransform>* ba2t) {
-    string before = spec.lemma() + ":";
-    string key = before + spec.pres_part();
-    SetOne(spec.lemma(), spec.pres_part(), &pres_part_, ba2t);
-    SetOne(spec.lemma(), spec.past_part(), &past_part_, ba2t);
-    nonpast_.resize(spec.nonpast().size());
+    string lemma = spec.lemma().ToString();
+    SetOne(lemma, spec.pres_part(), &pres_part_, ba2t);
+    SetOne(lemma, spec.past_part(), &past_part_, ba2t);
+    nonpast_.resize(6);
     for (unsigned i = 0; i < nonpast_.size(); ++i) {
-        SetOne(spec.lemma(), spec.nonpast()[i], &(nonpast_[i]), ba2t);
+        SetOne(lemma, spec.GetField(3 + i), &(nonpast_[i]), ba2t);
     }
-    past_.resize(spec.past().size());
+    past_.resize(6);
     for (unsigned i = 0; i < past_.size(); ++i) {
-        SetOne(spec.lemma(), spec.past()[i], &(past_[i]), ba2t);
+        SetOne(lemma, spec.GetField(9 + i), &(past_[i]), ba2t);
     }
 }
 
-void ConjSpecDerivation::Derive(const string& lemma, ConjugationSpec* spec) {
+void ConjSpecDerivation::Derive(const string& lemma,
+                                ConjugationSpec* spec) const {
     string pres_part;
     string past_part;
-    vector<string> nonpast;
-    vector<string> past;
+    vector<string> nonpast(nonpast_.size());
+    vector<string> past(past_.size());
     pres_part_.Transform(lemma, &pres_part);
     past_part_.Transform(lemma, &past_part);
     for (unsigned i = 0; i < nonpast_.size(); ++i) {
-        string s;
-        nonpast_[i].Transform(lemma, &s);
-        nonpast.emplace_back(s);
+        nonpast_[i].Transform(lemma, &nonpast[i]);
     }
     for (unsigned i = 0; i < past_.size(); ++i) {
-        string s;
-        past_[i].Transform(lemma, &s);
-        past.emplace_back(s);
+        past_[i].Transform(lemma, &past[i]);
     }
     spec->Init(lemma, pres_part, past_part, nonpast, past);
 }
@@ -113,6 +130,22 @@ void ConjSpecDerivation::IdentifyWord(
     }
 }
 
+const SuffixTransform& ConjSpecDerivation::GetTransform(
+        unsigned field_index) const {
+    assert(1 <= field_index);
+    if (field_index == 1) {
+        return pres_part_;
+    }
+    if (field_index == 2) {
+        return past_part_;
+    }
+    size_t i = field_index - 3;
+    if (i < nonpast_.size()) {
+        return nonpast_[i];
+    }
+    return past_[i - nonpast_.size()];
+}
+
 Hash ConjSpecDerivation::HashCode() const {
     string s;
     s += pres_part_.ToString();
@@ -130,7 +163,7 @@ Hash ConjSpecDerivation::HashCode() const {
 // -----------------------------------------------------------------------------
 
 static void CollectVerbDerivations(
-        const vector<ConjugationSpec>& specs,
+        const ConjugationSpecConfig& config,
         vector<ConjSpecDerivation>* ordered_derivs,
         map<string, size_t>* lemma2ordered_derivx) {
     // The SuffixTransform cache.  Many transformations are the same.
@@ -151,17 +184,19 @@ static void CollectVerbDerivations(
 
     // List the unique verb derivations, and the verbs handled by each
     // derivation.
-    for (unsigned i = 0; i < specs.size(); ++i) {
+    ConjugationSpec spec;
+    for (size_t i = 0; i < config.size(); ++i) {
         // Dupe verb check.
-        const string lemma = specs[i].lemma();
+        const string lemma = config.lemma(i).ToString();
         if (lemmas_set.find(lemma) != lemmas_set.end()) {
             continue;
         }
         lemmas_set.insert(lemma);
 
         // Create derivation from the spec's fields.
+        config.GetSpec(i, &spec);
         ConjSpecDerivation deriv;
-        deriv.InitUsingTransformCache(specs[i], &before_after2transform);
+        deriv.InitUsingTransformCache(spec, &before_after2transform);
 
         // Hash it, check if seen.
         Hash hash = deriv.HashCode();
@@ -211,16 +246,110 @@ static void CollectVerbDerivations(
     }
 }
 
+bool DerivAndField::operator<(const DerivAndField& other) const {
+    if (derivx != other.derivx) {
+        return derivx < other.derivx;
+    }
+    return field_index < other.field_index;
+}
+
+// -----------------------------------------------------------------------------
+
+void Conjugator::BuildAppendIndex() {
+    rev_append2candidates_.clear();
+    max_append_len_ = 0;
+    for (size_t i = 0; i < derivs_.size(); ++i) {
+        // Every field but the lemma (which is never transformed).
+        for (unsigned j = 1; j < 15; ++j) {
+            const string& append = derivs_[i].GetTransform(j).append();
+            string key(append.rbegin(), append.rend());
+            DerivAndField c;
+            c.derivx = static_cast<uint32_t>(i);
+            c.field_index = static_cast<uint8_t>(j);
+            rev_append2candidates_[key].emplace_back(c);
+            max_append_len_ = max(max_append_len_, append.size());
+        }
+    }
+}
+
+void Conjugator::GetCandidates(
+        const string& conjugated, vector<DerivAndField>* candidates) const {
+    candidates->clear();
+    string key;
+    for (size_t i = 0; i <= conjugated.size() && i <= max_append_len_; ++i) {
+        if (i) {
+            key += conjugated[conjugated.size() - i];
+        }
+        auto it = rev_append2candidates_.find(key);
+        if (it == rev_append2candidates_.end()) {
+            continue;
+        }
+        candidates->insert(candidates->end(), it->second.begin(),
+                           it->second.end());
+    }
+    sort(candidates->begin(), candidates->end());
+}
+
+void Conjugator::BuildLexicon() {
+    uint64_t begin = Time::MicrosSinceEpoch();
+    lexicon_.Clear();
+    string form;
+    string lemma_back;
+    for (auto& it : lemma2derivx_) {
+        const string& lemma = it.first;
+        size_t derivx;
+        if (!suffix_tree_.Get(lemma, &derivx)) {
+            continue;
+        }
+        const ConjSpecDerivation& deriv = derivs_[derivx];
+        shared_ptr<ConjugationSpec> spec = make_shared<ConjugationSpec>();
+        deriv.Derive(lemma, spec.get());
+
+        // Only index the forms that reverse back to the lemma, as those are
+        // the ones reversing derivations would find.
+        uint16_t indexed_fields = 0;
+        for (unsigned i = 1; i < CONJ_SPEC_NUM_FIELDS; ++i) {
+            spec->GetField(i).AssignTo(&form);
+            if (deriv.GetTransform(i).Reverse(form, &lemma_back) &&
+                    lemma_back == lemma) {
+                indexed_fields =
+                    static_cast<uint16_t>(indexed_fields | (1u << i));
+            }
+        }
+        lexicon_.Add(static_cast<uint32_t>(derivx), spec, indexed_fields);
+    }
+    lexicon_.Index();
+    lexicon_build_micros_ = Time::MicrosSinceEpoch() - begin;
+
+    FullFormLexiconStats stats;
+    lexicon_.GetStats(&stats);
+    INFO("[Conjugator] Full-form lexicon: %zu lemmas, %zu forms, %zu "
+         "entries, %.1f MB, built in %.1f ms.\n", stats.num_lemmas,
+         stats.num_forms, stats.num_entries,
+         static_cast<double>(stats.num_bytes) / (1 << 20),
+         static_cast<double>(lexicon_build_micros_) / 1e3);
+}
+
+bool Conjugator::IsKnownLemma(const StringView& lemma) const {
+    uint32_t lemma_id;
+    return lexicon_.GetLemmaID(lemma, &lemma_id);
+}
+
 bool Conjugator::InitFromConfig(const ConjugationSpecConfig& config) {
-    CollectVerbDerivations(config.specs(), &derivs_, &lemma2derivx_);
+    CollectVerbDerivations(config, &derivs_, &lemma2derivx_);
     suffix_tree_.InitFromDict(lemma2derivx_);
+    BuildAppendIndex();
+    BuildLexicon();
+    spec_cache_.Init(DEFAULT_SPEC_CACHE_CAPACITY);
 
     // Precompute auxiliary verbs.
     // Relies on suffix tree existing.
-    CreateVerbSpec("be", &to_be_);
-    CreateVerbSpec("have", &to_have_);
+    if (!CreateVerbSpec("be", &to_be_) || !CreateVerbSpec("have", &to_have_) ||
+            !CreateVerbSpec("do", &to_do_)) {
+        ERROR("[Conjugator] Can't conjugate the auxiliary verbs.\n");
+        return false;
+    }
     to_have_.AnnotateAsAux();
-    CreateVerbSpec("do", &to_do_);
 
     return true;
 }
@@ -240,39 +369,122 @@ bool Conjugator::InitFromFile(const string& conjugations_f) {
     return InitFromConfig(config);
 }
 
-void Conjugator::CreateVerbSpec(
+void Conjugator::SetSpecCacheCapacity(size_t capacity) {
+    spec_cache_.Init(capacity);
+}
+
+void Conjugator::GetSpecCacheStats(ConjugationSpecCacheStats* stats) const {
+    spec_cache_.GetStats(stats);
+}
+
+void Conjugator::SetUseLexicon(bool use_lexicon) {
+    use_lexicon_ = use_lexicon;
+}
+
+void Conjugator::GetLexiconStats(FullFormLexiconStats* stats,
+                                 uint64_t* build_micros) const {
+    lexicon_.GetStats(stats);
+    *build_micros = lexicon_build_micros_;
+}
+
+bool Conjugator::CreateVerbSpec(
         const string& lemma, ConjugationSpec* spec) const {
+    static Histogram* latency =
+        Metrics::GetHistogram("conjugator.create_verb_spec_ns");
+    ScopedLatency timer(latency);
+
     // Handle the magic ints verb.
     if (lemma == "<ints>") {
         vector<string> nonpast = {"3", "4", "5", "6", "7", "8"};
         vector<string> past = {"9", "10", "11", "12", "13", "14"};
         spec->Init("0", "1", "2", nonpast, past);
-        return;
+        return true;
     }
 
     // Normal verb spec derivation.
     size_t deriv_index;
-    suffix_tree_.Get(lemma, &deriv_index);
-    ConjSpecDerivation deriv = derivs_[deriv_index];
-    deriv.Derive(lemma, spec);
+    if (!suffix_tree_.Get(lemma, &deriv_index)) {
+        return false;
+    }
+    derivs_[deriv_index].Derive(lemma, spec);
+    return true;
+}
+
+shared_ptr<const ConjugationSpec> Conjugator::GetVerbSpec(
+        const string& lemma) const {
+    uint32_t lemma_id;
+    if (use_lexicon_ && lexicon_.GetLemmaID(lemma, &lemma_id)) {
+        return lexicon_.GetSpec(lemma_id);
+    }
+
+    shared_ptr<const ConjugationSpec> spec = spec_cache_.Get(lemma);
+    if (spec) {
+        return spec;
+    }
+
+    // One allocation for the spec and its count.
+    shared_ptr<ConjugationSpec> derived = make_shared<ConjugationSpec>();
+    if (!CreateVerbSpec(lemma, derived.get())) {
+        return NULL;
+    }
+    spec = derived;
+    spec_cache_.Put(lemma, spec);
+    return spec;
 }
 
-void Conjugator::Conjugate(
+bool Conjugator::Conjugate(
         const string& lemma, unsigned field_index, string* conjugated) const {
     // This shortcut allows the don't conjugate trick.
     if (field_index == 0) {
         *conjugated = lemma;
+        return true;
     }
 
-    ConjugationSpec spec;
-    CreateVerbSpec(lemma, &spec);
-    *conjugated = spec.GetField(field_index);
+    uint32_t lemma_id;
+    if (use_lexicon_ && lexicon_.GetLemmaID(lemma, &lemma_id)) {
+        lexicon_.GetField(lemma_id, field_index).AssignTo(conjugated);
+        return true;
+    }
+
+    shared_ptr<const ConjugationSpec> spec = GetVerbSpec(lemma);
+    if (!spec) {
+        return false;
+    }
+    spec->GetField(field_index).AssignTo(conjugated);
+    return true;
 }
 
 // "bakes" -> [("bake", 5)].
 void Conjugator::IdentifyWord(
         const string& conjugated, bool is_picky_about_verbs,
         vector<LemmaAndIndex>* lemmas_idxs) const {
+    IdentifyWordScratch scratch;
+    IdentifyWord(conjugated, is_picky_about_verbs, &scratch, lemmas_idxs);
+}
+
+void Conjugator::IdentifyWord(
+        const string& conjugated, bool is_picky_about_verbs,
+        IdentifyWordScratch* scratch,
+        vector<LemmaAndIndex>* lemmas_idxs) const {
+    vector<LemmaViewAndIndex> views;
+    IdentifyWordViews(conjugated, is_picky_about_verbs, scratch, &views);
+    lemmas_idxs->clear();
+    for (auto& li : views) {
+        lemmas_idxs->emplace_back(LemmaAndIndex(li.lemma.ToString(),
+                                                li.index));
+    }
+}
+
+void Conjugator::IdentifyWordViews(
+        const string& conjugated, bool is_picky_about_verbs,
+        IdentifyWordScratch* scratch,
+        vector<LemmaViewAndIndex>* lemmas_idxs) const {
+    static Histogram* latency =
+        Metrics::GetHistogram("conjugator.identify_word_ns");
+    static Counter* num_lemmas =
+        Metrics::GetCounter("conjugator.identify_word.lemmas");
+    ScopedLatency timer(latency);
+
     lemmas_idxs->clear();
 
     // Aux is special.
@@ -280,21 +492,71 @@ void Conjugator::IdentifyWord(
         return;
     }
 
-    // For each derivation, reverse it to the proposed original lemma.
-    // If the suffix tree maps that lemma to the derivation we used, it is a
-    // hit.
-    for (unsigned i = 0; i < derivs_.size(); ++i) {
-        vector<LemmaAndIndex> proposed_lemmas_idxs;
-        derivs_[i].IdentifyWord(conjugated, &proposed_lemmas_idxs);
-        for (unsigned j = 0; j < proposed_lemmas_idxs.size(); ++j) {
-            string lemma = proposed_lemmas_idxs[j].lemma;
-            size_t deriv_idx = ~0ul;
-            suffix_tree_.Get(lemma, &deriv_idx);
-            if (deriv_idx == i) {
-                uint8_t shorter = static_cast<uint8_t>(deriv_idx);
-                lemmas_idxs->emplace_back(LemmaAndIndex(lemma, shorter));
-            }
+    // Known forms are looked up.  Being picky, only their known lemmas would
+    // be kept, and the lexicon has exactly those.  Anything else is derived.
+    const FullFormEntry* begin;
+    const FullFormEntry* end;
+    if (use_lexicon_ && is_picky_about_verbs &&
+            lexicon_.GetEntries(conjugated, &begin, &end)) {
+        for (const FullFormEntry* it = begin; it != end; ++it) {
+            lemmas_idxs->emplace_back(LemmaViewAndIndex(
+                lexicon_.GetField(it->lemma_id, 0), it->field_index));
         }
+    } else {
+        IdentifyByDerivation(conjugated, is_picky_about_verbs, scratch,
+                             lemmas_idxs);
+    }
+
+    // Try the conjugated word as a lemma itself.
+    if (!is_picky_about_verbs || IsKnownLemma(conjugated)) {
+        lemmas_idxs->emplace_back(LemmaViewAndIndex(conjugated, 0));
+    }
+
+    num_lemmas->Add(lemmas_idxs->size());
+}
+
+bool Conjugator::ReverseCandidate(const string& conjugated,
+                                  const DerivAndField& c,
+                                  string* lemma) const {
+    const ConjSpecDerivation& deriv = derivs_[c.derivx];
+    if (!deriv.GetTransform(c.field_index).Reverse(conjugated, lemma)) {
+        return false;
+    }
+    size_t deriv_idx;
+    return suffix_tree_.Get(*lemma, &deriv_idx) && deriv_idx == c.derivx;
+}
+
+void Conjugator::IdentifyByDerivation(
+        const string& conjugated, bool is_picky_about_verbs,
+        IdentifyWordScratch* scratch,
+        vector<LemmaViewAndIndex>* lemmas_idxs) const {
+    // For each derivation field that could have produced the word, reverse it
+    // to the proposed original lemma.  If the suffix tree maps that lemma to
+    // the derivation we used, it is a hit.  Only the hits are kept.
+    vector<DerivAndField>* candidates = &scratch->candidates;
+    GetCandidates(conjugated, candidates);
+    size_t num_hits = 0;
+    size_t num_bytes = 0;
+    for (size_t i = 0; i < candidates->size(); ++i) {
+        if (ReverseCandidate(conjugated, (*candidates)[i], &scratch->lemma)) {
+            (*candidates)[num_hits++] = (*candidates)[i];
+            num_bytes += scratch->lemma.size();
+        }
+    }
+    candidates->resize(num_hits);
+
+    // Then their lemmas are reversed again into one buffer, sized up front so
+    // that the views into it stay good.
+    string* derived = &scratch->derived_lemmas;
+    derived->clear();
+    derived->reserve(num_bytes);
+    for (auto& c : *candidates) {
+        ReverseCandidate(conjugated, c, &scratch->lemma);
+        size_t offset = derived->size();
+        *derived += scratch->lemma;
+        lemmas_idxs->emplace_back(LemmaViewAndIndex(
+            StringView(derived->data() + offset, scratch->lemma.size()),
+            c.field_index));
     }
 
     // Being picky about verbs: if we have some results that contain known
@@ -302,29 +564,24 @@ void Conjugator::IdentifyWord(
     if (is_picky_about_verbs) {
         bool has_known = false;
         for (unsigned i = 0; i < lemmas_idxs->size(); ++i) {
-            if (lemma2derivx_.find((*lemmas_idxs)[i].lemma) !=
-                lemma2derivx_.end()) {
+            if (IsKnownLemma((*lemmas_idxs)[i].lemma)) {
                 has_known = true;
                 break;
             }
         }
         if (has_known) {
-            vector<LemmaAndIndex> nu;
+            size_t num_kept = 0;
             for (unsigned i = 0; i < lemmas_idxs->size(); ++i) {
-                const string& lemma = (*lemmas_idxs)[i].lemma;
-                if (lemma2derivx_.find(lemma) != lemma2derivx_.end()) {
-                    nu.emplace_back((*lemmas_idxs)[i]);
+                if (IsKnownLemma((*lemmas_idxs)[i].lemma)) {
+                    swap((*lemmas_idxs)[num_kept], (*lemmas_idxs)[i]);
+                    ++num_kept;
                 }
             }
-            *lemmas_idxs = nu;
+            lemmas_idxs->erase(lemmas_idxs->begin() +
+                                   static_cast<ptrdiff_t>(num_kept),
+                               lemmas_idxs->end());
         }
     }
-
-    // Try the conjugated word as a lemma itself.
-    if (!is_picky_about_verbs ||
-            lemma2derivx_.find(conjugated) != lemma2derivx_.end()) {
-        lemmas_idxs->emplace_back(LemmaAndIndex(conjugated, 0));
-    }
 }
 
 void Conjugator::DumpToString(string* s) const {
@@ -2,15 +2,22 @@
 #define CC_VERB_INTERNAL_CONJUGATION_CONJUGATOR_H_
 
 #include <map>
+#include <memory>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include "cc/ds/generalizing_suffix_tree.h"
+#include "cc/ds/string_view.h"
 #include "cc/core/ling/verb/internal/conjugation/conjugation_spec.h"
+#include "cc/core/ling/verb/internal/conjugation/conjugation_spec_cache.h"
+#include "cc/core/ling/verb/internal/conjugation/full_form_lexicon.h"
 #include "cc/core/ling/verb/internal/conjugation/suffix_transform.h"
 
 using std::map;
+using std::shared_ptr;
 using std::string;
+using std::unordered_map;
 using std::vector;
 
 struct LemmaAndIndex {
@@ -19,6 +26,14 @@ struct LemmaAndIndex {
     LemmaAndIndex(const string& _lemma, uint8_t _index);
 };
 
+// The same, with the lemma a view into someone else's string (see
+// Conjugator::IdentifyWordViews()).
+struct LemmaViewAndIndex {
+    StringView lemma;
+    uint8_t index;
+    LemmaViewAndIndex(const StringView& _lemma, uint8_t _index);
+};
+
 typedef uint64_t Hash;
 
 // -----------------------------------------------------------------------------
@@ -34,12 +49,16 @@ class ConjSpecDerivation {
         map<string, SuffixTransform>* before_after2transform);
 
     // Get all the conjugations of a verb.
-    void Derive(const string& lemma, ConjugationSpec* spec);
+    void Derive(const string& lemma, ConjugationSpec* spec) const;
 
     // Given a conjugated word, return what it could be.
     void IdentifyWord(const string& conjugated,
                       vector<LemmaAndIndex>* lemmas_idxs) const;
 
+    // Field index (1-14, see ConjugationSpec) -> how it is derived from the
+    // lemma.
+    const SuffixTransform& GetTransform(unsigned field_index) const;
+
     Hash HashCode() const;
 
   private:
@@ -54,6 +73,27 @@ class ConjSpecDerivation {
 
 // -----------------------------------------------------------------------------
 
+// A derivation field that could have produced a given word.
+struct DerivAndField {
+    uint32_t derivx;
+    uint8_t field_index;
+
+    bool operator<(const DerivAndField& other) const;
+};
+
+// Scratch space for identifying words.  Keep one around and reuse it: once
+// its buffers have grown to fit, IdentifyWordViews() allocates nothing.
+struct IdentifyWordScratch {
+    // The (derivation, field) pairs that could have produced the word.
+    vector<DerivAndField> candidates;
+
+    // Each lemma as it is reversed out of the word.
+    string lemma;
+
+    // The derived lemmas found, back to back.
+    string derived_lemmas;
+};
+
 class Conjugator {
   public:
     const ConjugationSpec& to_be() const { return to_be_; }
@@ -64,27 +104,95 @@ class Conjugator {
 
     bool InitFromFile(const string& conjugations_f);
 
-    // lemma -> spec.
-    void CreateVerbSpec(const string& lemma, ConjugationSpec* spec) const;
+    // Bound the number of derived specs kept around (zero disables caching).
+    // Call before use, not while other threads are conjugating.
+    void SetSpecCacheCapacity(size_t capacity);
+
+    void GetSpecCacheStats(ConjugationSpecCacheStats* stats) const;
+
+    // Whether to look known lemmas and their forms up in the full-form
+    // lexicon (the default) instead of deriving them.  Call before use, not
+    // while other threads are conjugating.
+    void SetUseLexicon(bool use_lexicon);
+
+    void GetLexiconStats(FullFormLexiconStats* stats,
+                         uint64_t* build_micros) const;
 
-    // (lemma, index) -> conjugated.
-    void Conjugate(const string& lemma, unsigned field_index,
+    // lemma -> spec.  Returns false if the lemma can't be conjugated (no
+    // known lemma ends like it does).
+    bool CreateVerbSpec(const string& lemma, ConjugationSpec* spec) const;
+
+    // lemma -> spec, memoized.  Thread-safe.  Returns NULL if the lemma can't
+    // be conjugated.
+    shared_ptr<const ConjugationSpec> GetVerbSpec(const string& lemma) const;
+
+    // (lemma, index) -> conjugated.  Returns false if the lemma can't be
+    // conjugated (index 0 always can, as it's the lemma itself).
+    bool Conjugate(const string& lemma, unsigned field_index,
                    string* conjugated) const;
 
     // conjugated -> list of (lemma, index).
     void IdentifyWord(const string& conjugated, bool is_picky_about_verbs,
                       vector<LemmaAndIndex>* lemmas_idxs) const;
 
+    // Same, with the caller's scratch space.
+    void IdentifyWord(const string& conjugated, bool is_picky_about_verbs,
+                      IdentifyWordScratch* scratch,
+                      vector<LemmaAndIndex>* lemmas_idxs) const;
+
+    // Same, without copying the lemmas: each is a view into the lexicon, the
+    // conjugated word or the scratch space, good until either changes.
+    void IdentifyWordViews(const string& conjugated, bool is_picky_about_verbs,
+                           IdentifyWordScratch* scratch,
+                           vector<LemmaViewAndIndex>* lemmas_idxs) const;
+
     void DumpToString(string* s) const;
 
   private:
+    void BuildAppendIndex();
+
+    void BuildLexicon();
+
+    bool IsKnownLemma(const StringView& lemma) const;
+
+    // All the (derivation, field) pairs whose transforms append a suffix of
+    // the word, in derivation then field order.
+    void GetCandidates(const string& conjugated,
+                       vector<DerivAndField>* candidates) const;
+
+    // Reverse the candidate's transform out of the word.  Returns true if the
+    // suffix tree maps the lemma that gives back to the same derivation.
+    bool ReverseCandidate(const string& conjugated, const DerivAndField& c,
+                          string* lemma) const;
+
+    // IdentifyWordViews() the slow way, by reversing every derivation that
+    // could have produced the word (for words the lexicon doesn't have).
+    void IdentifyByDerivation(const string& conjugated,
+                              bool is_picky_about_verbs,
+                              IdentifyWordScratch* scratch,
+                              vector<LemmaViewAndIndex>* lemmas_idxs) const;
+
     // lemma -> index in derivs_.
     vector<ConjSpecDerivation> derivs_;
     map<string, size_t> lemma2derivx_;
 
+    // Reversed appended suffix -> the (derivation, field) pairs that append
+    // it.  Only those can be reversed out of a word ending in that suffix.
+    unordered_map<string, vector<DerivAndField> > rev_append2candidates_;
+    size_t max_append_len_;
+
     // Map verb lemmas by suffix to indexes that point to ConjSpecDerivations.
     GeneralizingSuffixTree<size_t> suffix_tree_;
 
+    // Every form of every known lemma, both ways.  Only unknown lemmas and
+    // words are derived.
+    FullFormLexicon lexicon_;
+    bool use_lexicon_ = true;
+    uint64_t lexicon_build_micros_ = 0;
+
+    // Recently derived lemma -> spec.
+    mutable ConjugationSpecCache spec_cache_;
+
     // Precomputed auxiliary verbs.
     // * to_be contracts in main and auxiliary verb forms the same way.
     // * to_have forms contractions differently as an auxiliary from a main verb
@@ -0,0 +1,203 @@
+#include "full_form_lexicon.h"
+
+#include <algorithm>
+#include <cstring>
+
+using std::min;
+using std::sort;
+
+#define EMPTY_SLOT (~0ull)
+
+void FullFormLexicon::Clear() {
+    specs_.clear();
+    derivxs_.clear();
+    indexed_fields_.clear();
+    lemma_slots_.clear();
+    form_slots_.clear();
+    form2entries_.clear();
+    entries_.clear();
+}
+
+void FullFormLexicon::Add(uint32_t derivx,
+                          const shared_ptr<const ConjugationSpec>& spec,
+                          uint16_t indexed_fields) {
+    specs_.emplace_back(spec);
+    derivxs_.emplace_back(derivx);
+    indexed_fields_.emplace_back(indexed_fields);
+}
+
+// -----------------------------------------------------------------------------
+// Tables.
+//
+// A slot is the word's hash's top half and the id, so most mismatches are
+// told apart without going to the word.
+
+namespace {
+
+// A power of two at least twice n, for a load factor of at most 1/2.
+size_t NumSlotsFor(size_t n) {
+    size_t num_slots = 16;
+    while (num_slots < n * 2) {
+        num_slots *= 2;
+    }
+    return num_slots;
+}
+
+}  // namespace
+
+template <typename GetWord>
+bool FullFormLexicon::FindID(const vector<uint64_t>& slots,
+                             const StringView& key, GetWord get_word,
+                             uint32_t* id) {
+    if (slots.empty()) {
+        return false;
+    }
+    uint64_t hash = StringViewHash()(key);
+    uint64_t tag = hash >> 32;
+    size_t mask = slots.size() - 1;
+    for (size_t x = hash & mask; slots[x] != EMPTY_SLOT; x = (x + 1) & mask) {
+        uint64_t slot = slots[x];
+        if (slot >> 32 != tag) {
+            continue;
+        }
+        uint32_t slot_id = static_cast<uint32_t>(slot);
+        if (get_word(slot_id) == key) {
+            *id = slot_id;
+            return true;
+        }
+    }
+    return false;
+}
+
+void FullFormLexicon::InsertID(vector<uint64_t>* slots, const StringView& key,
+                               uint32_t id) {
+    uint64_t hash = StringViewHash()(key);
+    size_t mask = slots->size() - 1;
+    size_t x = hash & mask;
+    while ((*slots)[x] != EMPTY_SLOT) {
+        x = (x + 1) & mask;
+    }
+    (*slots)[x] = (hash >> 32) << 32 | id;
+}
+
+// -----------------------------------------------------------------------------
+// Building.
+
+namespace {
+
+struct FormAndEntry {
+    StringView form;
+    uint32_t derivx;
+    FullFormEntry entry;
+
+    bool operator<(const FormAndEntry& other) const {
+        size_t z = min(form.size(), other.form.size());
+        int cmp = memcmp(form.data(), other.form.data(), z);
+        if (cmp || form.size() != other.form.size()) {
+            return cmp ? cmp < 0 : form.size() < other.form.size();
+        }
+        if (derivx != other.derivx) {
+            return derivx < other.derivx;
+        }
+        return entry.field_index < other.entry.field_index;
+    }
+};
+
+}  // namespace
+
+void FullFormLexicon::Index() {
+    lemma_slots_.assign(NumSlotsFor(specs_.size()), EMPTY_SLOT);
+    for (uint32_t i = 0; i < specs_.size(); ++i) {
+        InsertID(&lemma_slots_, specs_[i]->lemma(), i);
+    }
+
+    // Every (form, lemma, field), grouped by form, each group in the same
+    // order the Conjugator would find them by reversing derivations.
+    vector<FormAndEntry> all;
+    for (uint32_t i = 0; i < specs_.size(); ++i) {
+        // Every field but the lemma (which is never transformed).
+        for (unsigned j = 1; j < CONJ_SPEC_NUM_FIELDS; ++j) {
+            if (!(indexed_fields_[i] & (1u << j))) {
+                continue;
+            }
+            FormAndEntry x;
+            x.form = specs_[i]->GetField(j);
+            if (x.form.empty()) {
+                continue;
+            }
+            x.derivx = derivxs_[i];
+            x.entry.lemma_id = i;
+            x.entry.field_index = static_cast<uint8_t>(j);
+            all.emplace_back(x);
+        }
+    }
+    sort(all.begin(), all.end());
+
+    form2entries_.clear();
+    entries_.clear();
+    entries_.reserve(all.size());
+    for (size_t i = 0; i < all.size(); ++i) {
+        if (!i || all[i].form != all[i - 1].form) {
+            EntryRange range;
+            range.begin = static_cast<uint32_t>(entries_.size());
+            form2entries_.emplace_back(range);
+        }
+        entries_.emplace_back(all[i].entry);
+        form2entries_.back().end = static_cast<uint32_t>(entries_.size());
+    }
+    vector<EntryRange>(form2entries_).swap(form2entries_);
+
+    form_slots_.assign(NumSlotsFor(form2entries_.size()), EMPTY_SLOT);
+    for (uint32_t i = 0; i < form2entries_.size(); ++i) {
+        const FullFormEntry& first = entries_[form2entries_[i].begin];
+        InsertID(&form_slots_, GetField(first.lemma_id, first.field_index), i);
+    }
+
+    vector<uint32_t>().swap(derivxs_);
+    vector<uint16_t>().swap(indexed_fields_);
+}
+
+// -----------------------------------------------------------------------------
+// Lookups.
+
+bool FullFormLexicon::GetLemmaID(const StringView& lemma,
+                                 uint32_t* lemma_id) const {
+    return FindID(lemma_slots_, lemma, [this](uint32_t id) {
+        return specs_[id]->lemma();
+    }, lemma_id);
+}
+
+bool FullFormLexicon::GetEntries(const StringView& form,
+                                 const FullFormEntry** begin,
+                                 const FullFormEntry** end) const {
+    uint32_t form_id;
+    if (!FindID(form_slots_, form, [this](uint32_t id) {
+            const FullFormEntry& first = entries_[form2entries_[id].begin];
+            return GetField(first.lemma_id, first.field_index);
+        }, &form_id)) {
+        return false;
+    }
+    *begin = entries_.data() + form2entries_[form_id].begin;
+    *end = entries_.data() + form2entries_[form_id].end;
+    return true;
+}
+
+void FullFormLexicon::GetStats(FullFormLexiconStats* stats) const {
+    stats->num_lemmas = specs_.size();
+    stats->num_forms = form2entries_.size();
+    stats->num_entries = entries_.size();
+
+    size_t bytes = specs_.capacity() * sizeof(specs_[0]);
+    for (auto& spec : specs_) {
+        // The spec shares one allocation with its count (two words), and
+        // its words are in another.
+        bytes += sizeof(ConjugationSpec) + 2 * sizeof(void*);
+        StringView last = spec->GetField(CONJ_SPEC_NUM_FIELDS - 1);
+        bytes += static_cast<size_t>(last.end() - spec->lemma().begin()) + 1;
+    }
+    bytes += lemma_slots_.capacity() * sizeof(lemma_slots_[0]);
+    bytes += form_slots_.capacity() * sizeof(form_slots_[0]);
+    bytes += form2entries_.capacity() * sizeof(form2entries_[0]);
+    bytes += entries_.capacity() * sizeof(entries_[0]);
+    stats->num_bytes = bytes;
+}
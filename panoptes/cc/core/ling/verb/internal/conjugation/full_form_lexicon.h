@@ -0,0 +1,100 @@
+#ifndef CC_VERB_INTERNAL_CONJUGATION_FULL_FORM_LEXICON_H_
+#define CC_VERB_INTERNAL_CONJUGATION_FULL_FORM_LEXICON_H_
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "cc/ds/string_view.h"
+#include "cc/core/ling/verb/internal/conjugation/conjugation_spec.h"
+
+using std::shared_ptr;
+using std::string;
+using std::vector;
+
+// One known lemma's field that is spelled a given way.
+struct FullFormEntry {
+    uint32_t lemma_id;
+    uint8_t field_index;
+};
+
+struct FullFormLexiconStats {
+    size_t num_lemmas;
+    size_t num_forms;    // Distinct spellings.
+    size_t num_entries;  // (form, lemma, field) triples.
+    size_t num_bytes;    // Approximate.
+};
+
+// Every conjugation of every known verb, precomputed in both directions:
+// (lemma id, field) -> form, and form -> (lemma id, field) list.
+//
+// Built once by the Conjugator and then read-only, so lookups take no locks.
+// The words are only stored in the specs.  Both directions are open-addressing
+// tables of ids, which are keyed by looking the id's word up in its spec.
+class FullFormLexicon {
+  public:
+    size_t size() const { return specs_.size(); }
+
+    void Clear();
+
+    // Add a lemma's spec, along with the derivation that made it.  Only the
+    // fields set in the indexed_fields bitmask get reverse entries.  Lemmas
+    // must be distinct.
+    void Add(uint32_t derivx, const shared_ptr<const ConjugationSpec>& spec,
+             uint16_t indexed_fields);
+
+    // Build the lookup tables.  Call once every lemma is added.
+    void Index();
+
+    // lemma -> id.  Returns false if it is not a known lemma.
+    bool GetLemmaID(const StringView& lemma, uint32_t* lemma_id) const;
+
+    const shared_ptr<const ConjugationSpec>& GetSpec(uint32_t lemma_id) const {
+        return specs_[lemma_id];
+    }
+
+    StringView GetField(uint32_t lemma_id, unsigned field_index) const {
+        return specs_[lemma_id]->GetField(field_index);
+    }
+
+    // form -> the entries spelled that way, in derivation then field order.
+    // Returns false if no known lemma has that form.
+    bool GetEntries(const StringView& form, const FullFormEntry** begin,
+                    const FullFormEntry** end) const;
+
+    void GetStats(FullFormLexiconStats* stats) const;
+
+  private:
+    // Where a form's entries are in entries_.
+    struct EntryRange {
+        uint32_t begin;
+        uint32_t end;
+    };
+
+    // Find the id in the table whose word is the key.
+    template <typename GetWord>
+    static bool FindID(const vector<uint64_t>& slots, const StringView& key,
+                       GetWord get_word, uint32_t* id);
+
+    static void InsertID(vector<uint64_t>* slots, const StringView& key,
+                         uint32_t id);
+
+    // Lemma id -> spec.
+    vector<shared_ptr<const ConjugationSpec> > specs_;
+
+    // Lemma id -> the derivation that made it, and which fields to index.
+    // Only needed to build the entries, so dropped by Index().
+    vector<uint32_t> derivxs_;
+    vector<uint16_t> indexed_fields_;
+
+    // Lemma hash -> lemma id.
+    vector<uint64_t> lemma_slots_;
+
+    // Form hash -> form id, form id -> its run of entries.
+    vector<uint64_t> form_slots_;
+    vector<EntryRange> form2entries_;
+    vector<FullFormEntry> entries_;
+};
+
+#endif  // CC_VERB_INTERNAL_CONJUGATION_FULL_FORM_LEXICON_H_
@@ -48,37 +48,41 @@ bool SuffixTransform::Transform(const string& from, string* to) const {
     if (from.size() < truncate_.size()) {
         return false;
     }
-    string r = from.substr(0, from.size() - truncate_.size());
+    size_t keep = from.size() - truncate_.size();
+    if (repeat_ && !keep) {
+        return false;
+    }
+
+    // Built in place, reusing the output's buffer.
+    to->assign(from, 0, keep);
     if (repeat_) {
-        if (!r.size()) {
-            return false;
-        }
-        r += string(repeat_, r[r.size() - 1]);
+        to->append(repeat_, from[keep - 1]);
     }
-    r += append_;
-    *to = r;
+    *to += append_;
     return true;
 }
 
 bool SuffixTransform::Reverse(const string& after, string* before) const {
-    string r;
-    if (!append_.size()) {
-        r = after;
-    } else {
-        if (!String::EndsWith(after, append_)) {
-            return false;
-        }
-        r = after.substr(0, append_.size());
+    if (after.size() < append_.size() ||
+            after.compare(after.size() - append_.size(), string::npos,
+                          append_)) {
+        return false;
     }
+    size_t keep = after.size() - append_.size();
     if (repeat_) {
-        string suffix = string(repeat_, r[r.size() - 1]);
-        if (!r.size() || !String::EndsWith(r, suffix)) {
+        // The repeated characters must copy the last one kept.
+        if (keep <= repeat_) {
             return false;
         }
-        r.resize(r.size() - repeat_);
+        keep -= repeat_;
+        for (size_t i = 0; i < repeat_; ++i) {
+            if (after[keep + i] != after[keep - 1]) {
+                return false;
+            }
+        }
     }
-    r += truncate_;
-    *before = r;
+    before->assign(after, 0, keep);
+    *before += truncate_;
     return true;
 }
 
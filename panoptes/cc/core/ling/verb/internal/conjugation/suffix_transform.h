@@ -7,14 +7,18 @@ using std::string;
 
 class SuffixTransform {
   public:
+    const string& append() const { return append_; }
+
     void InitFromValues(const string& truncate, size_t repeat,
                         const string& append);
     void InitFromExample(const string& from, const string& to);
 
-    // Perform the operation on the string.  Returns false if impossible.
+    // Perform the operation on the string (to must be another string).  Returns
+    // false if impossible.
     bool Transform(const string& from, string* to) const;
 
-    // Reverse the operation on the string.  Returns false if impossible.
+    // Reverse the operation on the string (from must be another string).
+    // Returns false if impossible.
     bool Reverse(const string& to, string* from) const;
 
     string ToString() const;
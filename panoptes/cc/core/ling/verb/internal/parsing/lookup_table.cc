@@ -0,0 +1,516 @@
+#include "lookup_table.h"
+
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <string>
+
+#include "cc/base/combinatorics.h"
+#include "cc/base/logging.h"
+#include "cc/base/parallel.h"
+#include "cc/base/throol.h"
+#include "cc/format/json.h"
+#include "cc/core/ling/verb/verb_with_context.h"
+
+using std::atomic;
+using std::lock_guard;
+using std::min;
+using std::mutex;
+
+// -----------------------------------------------------------------------------
+
+void LookupTableGenerationRound::Init(
+        const vector<uint8_t>& global_num_options_per_field,
+        const map<FlatVWCField, vector<uint8_t> >& options_overrides,
+        const vector<LookupTableConstraint>& constraints) {
+    // Initialize to globals.
+    num_options_per_field_.resize(global_num_options_per_field.size());
+    for (auto i = 0u; i < global_num_options_per_field.size(); ++i) {
+        num_options_per_field_[i] = global_num_options_per_field[i];
+    }
+    option2global_option_.resize(global_num_options_per_field.size());
+
+    // Then set my overrides.
+    for (auto& it : options_overrides) {
+        FlatVWCField field = it.first;
+        const vector<uint8_t>& options = it.second;
+        num_options_per_field_[field] = static_cast<uint8_t>(options.size());
+        for (uint8_t i = 0; i < options.size(); ++i) {
+            const uint8_t& option_value = options[i];
+            option2global_option_[field][i] = option_value;
+        }
+    }
+
+    // Get the stride of each field.
+    field2stride_.resize(num_options_per_field_.size());
+    uint64_t stride = 1;
+    for (size_t i = 0; i < num_options_per_field_.size(); ++i) {
+        field2stride_[i] = stride;
+        stride *= static_cast<uint64_t>(num_options_per_field_[i]);
+    }
+
+    // Translate the constraints to my options, dropping the ones none of my
+    // tuples can match.
+    constraints_.clear();
+    for (auto& constraint : constraints) {
+        LocalConstraint local;
+        local.status = constraint.status;
+        local.lowest_field = ~0ul;
+        bool can_match = true;
+        for (auto& it : constraint.field2values) {
+            size_t field = it.first;
+            const vector<uint8_t>& values = it.second;
+            vector<bool> is_matches(num_options_per_field_[field], false);
+            bool any_match = false;
+            for (uint8_t i = 0; i < num_options_per_field_[field]; ++i) {
+                const map<uint8_t, uint8_t>& m = option2global_option_[field];
+                uint8_t value = m.size() ? m.find(i)->second : i;
+                for (auto& constraint_value : values) {
+                    if (value == constraint_value) {
+                        is_matches[i] = true;
+                        any_match = true;
+                    }
+                }
+            }
+            if (!any_match) {
+                can_match = false;
+                break;
+            }
+            local.lowest_field = min(local.lowest_field, field);
+            local.field_is_matches.emplace_back(field, is_matches);
+        }
+        if (can_match) {
+            constraints_.emplace_back(local);
+        }
+    }
+}
+
+bool LookupTableGenerationRound::GetPruned(
+        const vector<uint8_t>& selected_options, VerbSayStatus* status,
+        uint64_t* num_pruned) const {
+    // Of the constraints the tuple matches, take the one that covers the most
+    // tuples after it.
+    const LocalConstraint* best = NULL;
+    for (auto& constraint : constraints_) {
+        bool is_match = true;
+        for (auto& it : constraint.field_is_matches) {
+            if (!it.second[selected_options[it.first]]) {
+                is_match = false;
+                break;
+            }
+        }
+        if (is_match &&
+                (!best || best->lowest_field < constraint.lowest_field)) {
+            best = &constraint;
+        }
+    }
+    if (!best) {
+        return false;
+    }
+
+    // Skip to the next value of its least significant field.
+    uint64_t offset = 0;
+    for (size_t i = 0; i < best->lowest_field; ++i) {
+        offset += static_cast<uint64_t>(selected_options[i]) * field2stride_[i];
+    }
+    *status = best->status;
+    *num_pruned = field2stride_[best->lowest_field] - offset;
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+
+void LookupTableConfig::Init(
+        const vector<uint8_t>& global_num_options_per_field,
+        const vector<string>& lemmas, const vector<uint8_t>& is_pro_verbs) {
+    // Set.
+    global_num_options_per_field_ = global_num_options_per_field;
+    lemmas_ = lemmas;
+
+    // The checks VerbSayer::GetAllSayOptions() and the VerbConverter make
+    // before saying anything.
+    uint8_t unknown = throol(true, true).value();
+    vector<uint8_t> non_finites = {
+        VF_BARE_INF,
+        VF_TO_INF,
+        VF_GERUND,
+        VF_SUBJLESS_GERUND
+    };
+    vector<uint8_t> non_indicatives;
+    for (uint8_t i = 0; i < MF_NUM_FLAVORS; ++i) {
+        if (i != MF_INDICATIVE) {
+            non_indicatives.emplace_back(i);
+        }
+    }
+    constraints_ = {
+        {
+            VSS_ERR_HAS_UNSET_FIELDS,
+            {{FLAT_IS_CONTRARY, {unknown}}}
+        },
+        {
+            VSS_ERR_HAS_UNSET_FIELDS,
+            {{FLAT_CONTRACT_NOT, {unknown}}}
+        },
+        {
+            VSS_ERR_HAS_UNSET_FIELDS,
+            {{FLAT_SPLIT_INF, {unknown}}}
+        },
+        {
+            VSS_INVALID_RELATIVE_PRO_VERB_CONFLICT,
+            {{FLAT_IS_PRO_VERB, {true}}, {FLAT_REL_CONT, {RC_ZERO}}}
+        },
+        {
+            VSS_INVALID_CAN_ONLY_SPLIT_FINITE,
+            {{FLAT_VERB_FORM, non_finites}, {FLAT_IS_SPLIT, {true}}}
+        },
+        {
+            VSS_INVALID_IF_NON_FINITE_MODALITY_MUST_BE_INDICATIVE,
+            {{FLAT_VERB_FORM, non_finites}, {FLAT_FLAVOR, non_indicatives}}
+        },
+        {
+            VSS_INVALID_IF_NON_FINITE_MODALITY_MUST_BE_INDICATIVE,
+            {{FLAT_VERB_FORM, non_finites}, {FLAT_IS_COND, {true}}}
+        },
+        {
+            VSS_INVALID_REL_CLAUSES_CAN_ONLY_CONTAIN_FINITE,
+            {{FLAT_VERB_FORM, non_finites}, {FLAT_REL_CONT, {RC_ZERO, RC_WORD}}}
+        }
+    };
+
+    // Restrictions on finite verbs.
+    map<FlatVWCField, vector<uint8_t> > finite_overrides = {
+        {FLAT_VERB_FORM,   vector<uint8_t>({VF_FINITE})},
+        {FLAT_IS_PRO_VERB, is_pro_verbs}
+    };
+
+    LookupTableGenerationRound finites;
+    finites.Init(global_num_options_per_field, finite_overrides, constraints_);
+    rounds_.emplace_back(finites);
+
+    // Restrictions on non-finite verbs.
+    map<FlatVWCField, vector<uint8_t> > nonfinite_overrides = {
+        {
+            FLAT_FLAVOR,
+            vector<uint8_t>({
+                MF_INDICATIVE
+            })
+        },
+        {
+            FLAT_VERB_FORM,
+            vector<uint8_t>({
+                VF_BARE_INF,
+                VF_TO_INF,
+                VF_GERUND,
+                VF_SUBJLESS_GERUND
+            })
+        },
+        {
+            FLAT_IS_SPLIT,
+            vector<uint8_t>({
+                false
+            }),
+        },
+        {
+            FLAT_IS_PRO_VERB,
+            is_pro_verbs
+        }
+    };
+
+    LookupTableGenerationRound nonfinites;
+    nonfinites.Init(global_num_options_per_field, nonfinite_overrides,
+                    constraints_);
+    rounds_.emplace_back(nonfinites);
+}
+
+// -----------------------------------------------------------------------------
+
+// How many option combinations each generation task says.
+#define TUPLES_PER_CHUNK (1u << 16)
+
+// How often to log progress, in option combinations.
+#define LOG_PROGRESS_EVERY 1000000u
+
+namespace {
+
+// A contiguous range of one round's option combinations.
+struct GenerationChunk {
+    size_t round_index;
+    uint64_t begin;
+    uint64_t end_excl;
+};
+
+// What a chunk rendered to.
+struct GenerationChunkResult {
+    map<string, vector<vector<uint8_t> > > key2tuples;
+    map<VerbSayStatus, size_t> err2count;
+    map<VerbSayStatus, size_t> err2num_pruned;
+};
+
+// Create the flat vector, translating options if necessary.
+void TranslateOptions(const LookupTableGenerationRound& round,
+                      const vector<uint8_t>& selected_options,
+                      vector<uint8_t>* translated_selected_options) {
+    translated_selected_options->clear();
+    for (size_t j = 0; j < selected_options.size(); ++j) {
+        const map<uint8_t, uint8_t>& m = round.option2global_option()[j];
+        uint8_t value;
+        if (m.size()) {
+            value = m.find(selected_options[j])->second;
+        } else {
+            value = selected_options[j];
+        }
+        translated_selected_options->emplace_back(value);
+    }
+}
+
+// Count tuples as done, logging as we pass each milestone.
+void AddProgress(uint64_t num_tuples, atomic<uint64_t>* count,
+                 mutex* log_mutex) {
+    uint64_t begin = count->fetch_add(num_tuples);
+    uint64_t milestone = (begin + LOG_PROGRESS_EVERY - 1) /
+        LOG_PROGRESS_EVERY * LOG_PROGRESS_EVERY;
+    if (milestone < begin + num_tuples) {
+        lock_guard<mutex> lock(*log_mutex);
+        DEBUG("LookupTable: Trying all VWC possibilities, currently at "
+              "#%llu\n", static_cast<unsigned long long>(milestone));
+    }
+}
+
+void GenerateChunk(const LookupTableConfig& cfg, const VerbSayer* sayer,
+                   const GenerationChunk& chunk, atomic<uint64_t>* count,
+                   mutex* log_mutex, GenerationChunkResult* result) {
+    const LookupTableGenerationRound& round = cfg.rounds()[chunk.round_index];
+    vector<uint8_t> selected_options;
+    Combinatorics::NthChooseOneFromEach(
+        round.num_options_per_field(), chunk.begin, &selected_options);
+    vector<uint8_t> translated_selected_options;
+    vector<VerbSayResult> rr;
+    string key;
+    uint64_t i = chunk.begin;
+    while (i < chunk.end_excl) {
+        // Skip over tuples VerbSayer would reject out of hand.
+        VerbSayStatus err;
+        uint64_t num_pruned;
+        if (round.GetPruned(selected_options, &err, &num_pruned)) {
+            num_pruned = min(num_pruned, chunk.end_excl - i);
+            result->err2num_pruned[err] += num_pruned;
+            AddProgress(num_pruned, count, log_mutex);
+            i += num_pruned;
+            if (i < chunk.end_excl) {
+                Combinatorics::NthChooseOneFromEach(
+                    round.num_options_per_field(), i, &selected_options);
+            }
+            continue;
+        }
+
+        AddProgress(1, count, log_mutex);
+
+        TranslateOptions(round, selected_options, &translated_selected_options);
+
+        // Create the VerbWithContext from the flat vector.
+        VerbWithContext vwc;
+        vwc.InitFromVector(translated_selected_options, cfg.lemmas());
+
+        // Render the verb to words.
+        rr.clear();
+        err = sayer->GetAllSayOptions(vwc, ~0ul, &rr);
+        ++result->err2count[err];
+
+        // Save each rendering.
+        for (auto& r : rr) {
+            key.clear();
+            r.ToKey(&key);
+            result->key2tuples[key].emplace_back(translated_selected_options);
+        }
+
+        ++i;
+        if (i < chunk.end_excl) {
+            Combinatorics::NextChooseOneFromEach(
+                round.num_options_per_field(), &selected_options);
+        }
+    }
+}
+
+}  // namespace
+
+void LookupTable::SayAll(
+        const LookupTableConfig& cfg, const VerbSayer* sayer,
+        size_t num_threads,
+        map<string, vector<vector<uint8_t> > >* key2tuples) {
+    // Cut each round into chunks.
+    vector<GenerationChunk> chunks;
+    for (size_t i = 0; i < cfg.rounds().size(); ++i) {
+        uint64_t num_tuples = Combinatorics::CountChooseOneFromEach(
+            cfg.rounds()[i].num_options_per_field());
+        for (uint64_t begin = 0; begin < num_tuples;
+             begin += TUPLES_PER_CHUNK) {
+            GenerationChunk chunk;
+            chunk.round_index = i;
+            chunk.begin = begin;
+            chunk.end_excl = min(begin + TUPLES_PER_CHUNK, num_tuples);
+            chunks.emplace_back(chunk);
+        }
+    }
+
+    // Say each chunk into its own results.
+    vector<GenerationChunkResult> results(chunks.size());
+    atomic<uint64_t> count(0);
+    mutex log_mutex;
+    Parallel::For(chunks.size(), num_threads, [&](size_t i) {
+        GenerateChunk(cfg, sayer, chunks[i], &count, &log_mutex, &results[i]);
+    });
+
+    // Merge them in order, so each key's tuples are in the order a single
+    // thread would have produced them.
+    key2tuples->clear();
+    map<VerbSayStatus, size_t> err2count;
+    map<VerbSayStatus, size_t> err2num_pruned;
+    for (auto& result : results) {
+        for (auto& it : result.key2tuples) {
+            vector<vector<uint8_t> >& tuples = (*key2tuples)[it.first];
+            if (tuples.empty()) {
+                tuples.swap(it.second);
+            } else {
+                tuples.insert(tuples.end(), it.second.begin(), it.second.end());
+            }
+        }
+        for (auto& it : result.err2count) {
+            err2count[it.first] += it.second;
+        }
+        for (auto& it : result.err2num_pruned) {
+            err2num_pruned[it.first] += it.second;
+        }
+        result = GenerationChunkResult();
+    }
+
+    // Logging.
+    INFO("Lookup table generation results:");
+    size_t num_visited = 0;
+    for (auto& it : err2count) {
+        INFO("vss %u:\t%zu\n", it.first, it.second);
+        num_visited += it.second;
+    }
+    size_t num_pruned = 0;
+    for (auto& it : err2num_pruned) {
+        INFO("vss %u:\t%zu pruned\n", it.first, it.second);
+        num_pruned += it.second;
+    }
+    INFO("Said %zu tuples, pruned %zu.\n", num_visited, num_pruned);
+}
+
+void LookupTable::Generate(const LookupTableConfig& cfg,
+                           const VerbSayer* sayer, size_t num_threads) {
+    map<string, vector<vector<uint8_t> > > key2tuples;
+    SayAll(cfg, sayer, num_threads, &key2tuples);
+
+    DEBUG("LookupTable: About to collapse the generated VWC tuples.\n");
+
+    // For each unique rendered verb words, collapse the tuples and pack them.
+    vector<vector<vector<uint8_t> >*> key_tuples;
+    for (auto& it : key2tuples) {
+        key_tuples.emplace_back(&it.second);
+    }
+    vector<vector<PackedVWC> > key_vwcs(key_tuples.size());
+    Parallel::For(key_tuples.size(), num_threads, [&](size_t i) {
+        vector<vector<uint8_t> >& tuples = *key_tuples[i];
+        Combinatorics::CollapseToWildcards(
+                cfg.global_num_options_per_field(), &tuples);
+        for (auto& tuple : tuples) {
+            PackedVWC vwc;
+            vwc.InitFromArray(&tuple[0], tuple[FLAT_LEMMA]);
+            key_vwcs[i].emplace_back(vwc);
+        }
+    });
+
+    map<string, vector<PackedVWC> > key2vwcs;
+    size_t key_index = 0;
+    for (auto& it : key2tuples) {
+        key2vwcs[it.first].swap(key_vwcs[key_index++]);
+    }
+
+    vwcs_.Init(cfg.lemmas(), &key2vwcs);
+}
+
+// -----------------------------------------------------------------------------
+
+void LookupTableVWCs::Init(const vector<string>& lemmas,
+                           map<string, vector<PackedVWC> >* key2vwcs) {
+    lemmas_.Clear();
+    for (auto& lemma : lemmas) {
+        lemmas_.Intern(lemma);
+    }
+    key2vwcs_.clear();
+    key2vwcs_.swap(*key2vwcs);
+}
+
+void LookupTableVWCs::ToJSON(json::Writer* w) const {
+    w->BeginObject();
+    VerbWithContext vwc;
+    for (auto& it : key2vwcs_) {
+        w->WriteKey(it.first);
+        w->BeginArray();
+        for (auto& packed : it.second) {
+            packed.ToVWC(lemmas()[packed.lemma_id], &vwc);
+            vwc.ToJSON(w);
+        }
+        w->EndArray();
+    }
+    w->EndObject();
+}
+
+bool LookupTableVWCs::FromJSON(const json::Value& v) {
+    lemmas_.Clear();
+    key2vwcs_.clear();
+    if (!v.IsObject()) {
+        return false;
+    }
+
+    string key;
+    VerbWithContext vwc;
+    for (json::Value k = v.FirstChild(); k.IsValid(); k = k.Next().Next()) {
+        json::Value vwcs = k.Next();
+        if (!k.GetString(&key) || !vwcs.IsArray()) {
+            return false;
+        }
+
+        vector<PackedVWC>* packeds = &key2vwcs_[key];
+        for (json::Value x = vwcs.FirstChild(); x.IsValid(); x = x.Next()) {
+            if (!vwc.FromJSON(x)) {
+                return false;
+            }
+            packeds->resize(packeds->size() + 1);
+            packeds->back().InitFromVWC(vwc,
+                                        lemmas_.Intern(vwc.verb().lemma()));
+        }
+    }
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+
+struct LookupTable::JSONFields {
+    typedef json::Schema<LookupTable,
+        JSON_FIELD(LookupTable, vwcs_)
+    > Schema;
+
+    static const Schema& Get() {
+        static const Schema schema("key2vwcs");
+        return schema;
+    }
+};
+
+void LookupTable::ToJSON(string* s) const {
+    json::ToJSON(*this, s);
+}
+
+void LookupTable::ToJSON(json::Writer* w) const {
+    JSONFields::Get().Write(*this, w);
+}
+
+bool LookupTable::FromJSON(const string& s) {
+    return json::FromJSON(s, this);
+}
+
+bool LookupTable::FromJSON(const json::Value& v) {
+    return JSONFields::Get().Read(v, this);
+}
@@ -0,0 +1,167 @@
+#ifndef CC_CORE_LING_VERB_INTERNAL_PARSING_LOOKUP_TABLE_H_
+#define CC_CORE_LING_VERB_INTERNAL_PARSING_LOOKUP_TABLE_H_
+
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "cc/ds/string_interner.h"
+#include "cc/core/ling/verb/internal/parsing/flat_vwc_fields.h"
+#include "cc/core/ling/verb/internal/saying/verb_sayer.h"
+#include "cc/core/ling/verb/packed_vwc.h"
+#include "cc/core/ling/verb/verb_with_context.h"
+#include "cc/format/json_tape.h"
+#include "cc/format/json_writer.h"
+
+using std::map;
+using std::pair;
+using std::string;
+using std::vector;
+
+// A combination of field values that VerbSayer rejects before saying anything:
+// a tuple matches if each listed field has one of the listed (global) values.
+// Matching tuples are skipped instead of being said.
+struct LookupTableConstraint {
+    VerbSayStatus status;
+    map<FlatVWCField, vector<uint8_t> > field2values;
+};
+
+// The configuration options to generate a lot of verbs.
+//
+// We generate verbs in multiple rounds (finites + non-finites) because various
+// combinations of options aren't valid and we shouldn't bother trying them.
+class LookupTableGenerationRound {
+  public:
+    const vector<uint8_t>& num_options_per_field() const {
+        return num_options_per_field_;
+    }
+    const vector<map<uint8_t, uint8_t> >& option2global_option() const {
+        return option2global_option_;
+    }
+
+    void Init(const vector<uint8_t>& global_num_options_per_field,
+              const map<FlatVWCField, vector<uint8_t> >& option_overrides,
+              const vector<LookupTableConstraint>& constraints);
+
+    // Whether the selected options (in my terms) match a constraint.  If so,
+    // also returns how many tuples from here on in NextChooseOneFromEach()
+    // order are known to match it too, so they can be skipped at once.
+    bool GetPruned(const vector<uint8_t>& selected_options,
+                   VerbSayStatus* status, uint64_t* num_pruned) const;
+
+  private:
+    // A constraint in terms of my options.
+    struct LocalConstraint {
+        VerbSayStatus status;
+
+        // The least significant field it involves.  Every tuple that agrees on
+        // it and the fields above it matches as well.
+        size_t lowest_field;
+
+        // Field -> whether each of my options for it is one of the values.
+        vector<pair<size_t, vector<bool> > > field_is_matches;
+    };
+
+
+    // My local idea of how many options each field has.
+    vector<uint8_t> num_options_per_field_;
+
+    // For each field, map my option selections to where they are the global
+    // list of options for that field (like enum values, bools, etc), if they
+    // differ from global.
+    vector<map<uint8_t, uint8_t> > option2global_option_;
+
+    // The constraints that can match any of my tuples.
+    vector<LocalConstraint> constraints_;
+
+    // For each field, how many tuples NextChooseOneFromEach() steps through
+    // between its values (the product of the less significant fields' option
+    // counts).
+    vector<uint64_t> field2stride_;
+};
+
+// The configuration for generating a single lookup table.
+class LookupTableConfig {
+  public:
+    const vector<uint8_t>& global_num_options_per_field() const {
+            return global_num_options_per_field_;
+    }
+    const vector<string>& lemmas() const { return lemmas_; }
+    const vector<LookupTableConstraint>& constraints() const {
+        return constraints_;
+    }
+    const vector<LookupTableGenerationRound>& rounds() const { return rounds_; }
+
+    void Init(const vector<uint8_t>& global_num_options_per_field,
+              const vector<string>& lemmas,
+              const vector<uint8_t>& is_pro_verbs);
+
+  private:
+    // How many options per field.
+    vector<uint8_t> global_num_options_per_field_;
+
+    // We have to save the lemmas.  All others are zero-based integers (enums,
+    // bools, and throols).
+    vector<string> lemmas_;
+
+    // Combinations VerbSayer would reject early, which the rounds skip.
+    vector<LookupTableConstraint> constraints_;
+
+    // A list of table generation options, the outputs from which are combined.
+    vector<LookupTableGenerationRound> rounds_;
+};
+
+// What each key of a lookup table parses to, as PackedVWCs, with the lemmas
+// their ids index.  As JSON, a map of keys to lists of VerbWithContexts.
+class LookupTableVWCs {
+  public:
+    const vector<string>& lemmas() const { return lemmas_.strings(); }
+    const map<string, vector<PackedVWC> >& key2vwcs() const {
+        return key2vwcs_;
+    }
+
+    // Takes the contents of key2vwcs.
+    void Init(const vector<string>& lemmas,
+              map<string, vector<PackedVWC> >* key2vwcs);
+
+    void ToJSON(json::Writer* w) const;
+    bool FromJSON(const json::Value& v);
+
+  private:
+    StringInterner lemmas_;
+    map<string, vector<PackedVWC> > key2vwcs_;
+};
+
+class LookupTable {
+  public:
+    const vector<string>& lemmas() const { return vwcs_.lemmas(); }
+    const map<string, vector<PackedVWC> >& key2vwcs() const {
+        return vwcs_.key2vwcs();
+    }
+
+    // Say every combination of options in the config and collapse the results,
+    // spread across num_threads threads.  The table is the same for any number
+    // of threads.
+    void Generate(const LookupTableConfig& cfg, const VerbSayer* sayer,
+                  size_t num_threads);
+
+    // The first half of Generate(): say everything, grouping the option tuples
+    // by what they rendered to.
+    static void SayAll(const LookupTableConfig& cfg, const VerbSayer* sayer,
+                       size_t num_threads,
+                       map<string, vector<vector<uint8_t> > >* key2tuples);
+
+    void ToJSON(string* s) const;
+    void ToJSON(json::Writer* w) const;
+    bool FromJSON(const string& s);
+    bool FromJSON(const json::Value& v);
+
+  private:
+    // JSON layout (see the .cc).
+    struct JSONFields;
+
+    LookupTableVWCs vwcs_;
+};
+
+#endif  // CC_CORE_LING_VERB_INTERNAL_PARSING_LOOKUP_TABLE_H_
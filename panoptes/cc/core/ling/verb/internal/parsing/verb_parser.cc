@@ -1,265 +1,21 @@
 #include "verb_parser.h"
 
+#include <cstdio>
 #include <string>
 
-#include "cc/base/combinatorics.h"
 #include "cc/base/file.h"
 #include "cc/base/logging.h"
-#include "cc/base/warning.h"
+#include "cc/base/metrics.h"
+#include "cc/base/parallel.h"
 #include "cc/format/json.h"
 #include "cc/core/ling/verb/verb_with_context.h"
 
 // -----------------------------------------------------------------------------
 
-void LookupTableGenerationRound::Init(
-        const vector<uint8_t>& global_num_options_per_field,
-        const map<FlatVWCField, vector<uint8_t> >& options_overrides) {
-    // Initialize to globals.
-    num_options_per_field_.resize(global_num_options_per_field.size());
-    for (auto i = 0u; i < global_num_options_per_field.size(); ++i) {
-        num_options_per_field_[i] = global_num_options_per_field[i];
-    }
-    option2global_option_.resize(global_num_options_per_field.size());
-
-    // Then set my overrides.
-    for (auto& it : options_overrides) {
-        FlatVWCField field = it.first;
-        const vector<uint8_t>& options = it.second;
-        num_options_per_field_[field] = static_cast<uint8_t>(options.size());
-        for (uint8_t i = 0; i < options.size(); ++i) {
-            const uint8_t& option_value = options[i];
-            option2global_option_[field][i] = option_value;
-        }
-    }
-}
-
-// -----------------------------------------------------------------------------
-
-void LookupTableConfig::Init(
-        const vector<uint8_t>& global_num_options_per_field,
-        const vector<string>& lemmas, const vector<uint8_t>& is_pro_verbs) {
-    // Set.
-    global_num_options_per_field_ = global_num_options_per_field;
-    lemmas_ = lemmas;
-
-    // Restrictions on finite verbs.
-    map<FlatVWCField, vector<uint8_t> > finite_overrides = {
-        {FLAT_VERB_FORM,   vector<uint8_t>({VF_FINITE})},
-        {FLAT_IS_PRO_VERB, is_pro_verbs}
-    };
-
-    LookupTableGenerationRound finites;
-    finites.Init(global_num_options_per_field, finite_overrides);
-    rounds_.emplace_back(finites);
-
-    // Restrictions on non-finite verbs.
-    map<FlatVWCField, vector<uint8_t> > nonfinite_overrides = {
-        {
-            FLAT_FLAVOR,
-            vector<uint8_t>({
-                MF_INDICATIVE
-            })
-        },
-        {
-            FLAT_VERB_FORM,
-            vector<uint8_t>({
-                VF_BARE_INF,
-                VF_TO_INF,
-                VF_GERUND,
-                VF_SUBJLESS_GERUND
-            })
-        },
-        {
-            FLAT_IS_SPLIT,
-            vector<uint8_t>({
-                false
-            }),
-        },
-        {
-            FLAT_IS_PRO_VERB,
-            is_pro_verbs
-        }
-    };
-
-    LookupTableGenerationRound nonfinites;
-    nonfinites.Init(global_num_options_per_field, nonfinite_overrides);
-    rounds_.emplace_back(nonfinites);
-}
-
-// -----------------------------------------------------------------------------
-
-void LookupTable::Generate(
-        const LookupTableConfig& cfg, const VerbSayer* sayer) {
-    map<string, vector<vector<uint8_t> > > key2tuples;
-    map<VerbSayStatus, size_t> err2count;
-    unsigned count = 0;
-    for (size_t i = 0; i < cfg.rounds().size(); ++i) {
-        const LookupTableGenerationRound& round = cfg.rounds()[i];
-        vector<uint8_t> selected_options;
-        while (Combinatorics::NextChooseOneFromEach(
-                round.num_options_per_field(), &selected_options)) {
-            // Logging.
-            if (count % 1000000 == 0) {
-                DEBUG("LookupTable: Trying all VWC possibilities, currently at "
-                      "#%u\n", count);
-            }
-
-            // Create the flat vector, translating options if necessary.
-            vector<uint8_t> translated_selected_options;
-            for (size_t j = 0; j < selected_options.size(); ++j) {
-                const map<uint8_t, uint8_t>& m = \
-                    round.option2global_option()[j];
-                uint8_t value;
-                if (m.size()) {
-                    value = m.find(selected_options[j])->second;
-                } else {
-                    value = selected_options[j];
-                }
-                translated_selected_options.emplace_back(value);
-            }
-
-            // Create the VerbWithContext from the flat vector.
-            VerbWithContext vwc;
-            vwc.InitFromVector(translated_selected_options, cfg.lemmas());
-
-            // Render the verb to words.
-            vector<VerbSayResult> rr;
-            VerbSayStatus err = sayer->GetAllSayOptions(vwc, ~0ul, &rr);
-            ++err2count[err];
-
-            // Save each rendering.
-            for (auto& r : rr) {
-                string key;
-                r.ToKey(&key);
-                key2tuples[key].emplace_back(translated_selected_options);
-            }
-            ++count;
-        }
-    }
-
-    DEBUG("LookupTable: About to collapse the generated VWC tuples.\n");
-
-    // For each unique rendered verb words,
-    key2vwcs_.clear();
-    for (auto& it : key2tuples) {
-        const string& key = it.first;
-        vector<vector<uint8_t> >& tuples = it.second;
-
-        // Collapse the tuples.
-        Combinatorics::CollapseToWildcards(
-                cfg.global_num_options_per_field(), &tuples);
-
-        // Convert flat tuples to VerbWithContexts.
-        for (auto& tuple : tuples) {
-            VerbWithContext vwc;
-            vwc.InitFromVector(tuple, cfg.lemmas());
-            key2vwcs_[key].emplace_back(vwc);
-        }
-    }
-
-    // Logging.
-    INFO("Lookup table generation results:");
-    for (auto& it : err2count) {
-        INFO("vss %u:\t%zu\n", it.first, it.second);
-    }
-
-    map<size_t, vector<string> > count2keys;
-    for (auto& it : key2vwcs_) {
-        const string& key = it.first;
-        size_t vwc_count = it.second.size();
-        count2keys[vwc_count].emplace_back(key);
-    }
-
-/*
-    for (auto& it : count2keys) {
-        size_t vwc_count = it.first;
-        for (auto& s : it.second) {
-            DEBUG("* %zu\t%s\n", vwc_count, s.c_str());
-        }
-    }
-*/
-}
-
-void LookupTable::ToJSON(string* s) const {
-    map<string, string> key2vwcs;
-    for (auto& it : key2vwcs_) {
-        const string& key = it.first;
-        const vector<VerbWithContext>& vwcs = it.second;
-
-        vector<string> v;
-        for (size_t i = 0; i < vwcs.size(); ++i) {
-            string tmp;
-            vwcs[i].ToJSON(&tmp);
-            v.emplace_back(tmp);
-        }
-
-        string vwcs_s;
-        json::VectorToJSON(v, json::OBJECT, &vwcs_s);
-
-        key2vwcs[key] = vwcs_s;
-    }
-
-    string key2vwcs_s;
-    json::MapToJSON(key2vwcs, json::OBJECT, &key2vwcs_s);
-
-    json::ToJSON(s,
-        json::OBJECT, "key2vwcs", key2vwcs_s
-    );
-}
-
-bool LookupTable::FromJSON(const string& s) {
-    string key2vwcs_s;
-    if (!json::FromJSON(s,
-            json::OBJECT, "key2vwcs", &key2vwcs_s
-    )) {
-        return false;
-    }
-
-    map<string, string> key2obj;
-    if (!json::MapFromJSON(key2vwcs_s, json::OBJECT, &key2obj)) {
-        return false;
-    }
-
-    key2vwcs_.clear();
-    for (auto& it : key2obj) {
-        const string& key = it.first;
-        const string& obj_s = it.second;
-
-        vector<string> vwcs_ss;
-        if (!json::VectorFromJSON(obj_s, json::OBJECT, &vwcs_ss)) {
-            return false;
-        }
-
-        for (size_t i = 0; i < vwcs_ss.size(); ++i) {
-            VerbWithContext vwc;
-            if (!vwc.FromJSON(vwcs_ss[i])) {
-                return false;
-            }
-            key2vwcs_[key].emplace_back(vwc);
-        }
-    }
-
-    return true;
-}
-
-void LookupTable::AppendMatches(
-        const string& key, vector<VerbWithContext>* rr) const {
-    auto it = key2vwcs_.find(key);
-    if (it == key2vwcs_.end()) {
-        return;
-    }
-
-    for (size_t i = 0; i < it->second.size(); ++i) {
-        rr->emplace_back(it->second[i]);
-    }
-}
-
-// -----------------------------------------------------------------------------
-
 #define U8(a) static_cast<uint8_t>(a)
 
-void VerbParser::GenerateConfig(const VerbSayer* sayer) {
-    vector<uint8_t> global_num_options_per_field = {
+const vector<uint8_t>& VerbParser::NumOptionsPerField() {
+    static const vector<uint8_t> num_options_per_field = {
         U8(1),                    //  0 string vwc.verb().lemma()
         U8(2),                    //  1 bool vwc.verb().polarity().tf()
         U8(3),                    //  2 throol vwc.verb().polarity().is_contrary()
@@ -278,7 +34,15 @@ void VerbParser::GenerateConfig(const VerbSayer* sayer) {
         U8(3),                    // 15 throol vwc.split_inf()
         U8(SH_NUM_SBJ_HANDLINGS)  // 16 SubjunctiveHandling vwc.sbj_handling()
     };
+    return num_options_per_field;
+}
 
+#undef U8
+
+void VerbParser::GenerateTables(const VerbSayer* sayer, Tables* tables) {
+    const vector<uint8_t>& global_num_options_per_field = NumOptionsPerField();
+
+    size_t num_threads = Parallel::DefaultNumThreads();
     LookupTableConfig cfg;
     vector<string> lemmas;
     vector<uint8_t> is_pro_verbs;
@@ -286,35 +50,59 @@ void VerbParser::GenerateConfig(const VerbSayer* sayer) {
     lemmas = vector<string>({"be"});
     is_pro_verbs = vector<uint8_t>({false, true});
     cfg.Init(global_num_options_per_field, lemmas, is_pro_verbs);
-    to_be_.Generate(cfg, sayer);
+    tables->to_be.Generate(cfg, sayer, num_threads);
 
     lemmas = vector<string>({"see"});
     is_pro_verbs = vector<uint8_t>({true});
     cfg.Init(global_num_options_per_field, lemmas, is_pro_verbs);
-    pro_verbs_.Generate(cfg, sayer);
+    tables->pro_verbs.Generate(cfg, sayer, num_threads);
 
     lemmas = vector<string>({"<ints>"});
     is_pro_verbs = vector<uint8_t>({false});
     cfg.Init(global_num_options_per_field, lemmas, is_pro_verbs);
-    fir_.Generate(cfg, sayer);
+    tables->fir.Generate(cfg, sayer, num_threads);
 }
 
-#undef U8
-
 static void DelemmatizeVerb(const VerbSayResult& vsr, VerbSayResult* r) {
     r->pre_words = vsr.pre_words;
     r->main_words = vsr.main_words;
     r->main_words[r->main_words.size() - 1].clear();
 }
 
-bool VerbParser::Init(
-        const Conjugator* conjugator, const string& verb_parse_f,
+bool VerbParser::BuildSnapshot(const Tables& tables, string* bytes) {
+    set<string> deverbed_keys;
+    for (auto& it : tables.fir.key2vwcs()) {
+        VerbSayResult vsr;
+        if (!vsr.FromKey(it.first)) {
+            return false;
+        }
+        VerbSayResult dvsr;
+        DelemmatizeVerb(vsr, &dvsr);
+        string dkey;
+        dvsr.ToKey(&dkey);
+        deverbed_keys.insert(dkey);
+    }
+
+    return VerbParserSnapshot::Build(tables.to_be, tables.pro_verbs, tables.fir,
+                                     deverbed_keys, bytes);
+}
+
+bool VerbParser::InitFromSnapshotFile(
+        const string& snapshot_f, const string& verb_parse_f,
         const VerbSayer* sayer_or_null) {
-    assert(conjugator);
-    conjugator_ = conjugator;
+    if (VerbParserSnapshot::IsSnapshotFile(snapshot_f)) {
+        INFO("[VerbParser] Snapshot [%s] exists, about to map it.\n",
+             snapshot_f.c_str());
 
-    FILE* f = fopen(verb_parse_f.c_str(), "rb");
-    if (f) {
+        if (snapshot_.InitFromFile(snapshot_f)) {
+            return true;
+        }
+        WARN("[VerbParser] Could not load snapshot [%s], rebuilding it.\n",
+             snapshot_f.c_str());
+    }
+
+    Tables tables;
+    if (File::IsFile(verb_parse_f)) {
         INFO("[VerbParser] Config file [%s] exists, about to load.\n",
              verb_parse_f.c_str());
 
@@ -326,7 +114,7 @@ bool VerbParser::Init(
 
         INFO("LookupTable] Parsing from JSON (%zu bytes).\n", s.size());
 
-        if (!FromJSON(s)) {
+        if (!tables.FromJSON(s)) {
             ERROR("JSON parsing failed.\n");
             return false;
         }
@@ -335,74 +123,103 @@ bool VerbParser::Init(
              "regenerate (should take about a minute).\n",
              verb_parse_f.c_str());
         assert(sayer_or_null);
-        GenerateConfig(sayer_or_null);
-        string s;
-        ToJSON(&s);
-        assert(File::StringToFile(s, verb_parse_f));
-    }
+        GenerateTables(sayer_or_null, &tables);
 
-    INFO("[VerbParser] Loaded %zu 'to be' VWCs, %zu pro-verb VWCs, and %zu "
-         "generic field index-replacing VWCs.\n", to_be_.key2vwcs().size(),
-         pro_verbs_.key2vwcs().size(), fir_.key2vwcs().size());
+        if (!tables.ToJSONFile(verb_parse_f)) {
+            WARN("[VerbParser] Could not save config file [%s].\n",
+                 verb_parse_f.c_str());
+        }
+    }
 
-    deverbed_keys_set_.clear();
-    for (auto& it : fir_.key2vwcs()) {
-        const string& key = it.first;
-        VerbSayResult vsr;
-        assert(vsr.FromKey(key));
-        UNUSED(key);  // Clang doesn't see code inside asserts.
-        VerbSayResult dvsr;
-        DelemmatizeVerb(vsr, &dvsr);
-        string dkey;
-        dvsr.ToKey(&dkey);
-        deverbed_keys_set_.insert(dkey);
+    string bytes;
+    if (!BuildSnapshot(tables, &bytes)) {
+        ERROR("Snapshotting the tables failed.\n");
+        return false;
     }
 
+    // Map it back in, same as on later runs.
+    if (!File::StringToFile(bytes, snapshot_f) ||
+            !snapshot_.InitFromFile(snapshot_f)) {
+        WARN("[VerbParser] Could not save snapshot [%s], keeping it in "
+             "memory.\n", snapshot_f.c_str());
+        if (!snapshot_.InitFromBytes(bytes)) {
+            return false;
+        }
+    }
     return true;
 }
 
-void VerbParser::ToJSON(string* s) const {
-    string be_s;
-    to_be_.ToJSON(&be_s);
+bool VerbParser::Init(
+        const Conjugator* conjugator, const string& verb_parse_f,
+        const VerbSayer* sayer_or_null) {
+    assert(conjugator);
+    conjugator_ = conjugator;
+
+    if (VerbParserSnapshot::IsSnapshotFile(verb_parse_f)) {
+        INFO("[VerbParser] Snapshot [%s] exists, about to map it.\n",
+             verb_parse_f.c_str());
 
-    string pro_verb_s;
-    pro_verbs_.ToJSON(&pro_verb_s);
+        if (!snapshot_.InitFromFile(verb_parse_f)) {
+            ERROR("Could not load snapshot.\n");
+            return false;
+        }
+    } else if (!InitFromSnapshotFile(verb_parse_f + VERB_PARSER_SNAPSHOT_EXT,
+                                     verb_parse_f, sayer_or_null)) {
+        return false;
+    }
 
-    string fir_s;
-    fir_.ToJSON(&fir_s);
+    INFO("[VerbParser] Loaded %zu 'to be' keys, %zu pro-verb keys, and %zu "
+         "generic field index-replacing keys.\n",
+         snapshot_.table(STI_TO_BE).num_keys(),
+         snapshot_.table(STI_PRO_VERBS).num_keys(),
+         snapshot_.table(STI_FIR).num_keys());
 
-    json::ToJSON(s,
-        json::OBJECT, "to_be",     be_s,
-        json::OBJECT, "pro_verbs", pro_verb_s,
-        json::OBJECT, "fir",       fir_s
-    );
+    return true;
 }
 
-bool VerbParser::FromJSON(const string& s) {
-    string be_s;
-    string pro_verb_s;
-    string fir_s;
-    if (!json::FromJSON(s,
-        json::OBJECT, "to_be",     &be_s,
-        json::OBJECT, "pro_verbs", &pro_verb_s,
-        json::OBJECT, "fir",       &fir_s
-    )) {
-        return false;
-    }
+struct VerbParser::Tables::JSONFields {
+    typedef json::Schema<Tables,
+        JSON_FIELD(Tables, to_be),
+        JSON_FIELD(Tables, pro_verbs),
+        JSON_FIELD(Tables, fir)
+    > Schema;
 
-    if (!to_be_.FromJSON(be_s)) {
-        return false;
+    static const Schema& Get() {
+        static const Schema schema("to_be", "pro_verbs", "fir");
+        return schema;
     }
+};
+
+void VerbParser::Tables::ToJSON(string* s) const {
+    json::ToJSON(*this, s);
+}
+
+void VerbParser::Tables::ToJSON(json::Writer* w) const {
+    JSONFields::Get().Write(*this, w);
+}
 
-    if (!pro_verbs_.FromJSON(pro_verb_s)) {
+bool VerbParser::Tables::FromJSON(const string& s) {
+    return json::FromJSON(s, this);
+}
+
+bool VerbParser::Tables::FromJSON(const json::Value& v) {
+    return JSONFields::Get().Read(v, this);
+}
+
+bool VerbParser::Tables::ToJSONFile(const string& file_name) const {
+    FILE* f = fopen(file_name.c_str(), "wb");
+    if (!f) {
         return false;
     }
 
-    if (!fir_.FromJSON(fir_s)) {
-        return false;
+    bool ok;
+    {
+        json::Writer w(f);
+        ToJSON(&w);
+        ok = w.Flush();
     }
 
-    return true;
+    return !fclose(f) && ok;
 }
 
 static bool IsLastWordOk(const string& s) {
@@ -419,12 +236,59 @@ static bool IsLastWordOk(const string& s) {
     return true;
 }
 
-void VerbParser::AppendFirMatches(
-        const VerbSayResult& vsr, vector<VerbWithContext>* vwcs) const {
+bool VerbParser::AppendWordId(const string& word,
+                              vector<uint32_t>* key) const {
+    uint32_t id;
+    if (!snapshot_.FindWord(word, &id)) {
+        return false;
+    }
+    key->emplace_back(id);
+    return true;
+}
+
+bool VerbParser::AppendWordIds(const vector<string>& words, size_t num_words,
+                               vector<uint32_t>* key) const {
+    // No words is keyed as one empty word, same as the string keys.
+    if (!words.size()) {
+        return AppendWordId("", key);
+    }
+
+    for (size_t i = 0; i < num_words; ++i) {
+        if (!AppendWordId(words[i], key)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool VerbParser::GetKey(const VerbSayResult& vsr, size_t num_main_words,
+                        vector<uint32_t>* key) const {
+    key->clear();
+    size_t num_pre_words = vsr.pre_words.size() ? vsr.pre_words.size() : 1;
+    key->emplace_back(static_cast<uint32_t>(num_pre_words));
+    return AppendWordIds(vsr.pre_words, vsr.pre_words.size(), key) &&
+           AppendWordIds(vsr.main_words, num_main_words, key);
+}
+
+size_t VerbParser::AppendMatches(
+        SnapshotTableID table_id, VerbParseArena* arena) const {
+    const SnapshotTable& table = snapshot_.table(table_id);
+    size_t num_matches = table.AppendMatches(arena->key, &arena->verbs);
+    for (size_t i = arena->verbs.size() - num_matches;
+         i < arena->verbs.size(); ++i) {
+        PackedVWC* verb = &arena->verbs[i];
+        verb->lemma_id =
+            arena->lemmas.Intern(table.lemmas()[verb->lemma_id]);
+    }
+    return num_matches;
+}
+
+size_t VerbParser::AppendFirMatches(
+        const VerbSayResult& vsr, VerbParseArena* arena) const {
     // It must have words to the right of the subject.  If not, it could be a
     // pro-verb or an instance of "to be", but not this.
     if (!vsr.main_words.size()) {
-        return;
+        return 0;
     }
 
     // Lemma-specific conjugated word must be verified to look like a verb, as
@@ -432,54 +296,94 @@ void VerbParser::AppendFirMatches(
     // others.
     const string& last = vsr.main_words[vsr.main_words.size() - 1];
     if (!IsLastWordOk(last)) {
-        return;
+        return 0;
     }
 
-    // The lemma-agnostic rest of the verb must be known.
-    VerbSayResult deverbed;
-    DelemmatizeVerb(vsr, &deverbed);
-    string deverbed_key;
-    deverbed.ToKey(&deverbed_key);
-    if (deverbed_keys_set_.find(deverbed_key) == deverbed_keys_set_.end()) {
-        return;
+    // The lemma-agnostic rest of the verb (with the last word blanked out) must
+    // be known.
+    vector<uint32_t>* key = &arena->key;
+    if (!GetKey(vsr, vsr.main_words.size() - 1, key) ||
+            !AppendWordId("", key) ||
+            !snapshot_.table(STI_DEVERBED_KEYS).Contains(*key)) {
+        return 0;
     }
 
     // Decode what the lemma-specific word means.
-    vector<LemmaAndIndex> lemmas_indexes;
-    conjugator_->IdentifyWord(last, true, &lemmas_indexes);
+    conjugator_->IdentifyWordViews(last, true, &arena->identify_scratch,
+                                   &arena->lemmas_indexes);
 
     // For each decoding,
-    for (auto& li : lemmas_indexes) {
-          // Look up the field index-replacing form in the table.
-        deverbed.main_words[deverbed.main_words.size() - 1] =
-                std::to_string(li.index);
-        string key;
-        deverbed.ToKey(&key);
-        vector<VerbWithContext> sub_vwcs;
-        fir_.AppendMatches(key, &sub_vwcs);
-
-        // Put our decoded lemma into the results found.
-        for (auto& vwc : sub_vwcs) {
-            vwc.set_lemma(li.lemma);
-            vwcs->emplace_back(vwc);
+    size_t num_verbs = arena->verbs.size();
+    char index_s[24];
+    for (auto& li : arena->lemmas_indexes) {
+        // Look up the field index-replacing form in the table.
+        snprintf(index_s, sizeof(index_s), "%u",
+                 static_cast<unsigned>(li.index));
+        if (!snapshot_.FindWord(index_s, &key->back())) {
+            continue;
+        }
+        size_t num_matches = snapshot_.table(STI_FIR).AppendMatches(
+            *key, &arena->verbs);
+        if (!num_matches) {
+            continue;
+        }
+
+        // Put our decoded lemma into the results found.  It is copied into
+        // the arena's reused string first, as interning looks up by string.
+        li.lemma.AssignTo(&arena->scratch_lemma);
+        uint32_t lemma_id = arena->lemmas.Intern(arena->scratch_lemma);
+        for (size_t i = arena->verbs.size() - num_matches;
+             i < arena->verbs.size(); ++i) {
+            arena->verbs[i].lemma_id = lemma_id;
         }
     }
+    return arena->verbs.size() - num_verbs;
 }
 
-void VerbParser::Parse(
-        const VerbSayResult& vsr, vector<VerbWithContext>* vwcs) const {
-    vwcs->clear();
+void VerbParser::ParseOne(
+        const VerbSayResult& vsr, VerbParseArena* arena) const {
+    static Histogram* latency = Metrics::GetHistogram("verb_parser.parse_ns");
+    static Counter* to_be_hits = Metrics::GetCounter("verb_parser.hits.to_be");
+    static Counter* pro_verb_hits =
+        Metrics::GetCounter("verb_parser.hits.pro_verbs");
+    static Counter* fir_hits = Metrics::GetCounter("verb_parser.hits.fir");
+    static Counter* misses = Metrics::GetCounter("verb_parser.misses");
+    ScopedLatency timer(latency);
+
+    size_t num_verbs = arena->verbs.size();
+    if (GetKey(vsr, vsr.main_words.size(), &arena->key)) {
+        to_be_hits->Add(AppendMatches(STI_TO_BE, arena));
+
+        pro_verb_hits->Add(AppendMatches(STI_PRO_VERBS, arena));
+    }
 
-    string key;
-    vsr.ToKey(&key);
+    fir_hits->Add(AppendFirMatches(vsr, arena));
 
-    DEBUG("[VerbParser::Parse] key = [%s].\n", key.c_str());
+    if (arena->verbs.size() == num_verbs) {
+        misses->Add();
+    }
+}
 
-    to_be_.AppendMatches(key, vwcs);
+void VerbParser::ParseBatch(const VerbSayResult* vsrs, size_t num_vsrs,
+                            VerbParseArena* arena) const {
+    arena->Clear();
+    for (size_t i = 0; i < num_vsrs; ++i) {
+        arena->offsets.emplace_back(arena->verbs.size());
+        ParseOne(vsrs[i], arena);
+    }
+    arena->offsets.emplace_back(arena->verbs.size());
+}
 
-    pro_verbs_.AppendMatches(key, vwcs);
+void VerbParser::Parse(
+        const VerbSayResult& vsr, vector<VerbWithContext>* vwcs) const {
+    VerbParseArena arena;
+    ParseBatch(&vsr, 1, &arena);
 
-    AppendFirMatches(vsr, vwcs);
+    vwcs->clear();
+    vwcs->resize(arena.verbs.size());
+    for (size_t i = 0; i < arena.verbs.size(); ++i) {
+        arena.GetVerbWithContext(i, &(*vwcs)[i]);
+    }
 }
 
 // -----------------------------------------------------------------------------
@@ -1,114 +1,107 @@
 #ifndef CC_CORE_LING_VERB_INTERNAL_PARSING_VERB_PARSER_H_
 #define CC_CORE_LING_VERB_INTERNAL_PARSING_VERB_PARSER_H_
 
+#include <cstdint>
 #include <map>
 #include <string>
 #include <vector>
 
 #include "cc/core/ling/verb/internal/parsing/flat_vwc_fields.h"
+#include "cc/core/ling/verb/internal/parsing/lookup_table.h"
+#include "cc/core/ling/verb/internal/parsing/verb_parser_snapshot.h"
 #include "cc/core/ling/verb/internal/saying/verb_sayer.h"
+#include "cc/core/ling/verb/verb_parse_arena.h"
 #include "cc/core/ling/verb/verb_with_context.h"
 
 using std::map;
 using std::string;
 using std::vector;
 
-// The configuration options to generate a lot of verbs.
-//
-// We generate verbs in multiple rounds (finites + non-finites) because various
-// combinations of options aren't valid and we shouldn't bother trying them.
-class LookupTableGenerationRound {
+class VerbParser {
   public:
-    const vector<uint8_t>& num_options_per_field() const {
-        return num_options_per_field_;
-    }
-    const vector<map<uint8_t, uint8_t> >& option2global_option() const {
-        return option2global_option_;
-    }
+    // Maps verb_parses_f if it is a snapshot.  Otherwise maps the snapshot
+    // beside it (verb_parses_f + VERB_PARSER_SNAPSHOT_EXT), first building
+    // that from verb_parses_f as JSON.  If there is no such file, generates
+    // the tables using the sayer and saves them there as JSON first.  Delete
+    // the snapshot after editing the JSON.
+    bool Init(const Conjugator* c, const string& verb_parses_f,
+              const VerbSayer* sayer);
 
-    void Init(const vector<uint8_t>& global_num_options_per_field,
-              const map<FlatVWCField, vector<uint8_t> >& option_overrides);
+    void Parse(const VerbSayResult& vsr, vector<VerbWithContext>* vwcs) const;
 
-  private:
-    // My local idea of how many options each field has.
-    vector<uint8_t> num_options_per_field_;
+    // Parse each input into the arena, replacing its previous results.
+    void ParseBatch(const VerbSayResult* vsrs, size_t num_vsrs,
+                    VerbParseArena* arena) const;
 
-    // For each field, map my option selections to where they are the global
-    // list of options for that field (like enum values, bools, etc), if they
-    // differ from global.
-    vector<map<uint8_t, uint8_t> > option2global_option_;
-};
+    // The lookup tables as generated (or loaded from JSON), before they are
+    // turned into a snapshot.
+    struct Tables {
+        // "To be" is a weird verb.
+        LookupTable to_be;
 
-// The configuration for generating a single lookup table.
-class LookupTableConfig {
-  public:
-    const vector<uint8_t>& global_num_options_per_field() const {
-            return global_num_options_per_field_;
-    }
-    const vector<string>& lemmas() const { return lemmas_; }
-    const vector<LookupTableGenerationRound>& rounds() const { return rounds_; }
+        // Pro-verb lookup table.
+        LookupTable pro_verbs;
 
-    void Init(const vector<uint8_t>& global_num_options_per_field,
-              const vector<string>& lemmas,
-              const vector<uint8_t>& is_pro_verbs);
+        // Field index-replacing table.
+        LookupTable fir;
 
-  private:
-    // How many options per field.
-    vector<uint8_t> global_num_options_per_field_;
+        // JSON layout (see the .cc).
+        struct JSONFields;
 
-    // We have to save the lemmas.  All others are zero-based integers (enums,
-    // bools, and throols).
-    vector<string> lemmas_;
+        void ToJSON(string* s) const;
+        void ToJSON(json::Writer* w) const;
+        bool FromJSON(const string& s);
+        bool FromJSON(const json::Value& v);
 
-    // A list of table generation options, the outputs from which are combined.
-    vector<LookupTableGenerationRound> rounds_;
-};
-
-class LookupTable {
-  public:
-    const map<string, vector<VerbWithContext> >& key2vwcs() const {
-        return key2vwcs_;
-    }
+        // Stream the tables to a JSON file (loadable as verb_parse_f) without
+        // building the document in memory.
+        bool ToJSONFile(const string& file_name) const;
+    };
 
-    void Generate(const LookupTableConfig& cfg, const VerbSayer* sayer);
+    // How many values each flat field (see flat_vwc_fields.h) can take, as
+    // the tables are generated.
+    static const vector<uint8_t>& NumOptionsPerField();
 
-    void ToJSON(string* s) const;
-    bool FromJSON(const string& s);
+    static void GenerateTables(const VerbSayer* sayer, Tables* tables);
 
-    void AppendMatches(const string& key, vector<VerbWithContext>* rr) const;
+    // Serialize the tables, plus the fir keys with their lemma-specific word
+    // blanked out, as a snapshot.
+    static bool BuildSnapshot(const Tables& tables, string* bytes);
 
   private:
-    map<string, vector<VerbWithContext> > key2vwcs_;
-};
+    // Map snapshot_f, building and saving it first if it won't load.
+    bool InitFromSnapshotFile(const string& snapshot_f,
+                              const string& verb_parse_f,
+                              const VerbSayer* sayer_or_null);
 
-class VerbParser {
-  public:
-    bool Init(const Conjugator* c, const string& verb_parses_f,
-              const VerbSayer* sayer);
+    // Append the word's id to the key.  Returns false if no key has the word.
+    bool AppendWordId(const string& word, vector<uint32_t>* key) const;
 
-    void ToJSON(string* s) const;
-    bool FromJSON(const string& s);
+    // Append the ids of the first num_words words.
+    bool AppendWordIds(const vector<string>& words, size_t num_words,
+                       vector<uint32_t>* key) const;
 
-    void Parse(const VerbSayResult& vsr, vector<VerbWithContext>* vwcs) const;
+    // Get the word id key of the pre-words and the first num_main_words main
+    // words.  Returns false if some word isn't in any key.
+    bool GetKey(const VerbSayResult& vsr, size_t num_main_words,
+                vector<uint32_t>* key) const;
 
-  private:
-    void GenerateConfig(const VerbSayer* sayer);
-
-    void AppendFirMatches(
-        const VerbSayResult& vsr, vector<VerbWithContext>* vwcs) const;
+    // Append a table's matches, with their lemmas interned in the arena.
+    // Returns how many.
+    size_t AppendMatches(SnapshotTableID table_id,
+                         VerbParseArena* arena) const;
 
-    const Conjugator* conjugator_;
+    size_t AppendFirMatches(const VerbSayResult& vsr,
+                            VerbParseArena* arena) const;
 
-    set<string> deverbed_keys_set_;
+    // Append the parses of one input to the arena's verbs.
+    void ParseOne(const VerbSayResult& vsr, VerbParseArena* arena) const;
 
-    // "To be" is a weird verb.
-    LookupTable to_be_;
-
-    // Pro-verb lookup table.
-    LookupTable pro_verbs_;
+    const Conjugator* conjugator_;
 
-    // Field index-replacing table.
-    LookupTable fir_;
+    // The tables, plus the set of fir keys with the lemma-specific word
+    // blanked out.
+    VerbParserSnapshot snapshot_;
 };
 
 #endif  // CC_CORE_LING_VERB_INTERNAL_PARSING_VERB_PARSER_H_
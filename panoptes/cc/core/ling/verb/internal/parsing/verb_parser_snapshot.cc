@@ -0,0 +1,468 @@
+#include "verb_parser_snapshot.h"
+
+#include <cassert>
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "cc/base/logging.h"
+#include "cc/base/string.h"
+#include "cc/ds/string_interner.h"
+#include "cc/ds/string_view.h"
+
+using std::map;
+using std::string;
+using std::vector;
+
+#define BYTE_ORDER_MARK 0x01020304u
+
+#define EMPTY_SLOT (~0u)
+
+namespace {
+
+// FNV-1a over the ids.
+uint64_t HashKey(const uint32_t* ids, size_t num_ids) {
+    uint64_t h = 14695981039346656037ull;
+    for (size_t i = 0; i < num_ids; ++i) {
+        h ^= ids[i];
+        h *= 1099511628211ull;
+    }
+    return h;
+}
+
+uint64_t HashWord(const StringView& word) {
+    return StringViewHash()(word);
+}
+
+}  // namespace
+
+// -----------------------------------------------------------------------------
+// Writing.
+
+namespace {
+
+void Align(string* s) {
+    s->resize((s->size() + 7) & ~7ul, '\0');
+}
+
+template <typename T>
+uint64_t Append(const T* p, size_t count, string* s) {
+    Align(s);
+    uint64_t offset = s->size();
+    s->append(reinterpret_cast<const char*>(p), count * sizeof(T));
+    return offset;
+}
+
+void AppendStrings(const vector<string>& ss, uint64_t* offsets_at,
+                   uint64_t* blob_at, string* s) {
+    vector<uint32_t> offsets;
+    string blob;
+    for (auto& it : ss) {
+        offsets.emplace_back(static_cast<uint32_t>(blob.size()));
+        blob += it;
+    }
+    offsets.emplace_back(static_cast<uint32_t>(blob.size()));
+    assert(blob.size() <= ~0u);
+
+    *offsets_at = Append(&offsets[0], offsets.size(), s);
+    *blob_at = Append(blob.data(), blob.size(), s);
+}
+
+// Hash slots for items [0, count), keeping the table at most half full.
+template <typename GetHash>
+void MakeSlots(size_t count, GetHash get_hash, vector<uint32_t>* slots) {
+    size_t num_slots = 1;
+    while (num_slots < count * 2) {
+        num_slots *= 2;
+    }
+    slots->assign(num_slots, EMPTY_SLOT);
+    for (size_t i = 0; i < count; ++i) {
+        size_t x = get_hash(i) & (num_slots - 1);
+        while ((*slots)[x] != EMPTY_SLOT) {
+            x = (x + 1) & (num_slots - 1);
+        }
+        (*slots)[x] = static_cast<uint32_t>(i);
+    }
+}
+
+// "pre:words|main:words" -> word ids.
+bool KeyToIds(const string& key, StringInterner* words, vector<uint32_t>* ids) {
+    vector<string> pieces;
+    String::Split(key, '|', &pieces);
+    if (pieces.size() != 2) {
+        return false;
+    }
+
+    vector<string> pre_words;
+    String::Split(pieces[0], ':', &pre_words);
+    vector<string> main_words;
+    String::Split(pieces[1], ':', &main_words);
+
+    ids->clear();
+    ids->emplace_back(static_cast<uint32_t>(pre_words.size()));
+    for (auto& word : pre_words) {
+        ids->emplace_back(words->Intern(word));
+    }
+    for (auto& word : main_words) {
+        ids->emplace_back(words->Intern(word));
+    }
+    return true;
+}
+
+bool AppendTable(const vector<string>& lemmas,
+                 const map<string, vector<PackedVWC> >& key2vwcs,
+                 StringInterner* words, uint64_t* table_offset, string* s) {
+    vector<uint32_t> key_offsets;
+    vector<uint32_t> key_ids;
+    vector<uint32_t> vwc_offsets;
+    vector<PackedVWC> vwcs;
+    vector<uint32_t> ids;
+    for (auto& it : key2vwcs) {
+        if (!KeyToIds(it.first, words, &ids)) {
+            return false;
+        }
+        key_offsets.emplace_back(static_cast<uint32_t>(key_ids.size()));
+        key_ids.insert(key_ids.end(), ids.begin(), ids.end());
+        vwc_offsets.emplace_back(static_cast<uint32_t>(vwcs.size()));
+        vwcs.insert(vwcs.end(), it.second.begin(), it.second.end());
+    }
+    size_t num_keys = key_offsets.size();
+    key_offsets.emplace_back(static_cast<uint32_t>(key_ids.size()));
+    vwc_offsets.emplace_back(static_cast<uint32_t>(vwcs.size()));
+
+    vector<uint32_t> slots;
+    MakeSlots(num_keys, [&](size_t i) {
+        return HashKey(&key_ids[key_offsets[i]],
+                       key_offsets[i + 1] - key_offsets[i]);
+    }, &slots);
+
+    // Write a placeholder header, then the arrays, then fill in the header.
+    SnapshotTableHeader h;
+    memset(&h, 0, sizeof(h));
+    *table_offset = Append(&h, 1, s);
+    h.num_keys = static_cast<uint32_t>(num_keys);
+    h.num_lemmas = static_cast<uint32_t>(lemmas.size());
+    h.num_slots = static_cast<uint32_t>(slots.size());
+    h.key_offsets = Append(&key_offsets[0], key_offsets.size(), s);
+    h.key_ids = Append(key_ids.data(), key_ids.size(), s);
+    h.slots = Append(&slots[0], slots.size(), s);
+    h.vwc_offsets = Append(&vwc_offsets[0], vwc_offsets.size(), s);
+    h.vwcs = Append(vwcs.data(), vwcs.size(), s);
+    AppendStrings(lemmas, &h.lemma_offsets, &h.lemma_blob, s);
+    memcpy(&(*s)[*table_offset], &h, sizeof(h));
+    return true;
+}
+
+}  // namespace
+
+bool VerbParserSnapshot::Build(
+        const LookupTable& to_be, const LookupTable& pro_verbs,
+        const LookupTable& fir, const set<string>& deverbed_keys,
+        string* bytes) {
+    map<string, vector<PackedVWC> > deverbed_key2nothing;
+    for (auto& key : deverbed_keys) {
+        deverbed_key2nothing[key];
+    }
+
+    const LookupTable* lookup_tables[STI_NUM_TABLES] = {
+        &to_be,
+        &pro_verbs,
+        &fir,
+        NULL
+    };
+
+    SnapshotHeader h;
+    memset(&h, 0, sizeof(h));
+    memcpy(h.magic, VERB_PARSER_SNAPSHOT_MAGIC, sizeof(h.magic));
+    h.version = VERB_PARSER_SNAPSHOT_VERSION;
+    h.byte_order_mark = BYTE_ORDER_MARK;
+
+    bytes->clear();
+    Append(&h, 1, bytes);
+    StringInterner words;
+    vector<string> no_lemmas;
+    for (size_t i = 0; i < STI_NUM_TABLES; ++i) {
+        const LookupTable* t = lookup_tables[i];
+        if (!AppendTable(t ? t->lemmas() : no_lemmas,
+                         t ? t->key2vwcs() : deverbed_key2nothing, &words,
+                         &h.tables[i], bytes)) {
+            return false;
+        }
+    }
+    h.num_words = static_cast<uint32_t>(words.size());
+    AppendStrings(words.strings(), &h.word_offsets, &h.word_blob, bytes);
+    vector<uint32_t> word_slots;
+    MakeSlots(words.size(), [&](size_t i) {
+        return HashWord(words.strings()[i]);
+    }, &word_slots);
+    h.num_word_slots = static_cast<uint32_t>(word_slots.size());
+    h.word_slots = Append(&word_slots[0], word_slots.size(), bytes);
+    Align(bytes);
+    h.size = bytes->size();
+    memcpy(&(*bytes)[0], &h, sizeof(h));
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+// Reading.
+
+namespace {
+
+// Whether [offset, offset + count * sizeof(T)) is an aligned range within size.
+template <typename T>
+bool IsInBounds(uint64_t offset, uint64_t count, size_t size) {
+    if (offset % alignof(T) || size < offset) {
+        return false;
+    }
+    return count <= (size - offset) / sizeof(T);
+}
+
+// Get entry i's [begin, end) from an offsets array, if it lies within
+// [0, total).
+bool GetRange(const uint32_t* offsets, size_t i, size_t total, size_t* begin,
+              size_t* end) {
+    *begin = offsets[i];
+    *end = offsets[i + 1];
+    return *begin <= *end && *end <= total;
+}
+
+// Probe hash slots (a power of two of them) for an id in [0, num_ids) that
+// matches.  Gives up after visiting every slot, in case none is empty.
+template <typename IsMatch>
+bool FindInSlots(const uint32_t* slots, size_t num_slots, uint64_t hash,
+                 size_t num_ids, IsMatch is_match, size_t* id) {
+    size_t mask = num_slots - 1;
+    size_t x = hash & mask;
+    for (size_t i = 0; i < num_slots && slots[x] != EMPTY_SLOT; ++i) {
+        size_t slot = slots[x];
+        if (slot < num_ids && is_match(slot)) {
+            *id = slot;
+            return true;
+        }
+        x = (x + 1) & mask;
+    }
+    return false;
+}
+
+// Whether there are a power of two slots, more than the ids they hold.
+bool IsValidNumSlots(size_t num_slots, size_t num_ids) {
+    return !(num_slots & (num_slots - 1)) && num_ids < num_slots;
+}
+
+}  // namespace
+
+bool SnapshotTable::Init(const char* data, size_t size, uint64_t offset) {
+    if (!IsInBounds<SnapshotTableHeader>(offset, 1, size)) {
+        return false;
+    }
+    const SnapshotTableHeader& h =
+        *reinterpret_cast<const SnapshotTableHeader*>(data + offset);
+
+    // Keys.
+    if (!IsInBounds<uint32_t>(h.key_offsets, h.num_keys + 1ul, size)) {
+        return false;
+    }
+    key_offsets_ = reinterpret_cast<const uint32_t*>(data + h.key_offsets);
+    num_key_ids_ = key_offsets_[h.num_keys];
+    if (!IsInBounds<uint32_t>(h.key_ids, num_key_ids_, size)) {
+        return false;
+    }
+    key_ids_ = reinterpret_cast<const uint32_t*>(data + h.key_ids);
+
+    // Hash slots.
+    if (!IsValidNumSlots(h.num_slots, h.num_keys) ||
+            !IsInBounds<uint32_t>(h.slots, h.num_slots, size)) {
+        return false;
+    }
+    slots_ = reinterpret_cast<const uint32_t*>(data + h.slots);
+    num_slots_ = h.num_slots;
+
+    // VWCs.
+    if (!IsInBounds<uint32_t>(h.vwc_offsets, h.num_keys + 1ul, size)) {
+        return false;
+    }
+    vwc_offsets_ = reinterpret_cast<const uint32_t*>(data + h.vwc_offsets);
+    num_vwcs_ = vwc_offsets_[h.num_keys];
+    if (!IsInBounds<PackedVWC>(h.vwcs, num_vwcs_, size)) {
+        return false;
+    }
+    vwcs_ = reinterpret_cast<const PackedVWC*>(data + h.vwcs);
+
+    // Lemmas (few enough to just copy).
+    if (!IsInBounds<uint32_t>(h.lemma_offsets, h.num_lemmas + 1ul, size)) {
+        return false;
+    }
+    const uint32_t* lemma_offsets =
+        reinterpret_cast<const uint32_t*>(data + h.lemma_offsets);
+    size_t lemma_blob_size = lemma_offsets[h.num_lemmas];
+    if (!IsInBounds<char>(h.lemma_blob, lemma_blob_size, size)) {
+        return false;
+    }
+    lemmas_.clear();
+    for (size_t i = 0; i < h.num_lemmas; ++i) {
+        size_t begin;
+        size_t end;
+        if (!GetRange(lemma_offsets, i, lemma_blob_size, &begin, &end)) {
+            return false;
+        }
+        lemmas_.emplace_back(data + h.lemma_blob + begin, end - begin);
+    }
+
+    num_keys_ = h.num_keys;
+    return true;
+}
+
+bool SnapshotTable::Find(const vector<uint32_t>& key, size_t* index) const {
+    return FindInSlots(slots_, num_slots_, HashKey(key.data(), key.size()),
+                       num_keys_, [&](size_t i) {
+        size_t begin;
+        size_t end;
+        return GetRange(key_offsets_, i, num_key_ids_, &begin, &end) &&
+               end - begin == key.size() &&
+               !memcmp(&key_ids_[begin], key.data(),
+                       key.size() * sizeof(uint32_t));
+    }, index);
+}
+
+bool SnapshotTable::Contains(const vector<uint32_t>& key) const {
+    size_t index;
+    return Find(key, &index);
+}
+
+size_t SnapshotTable::AppendMatches(
+        const vector<uint32_t>& key, vector<PackedVWC>* rr) const {
+    size_t index;
+    size_t begin;
+    size_t end_excl;
+    if (!Find(key, &index) ||
+            !GetRange(vwc_offsets_, index, num_vwcs_, &begin, &end_excl)) {
+        return 0;
+    }
+
+    // Every VWC must refer to one of the lemmas.
+    for (size_t i = begin; i < end_excl; ++i) {
+        if (lemmas_.size() <= vwcs_[i].lemma_id) {
+            return 0;
+        }
+    }
+
+    rr->insert(rr->end(), vwcs_ + begin, vwcs_ + end_excl);
+    return end_excl - begin;
+}
+
+// -----------------------------------------------------------------------------
+
+bool VerbParserSnapshot::IsSnapshotFile(const string& file_name) {
+    FILE* f = fopen(file_name.c_str(), "rb");
+    if (!f) {
+        return false;
+    }
+
+    char magic[8];
+    bool is_snapshot = fread(magic, sizeof(magic), 1, f) == 1 &&
+        !memcmp(magic, VERB_PARSER_SNAPSHOT_MAGIC, sizeof(magic));
+    fclose(f);
+    return is_snapshot;
+}
+
+bool VerbParserSnapshot::InitFromFile(const string& file_name) {
+    bytes_.clear();
+    if (!file_.Open(file_name)) {
+        ERROR("[VerbParserSnapshot] Could not map [%s].\n", file_name.c_str());
+        return false;
+    }
+
+    return InitTables(file_.data(), file_.size());
+}
+
+bool VerbParserSnapshot::InitFromBytes(const string& bytes) {
+    file_.Close();
+    bytes_ = bytes;
+    return InitTables(bytes_.data(), bytes_.size());
+}
+
+bool VerbParserSnapshot::InitWords(const char* data, size_t size,
+                                   const SnapshotHeader& h) {
+    if (!IsInBounds<uint32_t>(h.word_offsets, h.num_words + 1ul, size)) {
+        return false;
+    }
+    word_offsets_ = reinterpret_cast<const uint32_t*>(data + h.word_offsets);
+    word_blob_size_ = word_offsets_[h.num_words];
+    if (!IsInBounds<char>(h.word_blob, word_blob_size_, size)) {
+        return false;
+    }
+    word_blob_ = data + h.word_blob;
+
+    if (!IsValidNumSlots(h.num_word_slots, h.num_words) ||
+            !IsInBounds<uint32_t>(h.word_slots, h.num_word_slots, size)) {
+        return false;
+    }
+    word_slots_ = reinterpret_cast<const uint32_t*>(data + h.word_slots);
+    num_word_slots_ = h.num_word_slots;
+
+    num_words_ = h.num_words;
+    return true;
+}
+
+bool VerbParserSnapshot::FindWord(const string& word, uint32_t* id) const {
+    size_t index;
+    if (!FindInSlots(word_slots_, num_word_slots_, HashWord(word), num_words_,
+                     [&](size_t i) {
+            size_t begin;
+            size_t end;
+            return GetRange(word_offsets_, i, word_blob_size_, &begin,
+                            &end) &&
+                   StringView(word_blob_ + begin, end - begin) == word;
+        }, &index)) {
+        return false;
+    }
+    *id = static_cast<uint32_t>(index);
+    return true;
+}
+
+bool VerbParserSnapshot::InitTables(const char* data, size_t size) {
+    if (size < sizeof(SnapshotHeader)) {
+        ERROR("[VerbParserSnapshot] Truncated header.\n");
+        return false;
+    }
+
+    const SnapshotHeader& h = *reinterpret_cast<const SnapshotHeader*>(data);
+    if (memcmp(h.magic, VERB_PARSER_SNAPSHOT_MAGIC, sizeof(h.magic))) {
+        ERROR("[VerbParserSnapshot] Not a snapshot.\n");
+        return false;
+    }
+
+    if (h.version != VERB_PARSER_SNAPSHOT_VERSION) {
+        ERROR("[VerbParserSnapshot] Snapshot is version %u, but we read "
+              "version %u (delete it to regenerate).\n", h.version,
+              VERB_PARSER_SNAPSHOT_VERSION);
+        return false;
+    }
+
+    if (h.byte_order_mark != BYTE_ORDER_MARK) {
+        ERROR("[VerbParserSnapshot] Snapshot has the wrong byte order.\n");
+        return false;
+    }
+
+    if (h.size != size) {
+        ERROR("[VerbParserSnapshot] Snapshot is %zu bytes, expected %zu.\n",
+              size, static_cast<size_t>(h.size));
+        return false;
+    }
+
+    for (size_t i = 0; i < STI_NUM_TABLES; ++i) {
+        if (!tables_[i].Init(data, size, h.tables[i])) {
+            ERROR("[VerbParserSnapshot] Table %zu is corrupt.\n", i);
+            return false;
+        }
+    }
+
+    if (!InitWords(data, size, h)) {
+        ERROR("[VerbParserSnapshot] Words are corrupt.\n");
+        return false;
+    }
+
+    return true;
+}
@@ -0,0 +1,167 @@
+#ifndef CC_CORE_LING_VERB_INTERNAL_PARSING_VERB_PARSER_SNAPSHOT_H_
+#define CC_CORE_LING_VERB_INTERNAL_PARSING_VERB_PARSER_SNAPSHOT_H_
+
+#include <cstdint>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "cc/base/mmap_file.h"
+#include "cc/core/ling/verb/internal/parsing/lookup_table.h"
+#include "cc/core/ling/verb/packed_vwc.h"
+
+using std::set;
+using std::string;
+using std::vector;
+
+// Binary snapshot of the VerbParser's tables, queried in place.
+//
+// Keys are sequences of word ids: the number of pre-words, then the ids of the
+// pre-words and main words (an empty list of words counts as one empty word,
+// as in the string keys of VerbSayResult::ToKey()).
+//
+// Layout (native byte order, every offset from the start of the snapshot, every
+// section 8-byte aligned):
+//
+//   SnapshotHeader
+//   For each table (to_be, pro_verbs, fir, deverbed_keys):
+//     SnapshotTableHeader
+//     uint32_t key_offsets[num_keys + 1]     Into key_ids.
+//     uint32_t key_ids[]                     Keys.
+//     uint32_t slots[num_slots]              Hash of key -> key index, by
+//                                            linear probing (~0 is empty).
+//     uint32_t vwc_offsets[num_keys + 1]     Into vwcs.
+//     PackedVWC vwcs[]
+//     uint32_t lemma_offsets[num_lemmas + 1] Into the lemma blob.
+//     char lemma_blob[]                      What the VWCs' lemma ids index.
+//   uint32_t word_offsets[num_words + 1]     Into the word blob.
+//   char word_blob[]                         Every word used in a key, by id.
+//   uint32_t word_slots[num_word_slots]      Hash of word -> word id, by
+//                                            linear probing (~0 is empty).
+//
+// The deverbed key set is a table without any VWCs.
+//
+// Loading only checks the headers and that each array lies within the
+// snapshot, so that mapping it doesn't read every page.  The contents (slots,
+// offsets, lemma ids) are checked as lookups reach them, and a corrupt entry
+// reads as a miss.
+
+#define VERB_PARSER_SNAPSHOT_MAGIC "VPSNAP\r\n"
+#define VERB_PARSER_SNAPSHOT_VERSION 4
+
+// What the snapshot built from a JSON (or missing) tables file is saved as,
+// appended to that file's name.
+#define VERB_PARSER_SNAPSHOT_EXT ".snap"
+
+enum SnapshotTableID {
+    STI_TO_BE,
+    STI_PRO_VERBS,
+    STI_FIR,
+    STI_DEVERBED_KEYS,
+    STI_NUM_TABLES
+};
+
+struct SnapshotHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t byte_order_mark;  // 0x01020304 as written.
+    uint64_t size;
+    uint32_t num_words;
+    uint32_t num_word_slots;
+    uint64_t word_offsets;
+    uint64_t word_blob;
+    uint64_t word_slots;
+    uint64_t tables[STI_NUM_TABLES];
+};
+
+struct SnapshotTableHeader {
+    uint32_t num_keys;
+    uint32_t num_lemmas;
+    uint32_t num_slots;
+    uint32_t reserved;
+    uint64_t key_offsets;
+    uint64_t key_ids;
+    uint64_t slots;
+    uint64_t vwc_offsets;
+    uint64_t vwcs;
+    uint64_t lemma_offsets;
+    uint64_t lemma_blob;
+};
+
+// Read-only view of one table in a snapshot.
+class SnapshotTable {
+  public:
+    size_t num_keys() const { return num_keys_; }
+    const vector<string>& lemmas() const { return lemmas_; }
+
+    // Verify the table's arrays lie within the snapshot, then point into it.
+    bool Init(const char* data, size_t size, uint64_t table_offset);
+
+    bool Contains(const vector<uint32_t>& key) const;
+
+    // Append the key's VWCs.  Their lemma ids index lemmas().  Returns how
+    // many were appended.
+    size_t AppendMatches(const vector<uint32_t>& key,
+                         vector<PackedVWC>* rr) const;
+
+  private:
+    bool Find(const vector<uint32_t>& key, size_t* index) const;
+
+    size_t num_keys_;
+    const uint32_t* key_offsets_;
+    size_t num_key_ids_;
+    const uint32_t* key_ids_;
+    size_t num_slots_;
+    const uint32_t* slots_;
+    const uint32_t* vwc_offsets_;
+    size_t num_vwcs_;
+    const PackedVWC* vwcs_;
+
+    // The handful of lemmas used by the table (just one, in practice).
+    vector<string> lemmas_;
+};
+
+// The VerbParser's tables, either mapped from a file or held in memory.
+class VerbParserSnapshot {
+  public:
+    const SnapshotTable& table(SnapshotTableID id) const {
+        return tables_[id];
+    }
+
+    // Get a word's id for building keys.  Returns false if no key has it.
+    bool FindWord(const string& word, uint32_t* id) const;
+
+    // Serialize the tables.  Returns false if a key is malformed.
+    static bool Build(const LookupTable& to_be, const LookupTable& pro_verbs,
+                      const LookupTable& fir, const set<string>& deverbed_keys,
+                      string* bytes);
+
+    // Whether the file starts with the snapshot magic (of any version).
+    static bool IsSnapshotFile(const string& file_name);
+
+    // Map a snapshot file.
+    bool InitFromFile(const string& file_name);
+
+    // Take a serialized snapshot.
+    bool InitFromBytes(const string& bytes);
+
+  private:
+    bool InitTables(const char* data, size_t size);
+    bool InitWords(const char* data, size_t size, const SnapshotHeader& h);
+
+    // Backing storage: one or the other.
+    MmapFile file_;
+    string bytes_;
+
+    // The words, by id, and their hash slots.
+    size_t num_words_;
+    const uint32_t* word_offsets_;
+    size_t word_blob_size_;
+    const char* word_blob_;
+    size_t num_word_slots_;
+    const uint32_t* word_slots_;
+
+    SnapshotTable tables_[STI_NUM_TABLES];
+};
+
+#endif  // CC_CORE_LING_VERB_INTERNAL_PARSING_VERB_PARSER_SNAPSHOT_H_
@@ -0,0 +1,141 @@
+#include "say_template.h"
+
+#include <cassert>
+
+using std::lock_guard;
+using std::mutex;
+
+// -----------------------------------------------------------------------------
+// SayTemplate.
+
+namespace {
+
+// "12" -> 12.  Returns false if not a field index.
+bool ParseFieldIndex(const char* s, size_t size, uint8_t* field_index) {
+    if (!size || 2 < size) {
+        return false;
+    }
+
+    unsigned n = 0;
+    for (size_t i = 0; i < size; ++i) {
+        if (!('0' <= s[i] && s[i] <= '9')) {
+            return false;
+        }
+        n = n * 10 + static_cast<unsigned>(s[i] - '0');
+    }
+    *field_index = static_cast<uint8_t>(n);
+    return true;
+}
+
+// "<12-pv>" -> 12.
+bool ParseProVerbFieldIndex(const string& s, uint8_t* field_index) {
+    size_t prefix = 1;
+    size_t suffix = 4;
+    if (s.size() < prefix + suffix || s[0] != '<' ||
+            s.compare(s.size() - suffix, suffix, "-pv>")) {
+        return false;
+    }
+    return ParseFieldIndex(s.data() + prefix, s.size() - prefix - suffix,
+                           field_index);
+}
+
+}  // namespace
+
+void SayTemplate::InitWords(const vector<string>& ss, bool is_pro_verb,
+                            bool* has_blanks, vector<SayTemplateWord>* words) {
+    words->resize(ss.size());
+    for (size_t i = 0; i < ss.size(); ++i) {
+        const string& s = ss[i];
+        SayTemplateWord* word = &(*words)[i];
+        bool is_blank = is_pro_verb ?
+            ParseProVerbFieldIndex(s, &word->field_index) :
+            ParseFieldIndex(s.data(), s.size(), &word->field_index);
+        if (is_blank) {
+            word->text.clear();
+            *has_blanks = true;
+        } else {
+            word->text = s;
+            word->field_index = SAY_TEMPLATE_LITERAL;
+        }
+    }
+}
+
+void SayTemplate::Init(VerbSayStatus status, const VerbSayResult& r,
+                       bool is_pro_verb, bool needs_spec) {
+    status_ = status;
+    is_pro_verb_ = is_pro_verb;
+    has_blanks_ = false;
+    needs_spec_ = needs_spec;
+    InitWords(r.pre_words, is_pro_verb, &has_blanks_, &pre_words_);
+    InitWords(r.main_words, is_pro_verb, &has_blanks_, &main_words_);
+}
+
+void SayTemplate::RenderWords(const vector<SayTemplateWord>& words,
+                              const ConjugationSpec* to_verb,
+                              vector<string>* ss) const {
+    ss->resize(words.size());
+    for (size_t i = 0; i < words.size(); ++i) {
+        const SayTemplateWord& word = words[i];
+        string* s = &(*ss)[i];
+        if (word.field_index == SAY_TEMPLATE_LITERAL) {
+            *s = word.text;
+        } else if (is_pro_verb_) {
+            s->assign("<");
+            to_verb->GetField(word.field_index).AppendTo(s);
+            s->append("-pv>");
+        } else {
+            to_verb->GetField(word.field_index).AssignTo(s);
+        }
+    }
+}
+
+void SayTemplate::Render(const ConjugationSpec* to_verb,
+                         VerbSayResult* r) const {
+    assert(to_verb || !has_blanks_);
+    RenderWords(pre_words_, to_verb, &r->pre_words);
+    RenderWords(main_words_, to_verb, &r->main_words);
+}
+
+// -----------------------------------------------------------------------------
+// SayTemplateCache.
+
+void SayTemplateCache::Clear() {
+    for (auto& shard : shards_) {
+        lock_guard<mutex> lock(shard.mutex);
+        shard.key2template.clear();
+    }
+}
+
+SayTemplateCache::Shard* SayTemplateCache::GetShard(const PackedVWC& key) {
+    PackedVWCHash f;
+    return &shards_[(f(key) >> 32) % NUM_SHARDS];
+}
+
+const SayTemplate* SayTemplateCache::Get(const PackedVWC& key) {
+    Shard* shard = GetShard(key);
+    lock_guard<mutex> lock(shard->mutex);
+    auto it = shard->key2template.find(key);
+    if (it == shard->key2template.end()) {
+        return NULL;
+    }
+    return it->second.get();
+}
+
+const SayTemplate* SayTemplateCache::Put(const PackedVWC& key,
+                                         unique_ptr<SayTemplate>* t) {
+    Shard* shard = GetShard(key);
+    lock_guard<mutex> lock(shard->mutex);
+    auto it = shard->key2template.find(key);
+    if (it != shard->key2template.end()) {
+        return it->second.get();
+    }
+
+    if (SAY_TEMPLATE_CACHE_CAPACITY / NUM_SHARDS <=
+            shard->key2template.size()) {
+        return NULL;
+    }
+
+    unique_ptr<SayTemplate>& cached = shard->key2template[key];
+    cached.swap(*t);
+    return cached.get();
+}
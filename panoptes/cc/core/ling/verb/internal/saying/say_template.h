@@ -0,0 +1,113 @@
+#ifndef CC_CORE_LING_VERB_INTERNAL_SAYING_SAY_TEMPLATE_H_
+#define CC_CORE_LING_VERB_INTERNAL_SAYING_SAY_TEMPLATE_H_
+
+// Lemma-agnostic say results.
+//
+// How a verb is said depends on its lemma only through which of the lemma's
+// conjugations are used, and whether it has do-support (only "be" doesn't).
+// So each combination of the other fields is said once with the magic "<ints>"
+// lemma (whose conjugations are their own field indexes), or with "be", and the
+// words that came out of the lemma's spec are left as blanks to fill in.  The
+// parser's fir table is the same trick in reverse.
+//
+// The one catch is the lemma "not", whose words would be taken for negation
+// when slicing, so it is said the slow way.
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "cc/core/ling/verb/internal/conjugation/conjugation_spec.h"
+#include "cc/core/ling/verb/packed_vwc.h"
+#include "cc/core/ling/verb/verb_say_result.h"
+#include "cc/core/ling/verb/verb_say_status.h"
+
+using std::string;
+using std::unique_ptr;
+using std::unordered_map;
+using std::vector;
+
+// Marks a template word that is said as is.
+#define SAY_TEMPLATE_LITERAL 0xFF
+
+// The lemma ids of template keys.
+#define SAY_TEMPLATE_DO_SUPPORT 0
+#define SAY_TEMPLATE_BE 1
+
+struct SayTemplateWord {
+    // The word, if literal.
+    string text;
+
+    // Else, the field of the lemma's spec to say.
+    uint8_t field_index;
+};
+
+class SayTemplate {
+  public:
+    VerbSayStatus status() const { return status_; }
+    bool has_blanks() const { return has_blanks_; }
+
+    // Whether saying got as far as needing the lemma's spec.  If so, a lemma
+    // that can't be conjugated fails before this status applies.
+    bool needs_spec() const { return needs_spec_; }
+
+    // From what saying the verb with a stand-in lemma returned.  Words that are
+    // field indexes (wrapped as pro-verb words, if it is a pro-verb) become
+    // blanks.
+    void Init(VerbSayStatus status, const VerbSayResult& r, bool is_pro_verb,
+              bool needs_spec);
+
+    // Fill in the blanks from the lemma's spec (which may be NULL if there are
+    // no blanks).
+    void Render(const ConjugationSpec* to_verb, VerbSayResult* r) const;
+
+  private:
+    static void InitWords(const vector<string>& ss, bool is_pro_verb,
+                          bool* has_blanks, vector<SayTemplateWord>* words);
+
+    void RenderWords(const vector<SayTemplateWord>& words,
+                     const ConjugationSpec* to_verb,
+                     vector<string>* ss) const;
+
+    VerbSayStatus status_;
+    bool is_pro_verb_;
+    bool has_blanks_;
+    bool needs_spec_;
+    vector<SayTemplateWord> pre_words_;
+    vector<SayTemplateWord> main_words_;
+};
+
+// Thread-safe packed VWC fields -> SayTemplate cache, filled on first use.
+// Templates are never evicted, so the pointers handed out stay good until
+// Clear().  Past SAY_TEMPLATE_CACHE_CAPACITY, new templates are not kept.
+#define SAY_TEMPLATE_CACHE_CAPACITY (1 << 20)
+
+class SayTemplateCache {
+  public:
+    void Clear();
+
+    // Returns NULL on a miss.
+    const SayTemplate* Get(const PackedVWC& key);
+
+    // Cache the template, taking it.  Returns the cached template for the key
+    // (another thread's, if it got there first), or NULL if full.
+    const SayTemplate* Put(const PackedVWC& key, unique_ptr<SayTemplate>* t);
+
+  private:
+    static const size_t NUM_SHARDS = 16;
+
+    struct Shard {
+        std::mutex mutex;
+        unordered_map<PackedVWC, unique_ptr<SayTemplate>, PackedVWCHash>
+            key2template;
+    };
+
+    Shard* GetShard(const PackedVWC& key);
+
+    Shard shards_[NUM_SHARDS];
+};
+
+#endif  // CC_CORE_LING_VERB_INTERNAL_SAYING_SAY_TEMPLATE_H_
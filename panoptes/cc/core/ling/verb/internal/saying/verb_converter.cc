@@ -5,7 +5,6 @@
 #include "cc/base/file.h"
 #include "cc/base/string.h"
 #include "cc/base/table_util.h"
-#include "cc/base/warning.h"
 
 // -----------------------------------------------------------------------------
 
@@ -75,69 +74,114 @@ bool ModalitiesTable::Init(const string& text) {
 
 void ModalitiesTable::GetOptions(
         const Modality& m, vector<MoodAndModal>* rr) const {
-    bool b = table_.Get(m.flavor(), m.is_cond(), rr);
-    assert(b);
-    UNUSED(b);  // clang++ is not seeing asserts for some reason.
+    const vector<MoodAndModal>* options =
+        table_.GetPointer(m.flavor(), m.is_cond());
+    assert(options);
+    if (options) {
+        *rr = *options;
+    }
 }
 
 // -----------------------------------------------------------------------------
 
 bool VerbConverter::Init(const string& modalities_f) {
-    dvoice2svoice_ = {
-        {V_ACTIVE,  SV_ACTIVE},
-        {V_PASSIVE, SV_PASSIVE}
-    };
-
-    verb_form2sverb_form_ = {
-        {VF_FINITE,          SVF_NORMAL_FINITE},
-        {VF_BARE_INF,        SVF_BARE_INF},
-        {VF_TO_INF,          SVF_TO_INF},
-        {VF_GERUND,          SVF_GERUND},
-        {VF_SUBJLESS_GERUND, SVF_GERUND}
-    };
-
-    mood2tense2stense_ = {
-        {
-            MOOD_IND, {
-                {T_PAST,    ST_PAST},
-                {T_PRESENT, ST_NONPAST},
-                {T_FUTURE,  ST_NONPAST}
-            }
-        },
-        {
-            MOOD_IMP, {
-                {T_PAST,    ST_NONPAST},
-                {T_PRESENT, ST_NONPAST},
-                {T_FUTURE,  ST_NONPAST}
-            }
-        },
-        {
-            MOOD_SBJ_IMP, {
-                {T_PAST,    ST_SBJ_PRES},
-                {T_PRESENT, ST_SBJ_PRES},
-                {T_FUTURE,  ST_SBJ_PRES}
-            }
-        },
-        {
-            MOOD_SBJ_CF, {
-                {T_PAST,    ST_SBJ_PAST},
-                {T_PRESENT, ST_SBJ_PAST},
-                {T_FUTURE,  ST_SBJ_FUT}
-            }
-        }
-    };
+    dvoice2svoice_[V_ACTIVE] = SV_ACTIVE;
+    dvoice2svoice_[V_PASSIVE] = SV_PASSIVE;
+
+    verb_form2sverb_form_[VF_FINITE] = SVF_NORMAL_FINITE;
+    verb_form2sverb_form_[VF_BARE_INF] = SVF_BARE_INF;
+    verb_form2sverb_form_[VF_TO_INF] = SVF_TO_INF;
+    verb_form2sverb_form_[VF_GERUND] = SVF_GERUND;
+    verb_form2sverb_form_[VF_SUBJLESS_GERUND] = SVF_GERUND;
+
+    SurfaceTense* ind = mood2tense2stense_[MOOD_IND];
+    ind[T_PAST] = ST_PAST;
+    ind[T_PRESENT] = ST_NONPAST;
+    ind[T_FUTURE] = ST_NONPAST;
+
+    SurfaceTense* imp = mood2tense2stense_[MOOD_IMP];
+    imp[T_PAST] = ST_NONPAST;
+    imp[T_PRESENT] = ST_NONPAST;
+    imp[T_FUTURE] = ST_NONPAST;
+
+    SurfaceTense* sbj_imp = mood2tense2stense_[MOOD_SBJ_IMP];
+    sbj_imp[T_PAST] = ST_SBJ_PRES;
+    sbj_imp[T_PRESENT] = ST_SBJ_PRES;
+    sbj_imp[T_FUTURE] = ST_SBJ_PRES;
+
+    SurfaceTense* sbj_cf = mood2tense2stense_[MOOD_SBJ_CF];
+    sbj_cf[T_PAST] = ST_SBJ_PAST;
+    sbj_cf[T_PRESENT] = ST_SBJ_PAST;
+    sbj_cf[T_FUTURE] = ST_SBJ_FUT;
 
     string s;
     if (!File::FileToString(modalities_f, &s)) {
         return false;
     }
-    return modalities_table_.Init(s);
+    ModalitiesTable modalities_table;
+    if (!modalities_table.Init(s)) {
+        return false;
+    }
+
+    InitMoodsModalsTenses(modalities_table);
+    return true;
+}
+
+void VerbConverter::InitMoodsModalsTenses(
+        const ModalitiesTable& modalities_table) {
+    mmts_.clear();
+    modals_.Clear();
+    uint32_t no_modal_id = modals_.Intern("");
+    uint32_t will_id = modals_.Intern("will");
+
+    vector<MoodAndModal> mms;
+    for (int i = 0; i < MF_NUM_FLAVORS; ++i) {
+        ModalFlavor flavor = static_cast<ModalFlavor>(i);
+        for (int j = 0; j < 2; ++j) {
+            bool is_cond = j != 0;
+            Modality m;
+            m.Init(flavor, is_cond);
+
+            // Get what mood + modal combos go with that modality.
+            mms.clear();
+            modalities_table.GetOptions(m, &mms);
+
+            for (int k = 0; k < T_NUM_TENSES; ++k) {
+                Tense t = static_cast<Tense>(k);
+                MoodsModalsTenses* r = &flavor2is_cond2tense2mmts_[i][j][k];
+                r->begin = static_cast<uint32_t>(mmts_.size());
+                r->size = static_cast<uint32_t>(mms.size());
+
+                if (!mms.size()) {
+                    r->status = VSS_INVALID_CONDITIONAL_FORM_OF_MODALITY_DNE;
+                    continue;
+                }
+
+                r->status = VSS_OK;
+                for (auto& mm : mms) {
+                    MoodModalStense mmt;
+                    mmt.mood = mm.mood;
+                    mmt.modal_id = mm.modal.empty() ? no_modal_id :
+                                                      modals_.Intern(mm.modal);
+
+                    // Handle exceptions.
+                    if (flavor == MF_INDICATIVE && t == T_FUTURE) {
+                        mmt.modal_id = will_id;
+                    }
+
+                    // Get surface tense.
+                    GetSurfaceTense(t, mmt.mood, &mmt.stense);
+
+                    mmts_.emplace_back(mmt);
+                }
+            }
+        }
+    }
 }
 
 void VerbConverter::GetSurfaceVoice(Voice v, SurfaceVoice* r) const {
-    const map<Voice, SurfaceVoice>::const_iterator it = dvoice2svoice_.find(v);
-    assert(it != dvoice2svoice_.end());
-    *r = it->second;
+    assert(v < V_NUM_VOICES);
+    *r = dvoice2svoice_[v];
 }
 
 void VerbConverter::GetSurfaceAspect(const Aspect& a, SurfaceAspect* r) const {
@@ -173,51 +217,25 @@ VerbSayStatus VerbConverter::GetSurfaceVerbForm(
 
     // Handle the normal case.
     assert(rc == RC_NO);
-    const map<VerbForm, SurfaceVerbForm>::const_iterator it =
-            verb_form2sverb_form_.find(vf);
-    assert(it != verb_form2sverb_form_.end());
-    *svf = it->second;
+    assert(vf < VF_NUM_VERB_FORMS);
+    *svf = verb_form2sverb_form_[vf];
     return VSS_OK;
 }
 
 void VerbConverter::GetSurfaceTense(Tense t, Mood m, SurfaceTense* r) const {
-    const map<Mood, map<Tense, SurfaceTense> >::const_iterator it =
-        mood2tense2stense_.find(m);
-    assert(it != mood2tense2stense_.end());
-    const map<Tense, SurfaceTense>::const_iterator jt = it->second.find(t);
-    assert(jt != it->second.end());
-    *r = jt->second;
+    assert(m < MOOD_NUM_MOODS);
+    assert(t < T_NUM_TENSES);
+    *r = mood2tense2stense_[m][t];
 }
 
 VerbSayStatus VerbConverter::GetMoodsModalsTenses(
-        const Modality& m, Tense t, vector<MoodModalStense>* rr) const {
-    // Get what mood + modal combos go with that modality.
-    vector<MoodAndModal> mms;
-    modalities_table_.GetOptions(m, &mms);
-
-    if (!mms.size()) {
-        return VSS_INVALID_CONDITIONAL_FORM_OF_MODALITY_DNE;
-    }
-
-    for (unsigned i = 0; i < mms.size(); ++i) {
-        const MoodAndModal& mm = mms[i];
-
-        MoodModalStense r;
-        r.mood = mm.mood;
-        r.modal = mm.modal;
-
-        // Handle exceptions.
-        if (m.flavor() == MF_INDICATIVE && t == T_FUTURE) {
-            r.modal = "will";
-        }
-
-        // Get surface tense.
-        GetSurfaceTense(t, r.mood, &r.stense);
-
-        rr->emplace_back(r);
-    }
-
-    return VSS_OK;
+        const Modality& m, Tense t, Span<MoodModalStense>* rr) const {
+    assert(m.flavor() < MF_NUM_FLAVORS);
+    assert(t < T_NUM_TENSES);
+    const MoodsModalsTenses& r =
+        flavor2is_cond2tense2mmts_[m.flavor()][m.is_cond()][t];
+    *rr = Span<MoodModalStense>(mmts_.data() + r.begin, r.size);
+    return r.status;
 }
 
 // -----------------------------------------------------------------------------
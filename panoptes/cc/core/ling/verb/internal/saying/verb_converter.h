@@ -1,15 +1,15 @@
 #ifndef CC_CORE_LING_VERB_INTERNAL_SAYING_VERB_CONVERTER_H_
 #define CC_CORE_LING_VERB_INTERNAL_SAYING_VERB_CONVERTER_H_
 
-#include <map>
 #include <vector>
 
+#include "cc/ds/span.h"
+#include "cc/ds/string_interner.h"
 #include "cc/ds/table.h"
 #include "cc/core/ling/verb/internal/surface/surface_verb.h"
 #include "cc/core/ling/verb/verb_with_context.h"
 #include "cc/core/ling/verb/verb_say_status.h"
 
-using std::map;
 using std::vector;
 
 struct MoodAndModal {
@@ -28,7 +28,7 @@ class ModalitiesTable {
 
 struct MoodModalStense {
     Mood mood;
-    string modal;
+    uint32_t modal_id;  // See VerbConverter::GetModal().
     SurfaceTense stense;
 };
 
@@ -45,14 +45,34 @@ class VerbConverter {
 
     void GetSurfaceTense(Tense t, Mood m, SurfaceTense* r) const;
 
+    // Precomputed at Init for every modality and tense, so this is a lookup.
+    // The span stays valid for the life of the converter (empty on error).
     VerbSayStatus GetMoodsModalsTenses(
-        const Modality& m, Tense t, vector<MoodModalStense>* rr) const;
+        const Modality& m, Tense t, Span<MoodModalStense>* rr) const;
+
+    // The modal of a MoodModalStense ("" if none).
+    const string& GetModal(uint32_t modal_id) const {
+        return modals_.strings()[modal_id];
+    }
 
   private:
-    map<Voice, SurfaceVoice> dvoice2svoice_;
-    map<VerbForm, SurfaceVerbForm> verb_form2sverb_form_;
-    map<Mood, map<Tense, SurfaceTense> > mood2tense2stense_;
-    ModalitiesTable modalities_table_;
+    // Where the options for one modality and tense live in mmts_.
+    struct MoodsModalsTenses {
+        VerbSayStatus status;
+        uint32_t begin;
+        uint32_t size;
+    };
+
+    void InitMoodsModalsTenses(const ModalitiesTable& modalities_table);
+
+    // Indexed by enum value.
+    SurfaceVoice dvoice2svoice_[V_NUM_VOICES];
+    SurfaceVerbForm verb_form2sverb_form_[VF_NUM_VERB_FORMS];
+    SurfaceTense mood2tense2stense_[MOOD_NUM_MOODS][T_NUM_TENSES];
+    MoodsModalsTenses flavor2is_cond2tense2mmts_[MF_NUM_FLAVORS][2]
+                                                [T_NUM_TENSES];
+    vector<MoodModalStense> mmts_;
+    StringInterner modals_;
 };
 
 #endif  // CC_CORE_LING_VERB_INTERNAL_SAYING_VERB_CONVERTER_H_
@@ -1,8 +1,32 @@
 #include "verb_sayer.h"
 
+#include "cc/base/metrics.h"
 #include "cc/base/string.h"
 
+#include <algorithm>
 #include <cassert>
+#include <memory>
+
+using std::shared_ptr;
+using std::stable_sort;
+
+// -----------------------------------------------------------------------------
+
+namespace {
+
+// Count a say result by its status.
+void CountSayStatus(VerbSayStatus status) {
+    static const vector<Counter*> counters = [] {
+        vector<Counter*> r;
+        for (auto& s : VerbSayStatusStrings.strings()) {
+            r.emplace_back(Metrics::GetCounter("verb_sayer.status." + s));
+        }
+        return r;
+    }();
+    counters[status]->Add();
+}
+
+}  // namespace
 
 // -----------------------------------------------------------------------------
 
@@ -38,6 +62,9 @@ bool VerbSayResult::FromKey(const string& s) {
 
 bool VerbSayer::Init(const Conjugator* conj, const string& modalities_f,
                      const string& modal_past_tense_f) {
+    conjugator_ = conj;
+    templates_.Clear();
+
     if (!conv_.Init(modalities_f)) {
         return false;
     };
@@ -140,9 +167,8 @@ VerbSayStatus VerbSayer::SliceVerbWords(
     return VSS_OK;
 }
 
-VerbSayStatus VerbSayer::GetAllSayOptions(
-        const VerbWithContext& vwc, size_t max_num_results,
-        vector<VerbSayResult>* rr) const {
+VerbSayStatus VerbSayer::GetSurfacePlan(
+        const VerbWithContext& vwc, SurfacePlan* plan) const {
     // Check for unset fields.
     VerbSayStatus err;
     if (vwc.HasUnsetFields()) {
@@ -167,97 +193,267 @@ VerbSayStatus VerbSayer::GetAllSayOptions(
     }
 
     // Polarity, expected polarity -> Whether.
-    Whether whether;
     if (vwc.verb().polarity().tf()) {
         if (vwc.verb().polarity().is_contrary().is_true()) {
-            whether = WHETHER_EMPH;  // "No, she *does* write."
+            plan->whether = WHETHER_EMPH;  // "No, she *does* write."
         } else if (vwc.is_split()) {
-            whether = WHETHER_EMPH;  // "Does she write?"
+            plan->whether = WHETHER_EMPH;  // "Does she write?"
         } else if (vwc.verb().is_pro_verb()) {
-            whether = WHETHER_EMPH;  // "Yes, she does."
+            plan->whether = WHETHER_EMPH;  // "Yes, she does."
         } else {
-            whether = WHETHER_YES;   // "She writes."
+            plan->whether = WHETHER_YES;   // "She writes."
         }
     } else {
-        whether = WHETHER_NO;      // "No, she doesn't write."
+        plan->whether = WHETHER_NO;      // "No, she doesn't write."
     }
 
     // Voice -> surface voice.
-    SurfaceVoice voice;
-    conv_.GetSurfaceVoice(vwc.voice(), &voice);
+    conv_.GetSurfaceVoice(vwc.voice(), &plan->voice);
 
     // Aspect -> surface aspect.
-    SurfaceAspect aspect;
-    conv_.GetSurfaceAspect(vwc.verb().aspect(), &aspect);
+    conv_.GetSurfaceAspect(vwc.verb().aspect(), &plan->aspect);
 
     // Deep verb form, relative containment -> surface verb form.
-    SurfaceVerbForm verb_form;
     err = conv_.GetSurfaceVerbForm(
-            vwc.verb().verb_form(), vwc.relative_cont(), &verb_form);
+            vwc.verb().verb_form(), vwc.relative_cont(), &plan->verb_form);
     if (err != VSS_OK) {
         return err;
     }
 
     // Modality, deep tense -> mood, modal, surface tense.
-    vector<MoodModalStense> mmts;
-    err = conv_.GetMoodsModalsTenses(
-                      vwc.verb().modality(), vwc.verb().tense(), &mmts);
+    return conv_.GetMoodsModalsTenses(
+        vwc.verb().modality(), vwc.verb().tense(), &plan->mmts);
+}
+
+VerbSayStatus VerbSayer::SayOption(
+        const VerbWithContext& vwc, const SurfacePlan& plan,
+        const MoodModalStense& mmt, const ConjugationSpec& to_verb,
+        SayScratch* scratch, VerbSayResult* r) const {
+    bool split_inf = vwc.split_inf().is_true();
+    bool use_were_sbj = vwc.sbj_handling() == SH_WERE_SBJ;
+
+    const string& modal = conv_.GetModal(mmt.modal_id);
+
+    scratch->sv.Init(vwc.verb().lemma(), plan.whether, mmt.stense,
+                     plan.aspect, modal, mmt.mood, plan.verb_form,
+                     plan.voice, vwc.conj(), split_inf, use_were_sbj);
+
+    VerbSayStatus err = surface_.Say(scratch->sv, to_verb, &scratch->words);
     if (err != VSS_OK) {
         return err;
     }
 
-    bool split_inf = vwc.split_inf().is_true();
+/*
+    string _;
+    vwc.ToJSON(&_);
+    printf("about to slice\n");
+    printf("%s\n", _.c_str());
+*/
 
-    for (unsigned i = 0; i < mmts.size(); ++i) {
-        if (i == max_num_results) {
-            break;
-        }
+    return SliceVerbWords(
+        scratch->words, vwc.is_split(), vwc.verb().is_pro_verb(),
+        vwc.contract_not().is_true(), r);
+}
 
-        const MoodModalStense& mmt = mmts[i];
+VerbSayStatus VerbSayer::GetAllSayOptions(
+        const VerbWithContext& vwc, size_t max_num_results,
+        vector<VerbSayResult>* rr) const {
+    static Histogram* latency =
+        Metrics::GetHistogram("verb_sayer.get_all_say_options_ns");
+    ScopedLatency timer(latency);
 
-        bool use_were_sbj = vwc.sbj_handling() == SH_WERE_SBJ;
+    SurfacePlan plan;
+    VerbSayStatus err = GetSurfacePlan(vwc, &plan);
+    if (err != VSS_OK) {
+        CountSayStatus(err);
+        return err;
+    }
 
-        SurfaceVerb sv;
-        sv.Init(vwc.verb().lemma(), whether, mmt.stense, aspect, mmt.modal,
-                mmt.mood, verb_form, voice, vwc.conj(), split_inf,
-                use_were_sbj);
+    // Create the conjugation plan for the verb.
+    shared_ptr<const ConjugationSpec> to_verb =
+        conjugator_->GetVerbSpec(vwc.verb().lemma());
+    if (!to_verb && !plan.mmts.empty()) {
+        CountSayStatus(VSS_ERR_CANT_CONJUGATE_LEMMA);
+        return VSS_ERR_CANT_CONJUGATE_LEMMA;
+    }
 
-        vector<string> ss;
-        err = surface_.Say(sv, &ss);
-        if (err != VSS_OK) {
-            return err;
+    SayScratch scratch;
+    for (unsigned i = 0; i < plan.mmts.size(); ++i) {
+        if (i == max_num_results) {
+            break;
         }
 
-/*
-        string _;
-        vwc.ToJSON(&_);
-        printf("about to slice\n");
-        printf("%s\n", _.c_str());
-*/
-
         VerbSayResult r;
-        err = SliceVerbWords(
-                ss, vwc.is_split(), vwc.verb().is_pro_verb(),
-                vwc.contract_not().is_true(), &r);
+        err = SayOption(vwc, plan, plan.mmts[i], *to_verb, &scratch, &r);
         if (err != VSS_OK) {
+            CountSayStatus(err);
             return err;
         }
         rr->emplace_back(r);
     }
 
+    CountSayStatus(VSS_OK);
     return VSS_OK;
 }
 
+bool VerbSayer::CanUseSayTemplate(const VerbWithContext& vwc) {
+    // Templates are keyed by every field but the lemma, so they all have to be
+    // set.  The words of "not" would be taken for negation.
+    return !vwc.HasUnsetFields() && vwc.verb().lemma() != "not";
+}
+
+VerbSayStatus VerbSayer::SayFirstOption(
+        const VerbWithContext& vwc, VerbSayResult* r) const {
+    SurfacePlan plan;
+    VerbSayStatus err = GetSurfacePlan(vwc, &plan);
+    if (err != VSS_OK || plan.mmts.empty()) {
+        return err;
+    }
+
+    shared_ptr<const ConjugationSpec> to_verb =
+        conjugator_->GetVerbSpec(vwc.verb().lemma());
+    if (!to_verb) {
+        return VSS_ERR_CANT_CONJUGATE_LEMMA;
+    }
+    SayScratch scratch;
+    return SayOption(vwc, plan, plan.mmts[0], *to_verb, &scratch, r);
+}
+
+void VerbSayer::MakeSayTemplate(const VerbWithContext& vwc, bool is_be,
+                                SayTemplate* t) const {
+    VerbWithContext stand_in = vwc;
+    stand_in.set_lemma(is_be ? "be" : "<ints>");
+
+    // Planning doesn't look at the lemma, so it tells whether saying gets as
+    // far as the lemma's spec for the real lemma too.
+    SurfacePlan plan;
+    VerbSayStatus status = GetSurfacePlan(stand_in, &plan);
+    bool needs_spec = status == VSS_OK && !plan.mmts.empty();
+
+    VerbSayResult r;
+    if (needs_spec) {
+        status = SayFirstOption(stand_in, &r);
+    }
+    t->Init(status, r, vwc.verb().is_pro_verb(), needs_spec);
+}
+
+const SayTemplate* VerbSayer::GetSayTemplate(
+        const VerbWithContext& vwc, unique_ptr<SayTemplate>* uncached) const {
+    static Counter* hits = Metrics::GetCounter("verb_sayer.say_templates.hits");
+    static Counter* misses =
+        Metrics::GetCounter("verb_sayer.say_templates.misses");
+
+    bool is_be = vwc.verb().lemma() == "be";
+    PackedVWC key;
+    key.InitFromVWC(vwc, is_be ? SAY_TEMPLATE_BE : SAY_TEMPLATE_DO_SUPPORT);
+    if (const SayTemplate* t = templates_.Get(key)) {
+        hits->Add();
+        return t;
+    }
+
+    misses->Add();
+    uncached->reset(new SayTemplate());
+    MakeSayTemplate(vwc, is_be, uncached->get());
+    if (const SayTemplate* t = templates_.Put(key, uncached)) {
+        return t;
+    }
+    return uncached->get();
+}
+
 VerbSayStatus VerbSayer::Say(
         const VerbWithContext& vwc, VerbSayResult* r) const {
-    vector<VerbSayResult> rr;
-    VerbSayStatus err = GetAllSayOptions(vwc, 1, &rr);
-    if (rr.size()) {
-        *r = rr[0];
+    VerbSayStatus err;
+    if (!CanUseSayTemplate(vwc)) {
+        err = SayFirstOption(vwc, r);
+        CountSayStatus(err);
+        return err;
     }
+
+    unique_ptr<SayTemplate> uncached;
+    const SayTemplate* t = GetSayTemplate(vwc, &uncached);
+    shared_ptr<const ConjugationSpec> to_verb;
+    if (t->needs_spec()) {
+        to_verb = conjugator_->GetVerbSpec(vwc.verb().lemma());
+    }
+    if (t->needs_spec() && !to_verb) {
+        err = VSS_ERR_CANT_CONJUGATE_LEMMA;
+    } else {
+        err = t->status();
+        if (err == VSS_OK) {
+            t->Render(to_verb.get(), r);
+        }
+    }
+    CountSayStatus(err);
     return err;
 }
 
+void VerbSayer::SayBatch(const VerbWithContext* vwcs, size_t num_vwcs,
+                         vector<VerbSayResult>* rr,
+                         vector<VerbSayStatus>* statuses) const {
+    static Histogram* latency =
+        Metrics::GetHistogram("verb_sayer.say_batch_ns");
+    ScopedLatency timer(latency);
+
+    rr->resize(num_vwcs);
+    statuses->resize(num_vwcs);
+
+    // Visit the verbs grouped by lemma.
+    vector<size_t> order;
+    order.reserve(num_vwcs);
+    for (size_t i = 0; i < num_vwcs; ++i) {
+        order.emplace_back(i);
+    }
+    stable_sort(order.begin(), order.end(), [vwcs](size_t a, size_t b) {
+        return vwcs[a].verb().lemma() < vwcs[b].verb().lemma();
+    });
+
+    shared_ptr<const ConjugationSpec> to_verb;
+    const string* to_verb_lemma = NULL;
+    for (auto& index : order) {
+        const VerbWithContext& vwc = vwcs[index];
+        VerbSayResult* r = &(*rr)[index];
+        VerbSayStatus* status = &(*statuses)[index];
+        r->pre_words.clear();
+        r->main_words.clear();
+
+        if (!CanUseSayTemplate(vwc)) {
+            *status = SayFirstOption(vwc, r);
+            if (*status != VSS_OK) {
+                r->pre_words.clear();
+                r->main_words.clear();
+            }
+            continue;
+        }
+
+        unique_ptr<SayTemplate> uncached;
+        const SayTemplate* t = GetSayTemplate(vwc, &uncached);
+        if (!t->needs_spec()) {
+            *status = t->status();
+            continue;
+        }
+
+        // Fetch the spec on the first verb of each lemma that needs it.
+        const string& lemma = vwc.verb().lemma();
+        if (!to_verb_lemma || *to_verb_lemma != lemma) {
+            to_verb = conjugator_->GetVerbSpec(lemma);
+            to_verb_lemma = &lemma;
+        }
+        if (!to_verb) {
+            *status = VSS_ERR_CANT_CONJUGATE_LEMMA;
+            continue;
+        }
+
+        *status = t->status();
+        if (*status == VSS_OK) {
+            t->Render(to_verb.get(), r);
+        }
+    }
+
+    for (auto& status : *statuses) {
+        CountSayStatus(status);
+    }
+}
+
 bool VerbSayer::IsValid(const VerbWithContext& vwc) const {
     // The only way to check validity is to go through the motions of generating
     // the words.
@@ -1,17 +1,20 @@
 #ifndef CC_CORE_LING_VERB_INTERNAL_SAYING_VERB_SAYER_H_
 #define CC_CORE_LING_VERB_INTERNAL_SAYING_VERB_SAYER_H_
 
+#include <memory>
 #include <string>
 #include <vector>
 
 #include "cc/core/ling/verb/internal/conjugation/conjugator.h"
 #include "cc/core/ling/verb/internal/surface/surface_verb_sayer.h"
+#include "cc/core/ling/verb/internal/saying/say_template.h"
 #include "cc/core/ling/verb/internal/saying/verb_converter.h"
 #include "cc/core/ling/verb/verb_say_result.h"
 #include "cc/core/ling/verb/verb_say_status.h"
 #include "cc/core/ling/verb/verb_with_context.h"
 
 using std::string;
+using std::unique_ptr;
 using std::vector;
 
 class VerbSayer {
@@ -23,17 +26,71 @@ class VerbSayer {
         const VerbWithContext& vwc, size_t max_num_results,
         vector<VerbSayResult>* rr) const;
 
+    // The first of GetAllSayOptions(), from a lemma-agnostic template (see
+    // say_template.h) made the first time the verb's other fields are seen.
+    // The result is unspecified on failure.
     VerbSayStatus Say(const VerbWithContext& vwc, VerbSayResult* r) const;
 
+    // Say() each verb, setting (*rr)[i] and (*statuses)[i] (results of failed
+    // verbs are empty).  Verbs are said grouped by lemma, so each lemma's
+    // spec is fetched once.
+    void SayBatch(const VerbWithContext* vwcs, size_t num_vwcs,
+                  vector<VerbSayResult>* rr,
+                  vector<VerbSayStatus>* statuses) const;
+
     bool IsValid(const VerbWithContext& vwc) const;
 
   private:
+    // What the verb converts to on the surface, before picking a mood, modal
+    // and surface tense.
+    struct SurfacePlan {
+        Whether whether;
+        SurfaceVoice voice;
+        SurfaceAspect aspect;
+        SurfaceVerbForm verb_form;
+        Span<MoodModalStense> mmts;
+    };
+
+    // Scratch space for saying a surface verb.
+    struct SayScratch {
+        SurfaceVerb sv;
+        vector<string> words;
+    };
+
+    VerbSayStatus GetSurfacePlan(const VerbWithContext& vwc,
+                                 SurfacePlan* plan) const;
+
+    VerbSayStatus SayOption(
+        const VerbWithContext& vwc, const SurfacePlan& plan,
+        const MoodModalStense& mmt, const ConjugationSpec& to_verb,
+        SayScratch* scratch, VerbSayResult* r) const;
+
     VerbSayStatus SliceVerbWords(
         const vector<string>& ss, bool is_split, bool is_pro_verb,
         bool contract_not, VerbSayResult* r) const;
 
+    // Whether the verb can be said from a template.
+    static bool CanUseSayTemplate(const VerbWithContext& vwc);
+
+    // Get the template for saying the verb, making it if new.  The verb must
+    // be CanUseSayTemplate().  If the cache is full, the template is made into
+    // *uncached instead.
+    const SayTemplate* GetSayTemplate(
+        const VerbWithContext& vwc, unique_ptr<SayTemplate>* uncached) const;
+
+    // Say the first option of the verb the slow way, without templates.
+    VerbSayStatus SayFirstOption(const VerbWithContext& vwc,
+                                 VerbSayResult* r) const;
+
+    // Say the first option of the verb (with its lemma swapped for a stand-in)
+    // into a template.
+    void MakeSayTemplate(const VerbWithContext& vwc, bool is_be,
+                         SayTemplate* t) const;
+
+    const Conjugator* conjugator_;
     VerbConverter conv_;
     SurfaceVerbSayer surface_;
+    mutable SayTemplateCache templates_;
 };
 
 #endif  // CC_CORE_LING_VERB_INTERNAL_SAYING_VERB_SAY_H_
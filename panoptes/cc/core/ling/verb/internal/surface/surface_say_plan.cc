@@ -0,0 +1,92 @@
+#include "surface_say_plan.h"
+
+using std::lock_guard;
+using std::mutex;
+
+// -----------------------------------------------------------------------------
+// SurfaceSayPlan.
+
+void SurfaceSayPlan::Render(const ConjugationSpec& to_verb,
+                            vector<string>* rr) const {
+    rr->resize(steps.size());
+    for (size_t i = 0; i < steps.size(); ++i) {
+        const SurfaceSayStep& step = steps[i];
+        if (step.field_index == SURFACE_SAY_LITERAL) {
+            (*rr)[i] = step.word;
+        } else {
+            to_verb.GetField(step.field_index).AssignTo(&(*rr)[i]);
+        }
+    }
+}
+
+// -----------------------------------------------------------------------------
+// SurfaceSayPlanCache.
+
+static_assert(CONJ_NUM_CONJS <= 8, "Conjugation doesn't fit.");
+static_assert(MOOD_NUM_MOODS <= 4, "Mood doesn't fit.");
+
+uint32_t SurfaceSayPlanCache::GetShape(const SurfaceVerb& v,
+                                       bool has_do_support) {
+    uint32_t r = 0;
+    r = r << 2 | static_cast<uint32_t>(v.whether());
+    r = r << 3 | static_cast<uint32_t>(v.tense());
+    r = r << 1 | static_cast<uint32_t>(v.aspect().is_perf());
+    r = r << 1 | static_cast<uint32_t>(v.aspect().is_prog());
+    r = r << 2 | static_cast<uint32_t>(v.mood());
+    r = r << 3 | static_cast<uint32_t>(v.verb_form());
+    r = r << 1 | static_cast<uint32_t>(v.voice());
+    r = r << 3 | static_cast<uint32_t>(v.conj());
+    r = r << 1 | static_cast<uint32_t>(v.split_inf());
+    r = r << 1 | static_cast<uint32_t>(v.use_were_sbj());
+    r = r << 1 | static_cast<uint32_t>(has_do_support);
+    return r;
+}
+
+void SurfaceSayPlanCache::Clear() {
+    for (auto& shard : shards_) {
+        lock_guard<mutex> lock(shard.mutex);
+        shard.modal2shape2plan.clear();
+        shard.size = 0;
+    }
+}
+
+SurfaceSayPlanCache::Shard* SurfaceSayPlanCache::GetShard(uint32_t shape) {
+    // Knuth's multiplicative hash, as the low bits are the busy ones.
+    return &shards_[((shape * 2654435761u) >> 16) % NUM_SHARDS];
+}
+
+const SurfaceSayPlan* SurfaceSayPlanCache::Get(const string& modal,
+                                               uint32_t shape) {
+    Shard* shard = GetShard(shape);
+    lock_guard<mutex> lock(shard->mutex);
+    auto it = shard->modal2shape2plan.find(modal);
+    if (it == shard->modal2shape2plan.end()) {
+        return NULL;
+    }
+
+    auto it2 = it->second.find(shape);
+    if (it2 == it->second.end()) {
+        return NULL;
+    }
+    return it2->second.get();
+}
+
+const SurfaceSayPlan* SurfaceSayPlanCache::Put(
+        const string& modal, uint32_t shape, unique_ptr<SurfaceSayPlan>* plan) {
+    Shard* shard = GetShard(shape);
+    lock_guard<mutex> lock(shard->mutex);
+    Shape2Plan& shape2plan = shard->modal2shape2plan[modal];
+    auto it = shape2plan.find(shape);
+    if (it != shape2plan.end()) {
+        return it->second.get();
+    }
+
+    if (SURFACE_SAY_PLAN_CACHE_CAPACITY / NUM_SHARDS <= shard->size) {
+        return NULL;
+    }
+
+    unique_ptr<SurfaceSayPlan>& cached = shape2plan[shape];
+    cached.swap(*plan);
+    ++shard->size;
+    return cached.get();
+}
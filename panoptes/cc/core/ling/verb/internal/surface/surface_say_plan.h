@@ -0,0 +1,84 @@
+#ifndef CC_VERB_INTERNAL_SURFACE_SURFACE_SAY_PLAN_H_
+#define CC_VERB_INTERNAL_SURFACE_SURFACE_SAY_PLAN_H_
+
+// Compiled plans for saying SurfaceVerbs.
+//
+// Which words a SurfaceVerb comes out as depends on everything but its lemma,
+// plus whether the lemma has do-support.  The words that aren't the lemma's
+// (modals, auxiliaries, "not", "to") don't depend on the lemma at all.  So
+// each shape of SurfaceVerb is worked out once into a list of steps, each
+// either a finished word or a field of the lemma's spec.
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "cc/core/ling/verb/internal/conjugation/conjugation_spec.h"
+#include "cc/core/ling/verb/internal/surface/surface_verb.h"
+#include "cc/core/ling/verb/verb_say_status.h"
+
+using std::string;
+using std::unique_ptr;
+using std::unordered_map;
+using std::vector;
+
+// Marks a step that says a finished word.
+#define SURFACE_SAY_LITERAL 0xFF
+
+struct SurfaceSayStep {
+    // The word, if literal.
+    string word;
+
+    // Else, the field of the lemma's spec to say.
+    uint8_t field_index;
+};
+
+struct SurfaceSayPlan {
+    // Plans of invalid shapes just hold the error.
+    VerbSayStatus status;
+    vector<SurfaceSayStep> steps;
+
+    // Say the lemma into the (reused) strings of rr.
+    void Render(const ConjugationSpec& to_verb, vector<string>* rr) const;
+};
+
+// Thread-safe SurfaceVerb shape -> SurfaceSayPlan cache, filled on first use.
+// Plans are never evicted, so the pointers handed out stay good until Clear().
+// Past SURFACE_SAY_PLAN_CACHE_CAPACITY, new plans are not kept.
+#define SURFACE_SAY_PLAN_CACHE_CAPACITY (1 << 18)
+
+class SurfaceSayPlanCache {
+  public:
+    // Pack the shape of the verb, apart from its modal, into an int.
+    static uint32_t GetShape(const SurfaceVerb& v, bool has_do_support);
+
+    void Clear();
+
+    // Returns NULL on a miss.
+    const SurfaceSayPlan* Get(const string& modal, uint32_t shape);
+
+    // Cache the plan, taking it.  Returns the cached plan for the key (another
+    // thread's, if it got there first), or NULL if full.
+    const SurfaceSayPlan* Put(const string& modal, uint32_t shape,
+                              unique_ptr<SurfaceSayPlan>* plan);
+
+  private:
+    static const size_t NUM_SHARDS = 16;
+
+    typedef unordered_map<uint32_t, unique_ptr<SurfaceSayPlan> > Shape2Plan;
+
+    struct Shard {
+        std::mutex mutex;
+        unordered_map<string, Shape2Plan> modal2shape2plan;
+        size_t size = 0;
+    };
+
+    Shard* GetShard(uint32_t shape);
+
+    Shard shards_[NUM_SHARDS];
+};
+
+#endif  // CC_VERB_INTERNAL_SURFACE_SURFACE_SAY_PLAN_H_
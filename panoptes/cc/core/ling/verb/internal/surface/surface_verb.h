@@ -50,7 +50,8 @@ enum Mood {
     MOOD_IND,      // The normal mood: "They [went]."
     MOOD_IMP,      // Imperative: "[Go]."
     MOOD_SBJ_IMP,  // 'Subjunctive-imperative: "She requests you [come]."
-    MOOD_SBJ_CF    // Subjunctive-counterfactual: "Wish you [were] here."
+    MOOD_SBJ_CF,   // Subjunctive-counterfactual: "Wish you [were] here."
+    MOOD_NUM_MOODS
 };
 
 enum SurfaceVerbForm {
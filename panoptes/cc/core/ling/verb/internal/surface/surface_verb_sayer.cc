@@ -1,11 +1,18 @@
 #include "surface_verb_sayer.h"
 
+#include <memory>
+
 #include "cc/base/file.h"
+#include "cc/base/metrics.h"
 #include "cc/base/table_util.h"
 
+using std::shared_ptr;
+using std::unique_ptr;
+
 bool SurfaceVerbSayer::Init(
         const Conjugator* c, const string& modal_past_tense_f) {
     conjugator_ = c;
+    plans_.Clear();
 
     string s;
     File::FileToString(modal_past_tense_f, &s);
@@ -15,7 +22,8 @@ bool SurfaceVerbSayer::Init(
 void SurfaceVerbSayer::SaySbjFut(
         const SurfaceVerb& v, vector<VerbField>* ff) const {
     Conjugation use_conj = v.use_were_sbj() ? CONJ_P2 : v.conj();
-    const string& were_or_was = conjugator_->to_be().past()[use_conj];
+    unsigned past_x = 9u + static_cast<unsigned>(use_conj);
+    string were_or_was = conjugator_->to_be().GetField(past_x).ToString();
     ff->insert(ff->begin(), VerbField("to", 0));
     ff->insert(ff->begin(), VerbField(were_or_was, 0));
 
@@ -26,7 +34,7 @@ void SurfaceVerbSayer::SaySbjFut(
 }
 
 void SurfaceVerbSayer::SayNormal(
-        const SurfaceVerb& v, const ConjugationSpec& to_verb, bool use_perf,
+        const SurfaceVerb& v, bool has_do_support, bool use_perf,
         vector<VerbField>* ff) const {
     // Add "do".
     if (v.IsFinite()) {
@@ -34,7 +42,7 @@ void SurfaceVerbSayer::SayNormal(
             bool mood_is_ok = v.mood() == MOOD_IND;
             bool already_has_an_aux =
                 (v.modal().size() || use_perf || v.aspect().is_prog());
-            bool can_use_do = to_verb.has_do_support() &&
+            bool can_use_do = has_do_support &&
                               v.voice() == SV_ACTIVE;
             if (mood_is_ok && !already_has_an_aux && can_use_do) {
                 ff->insert(ff->begin(), VerbField("do", ~0u));
@@ -99,9 +107,21 @@ void SurfaceVerbSayer::SayNormal(
 
 VerbSayStatus SurfaceVerbSayer::Say(
         const SurfaceVerb& v, vector<string>* rr) const {
-    VerbSayStatus err = conv_.MightBeValid(v);
-    if (err != VSS_OK) {
-        return err;
+    shared_ptr<const ConjugationSpec> to_verb =
+        conjugator_->GetVerbSpec(v.lemma());
+    if (!to_verb) {
+        return VSS_ERR_CANT_CONJUGATE_LEMMA;
+    }
+    return Say(v, *to_verb, rr);
+}
+
+void SurfaceVerbSayer::CompilePlan(
+        const SurfaceVerb& v, bool has_do_support,
+        SurfaceSayPlan* plan) const {
+    plan->steps.clear();
+    plan->status = conv_.MightBeValid(v);
+    if (plan->status != VSS_OK) {
+        return;
     }
 
     // The past tense of "can" is "could", etc.
@@ -109,13 +129,10 @@ VerbSayStatus SurfaceVerbSayer::Say(
     bool use_perf;
     if (!conv_.HandleModalPastTense(v.modal(), v.tense(), v.aspect().is_perf(),
                                     &use_modal, &use_perf)) {
-        return VSS_INVALID_MODAL_IS_UNKNOWN;
+        plan->status = VSS_INVALID_MODAL_IS_UNKNOWN;
+        return;
     }
 
-    // Create the conjugation plan for the verb.
-    ConjugationSpec to_verb;
-    conjugator_->CreateVerbSpec(v.lemma(), &to_verb);
-
     // List the verb specs to pick the correct forms of.
     vector<VerbField> ff;
     if (use_modal.size()) {
@@ -130,7 +147,7 @@ VerbSayStatus SurfaceVerbSayer::Say(
     if (v.voice() == SV_PASSIVE) {
         ff.emplace_back(VerbField("be", ~0u));
     }
-    ff.emplace_back(VerbField(v.lemma(), ~0u));
+    ff.emplace_back(VerbField("", ~0u, true));
 
 /*
     printf("Initial choices:\n");
@@ -145,7 +162,7 @@ VerbSayStatus SurfaceVerbSayer::Say(
     if (v.mood() == MOOD_SBJ_CF && v.tense() == ST_SBJ_FUT) {
         SaySbjFut(v, &ff);
     } else {
-        SayNormal(v, to_verb, use_perf, &ff);
+        SayNormal(v, has_do_support, use_perf, &ff);
     }
 
     // Get the index of the end of the infinitives (exclusive).
@@ -182,26 +199,61 @@ VerbSayStatus SurfaceVerbSayer::Say(
     printf("\n");
 */
 
-    // Render the words.
-    rr->clear();
-    rr->reserve(ff.size());
+    // Conjugate everything but the verb's own words, which are left to Render.
+    plan->steps.resize(ff.size());
     for (unsigned i = 0; i < ff.size(); ++i) {
-        string s;
-        conjugator_->Conjugate(ff[i].lemma, ff[i].field_index, &s);
-        rr->emplace_back(s);
+        const VerbField& f = ff[i];
+        SurfaceSayStep* step = &plan->steps[i];
+        if (f.is_verb) {
+            step->field_index = static_cast<uint8_t>(f.field_index);
+            continue;
+        }
+        step->field_index = SURFACE_SAY_LITERAL;
+        if (!conjugator_->Conjugate(f.lemma, f.field_index, &step->word)) {
+            plan->steps.clear();
+            plan->status = VSS_ERR_CANT_CONJUGATE_LEMMA;
+            return;
+        }
     }
 
     // There are two kinds of finite.  Make modifications for the weird kind of
     // finite if necessary where you drop a passivization word when the relative
     // pronoun is a zero (eg. "the cat that [was seen] by you" vs "the cat
-    // [seen] by you").  Passives only!
+    // [seen] by you").  Passives only!  In passives, the verb always comes
+    // after a "be", so the front word is never the verb's own.
     if (v.verb_form() == SVF_ZERO_RELCLAUSE_FINITE && v.voice() == SV_PASSIVE) {
-          const string& s = (*rr)[0];
+          const string& s = plan->steps[0].word;
           if (s == "is" || s == "are" || s == "was" || s == "were") {
-                rr->erase(rr->begin());
+                plan->steps.erase(plan->steps.begin());
           }
     }
+}
+
+VerbSayStatus SurfaceVerbSayer::Say(
+        const SurfaceVerb& v, const ConjugationSpec& to_verb,
+        vector<string>* rr) const {
+    static Histogram* latency =
+        Metrics::GetHistogram("surface_verb_sayer.say_ns");
+    ScopedLatency timer(latency);
+
+    uint32_t shape =
+        SurfaceSayPlanCache::GetShape(v, to_verb.has_do_support());
+    const SurfaceSayPlan* plan = plans_.Get(v.modal(), shape);
+    unique_ptr<SurfaceSayPlan> uncached;
+    if (!plan) {
+        uncached.reset(new SurfaceSayPlan());
+        CompilePlan(v, to_verb.has_do_support(), uncached.get());
+        plan = plans_.Put(v.modal(), shape, &uncached);
+        if (!plan) {
+            plan = uncached.get();
+        }
+    }
+
+    if (plan->status != VSS_OK) {
+        return plan->status;
+    }
 
+    plan->Render(to_verb, rr);
     return VSS_OK;
 }
 
@@ -8,17 +8,20 @@
 // verbs is very complicated.
 
 #include <string>
+#include <vector>
 
 #include "cc/core/ling/verb/internal/conjugation/conjugator.h"
+#include "cc/core/ling/verb/internal/surface/surface_say_plan.h"
 #include "cc/core/ling/verb/internal/surface/surface_verb.h"
 #include "cc/core/ling/verb/internal/surface/surface_verb_converter.h"
 #include "cc/core/ling/verb/verb_say_status.h"
 
 using std::string;
+using std::vector;
 
 // A list of these make up the raw material for building conjugated verb words.
 struct VerbField {
-    // Lemma of the verb to conjugate.
+    // Lemma of the verb to conjugate (unused if it's the verb being said).
     string lemma;
 
     // Field index in the flattened verb sepc for the lemma.
@@ -27,13 +30,19 @@ struct VerbField {
     // a raw word.
     unsigned field_index;
 
-    VerbField(string l, unsigned fi) {
+    // Whether it's the verb being said, whose words are left to the plan's
+    // caller.
+    bool is_verb;
+
+    VerbField(const string& l, unsigned fi, bool iv = false) {
         lemma = l;
         field_index = fi;
+        is_verb = iv;
     }
 
     void Dump() {
-        printf("(lemma=%s fi=%u)", lemma.c_str(), field_index);
+        printf("(lemma=%s fi=%u)", is_verb ? "<verb>" : lemma.c_str(),
+               field_index);
     }
 };
 
@@ -46,14 +55,25 @@ class SurfaceVerbSayer {
 
     VerbSayStatus Say(const SurfaceVerb& v, vector<string>* rr) const;
 
+    // Same, given the lemma's spec, for saying many verbs of one lemma.  Reuses
+    // the strings already in rr.  The verb's shape is compiled into a plan the
+    // first time it is seen (see surface_say_plan.h).
+    VerbSayStatus Say(const SurfaceVerb& v, const ConjugationSpec& to_verb,
+                      vector<string>* rr) const;
+
   private:
     void SaySbjFut(const SurfaceVerb& v, vector<VerbField>* ff) const;
 
-    void SayNormal(const SurfaceVerb& v, const ConjugationSpec& to_verb,
-                                  bool use_perf, vector<VerbField>* ff) const;
+    void SayNormal(const SurfaceVerb& v, bool has_do_support, bool use_perf,
+                   vector<VerbField>* ff) const;
+
+    // Work out the words of the verb's shape.
+    void CompilePlan(const SurfaceVerb& v, bool has_do_support,
+                     SurfaceSayPlan* plan) const;
 
     const Conjugator* conjugator_;
     SurfaceVerbConverter conv_;
+    mutable SurfaceSayPlanCache plans_;
 };
 
 #endif  // CC_VERB_INTERNAL_SURFACE_SURFACE_VERB_SAYER_H_
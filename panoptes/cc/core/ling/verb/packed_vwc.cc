@@ -0,0 +1,127 @@
+#include "packed_vwc.h"
+
+#include <cassert>
+
+#include "cc/base/throol.h"
+
+static_assert(sizeof(PackedVWC) == 8, "PackedVWC must stay two words.");
+
+// Fields are packed from the least significant bit up, in FlatVWCField order,
+// each in just enough bits for its values:
+//
+//   field              bits  values
+//   FLAT_TF               1  bool
+//   FLAT_IS_CONTRARY      2  throol
+//   FLAT_TENSE            2  Tense
+//   FLAT_IS_PERF          1  bool
+//   FLAT_IS_PROG          1  bool
+//   FLAT_FLAVOR           4  ModalFlavor
+//   FLAT_IS_COND          1  bool
+//   FLAT_VERB_FORM        3  VerbForm
+//   FLAT_IS_PRO_VERB      1  bool
+//   FLAT_VOICE            2  Voice
+//   FLAT_CONJ             3  Conjugation
+//   FLAT_IS_SPLIT         1  bool
+//   FLAT_REL_CONT         2  RelativeContainment
+//   FLAT_CONTRACT_NOT     2  throol
+//   FLAT_SPLIT_INF        2  throol
+//   FLAT_SBJ_HANDLING     2  SubjunctiveHandling
+//
+// Enums have room for their NUM value too, which lookup tables use as the
+// wildcard (written as "UNKNOWN").  Throols take 0 to 2, plus THROOL_INVALID
+// (unset), which is packed as 3.
+
+static_assert(FLAT_NUM_FLATS == 17, "Update the PackedVWC layout.");
+static_assert(T_NUM_TENSES < 4, "Tense doesn't fit.");
+static_assert(MF_NUM_FLAVORS < 16, "ModalFlavor doesn't fit.");
+static_assert(VF_NUM_VERB_FORMS < 8, "VerbForm doesn't fit.");
+static_assert(V_NUM_VOICES < 4, "Voice doesn't fit.");
+static_assert(CONJ_NUM_CONJS < 8, "Conjugation doesn't fit.");
+static_assert(RC_NUM_REL_CONTS < 4, "RelativeContainment doesn't fit.");
+static_assert(SH_NUM_SBJ_HANDLINGS < 4, "SubjunctiveHandling doesn't fit.");
+
+#define PACKED_THROOL_INVALID 3
+
+namespace {
+
+enum PackedFieldKind {
+    PFK_LEMMA,  // Kept apart.
+    PFK_BOOL,
+    PFK_THROOL,
+    PFK_ENUM
+};
+
+struct PackedField {
+    PackedFieldKind kind;
+    uint8_t num_bits;
+};
+
+// By FlatVWCField.
+const PackedField FIELDS[FLAT_NUM_FLATS] = {
+    {PFK_LEMMA,  0},  // FLAT_LEMMA
+    {PFK_BOOL,   1},  // FLAT_TF
+    {PFK_THROOL, 2},  // FLAT_IS_CONTRARY
+    {PFK_ENUM,   2},  // FLAT_TENSE
+    {PFK_BOOL,   1},  // FLAT_IS_PERF
+    {PFK_BOOL,   1},  // FLAT_IS_PROG
+    {PFK_ENUM,   4},  // FLAT_FLAVOR
+    {PFK_BOOL,   1},  // FLAT_IS_COND
+    {PFK_ENUM,   3},  // FLAT_VERB_FORM
+    {PFK_BOOL,   1},  // FLAT_IS_PRO_VERB
+    {PFK_ENUM,   2},  // FLAT_VOICE
+    {PFK_ENUM,   3},  // FLAT_CONJ
+    {PFK_BOOL,   1},  // FLAT_IS_SPLIT
+    {PFK_ENUM,   2},  // FLAT_REL_CONT
+    {PFK_THROOL, 2},  // FLAT_CONTRACT_NOT
+    {PFK_THROOL, 2},  // FLAT_SPLIT_INF
+    {PFK_ENUM,   2}   // FLAT_SBJ_HANDLING
+};
+
+}  // namespace
+
+void PackedVWC::InitFromArray(const uint8_t* values, uint32_t new_lemma_id) {
+    lemma_id = new_lemma_id;
+    fields = 0;
+    uint32_t shift = 0;
+    for (size_t f = FLAT_LEMMA + 1; f < FLAT_NUM_FLATS; ++f) {
+        const PackedField& field = FIELDS[f];
+        uint32_t value = values[f];
+        if (field.kind == PFK_BOOL) {
+            // As VerbWithContext takes them.
+            value = value != 0;
+        } else if (field.kind == PFK_THROOL && value == THROOL_INVALID) {
+            value = PACKED_THROOL_INVALID;
+        }
+        assert(value < (1u << field.num_bits));
+        fields |= value << shift;
+        shift += field.num_bits;
+    }
+}
+
+void PackedVWC::InitFromVWC(const VerbWithContext& vwc,
+                            uint32_t new_lemma_id) {
+    uint8_t values[FLAT_NUM_FLATS];
+    vwc.ToArray(values);
+    InitFromArray(values, new_lemma_id);
+}
+
+void PackedVWC::ToArray(uint8_t* values) const {
+    values[FLAT_LEMMA] = 0;
+    uint32_t shift = 0;
+    for (size_t f = FLAT_LEMMA + 1; f < FLAT_NUM_FLATS; ++f) {
+        const PackedField& field = FIELDS[f];
+        uint32_t mask = (1u << field.num_bits) - 1;
+        uint8_t value = static_cast<uint8_t>((fields >> shift) & mask);
+        if (field.kind == PFK_THROOL && value == PACKED_THROOL_INVALID) {
+            value = THROOL_INVALID;
+        }
+        values[f] = value;
+        shift += field.num_bits;
+    }
+}
+
+void PackedVWC::ToVWC(const string& lemma, VerbWithContext* vwc) const {
+    uint8_t values[FLAT_NUM_FLATS];
+    ToArray(values);
+    vwc->InitFromArray(values, lemma);
+}
@@ -0,0 +1,63 @@
+#ifndef CC_CORE_LING_VERB_PACKED_VWC_H_
+#define CC_CORE_LING_VERB_PACKED_VWC_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "cc/core/ling/verb/internal/parsing/flat_vwc_fields.h"
+#include "cc/core/ling/verb/verb_with_context.h"
+
+using std::string;
+
+// A VerbWithContext in eight bytes: the lemma as an id into whatever list of
+// lemmas the holder keeps, and every other field bit-packed into one word (see
+// the .cc for the layout).  Plain data, so it can be copied and written out as
+// bytes, and compared and hashed as integers.
+struct PackedVWC {
+    uint32_t lemma_id;
+    uint32_t fields;
+
+    // From flat values as in VerbWithContext::ToArray() (the lemma field is
+    // ignored).
+    void InitFromArray(const uint8_t* values, uint32_t lemma_id);
+
+    void InitFromVWC(const VerbWithContext& vwc, uint32_t lemma_id);
+
+    // Inverse of InitFromArray() (the lemma field is set to 0).
+    void ToArray(uint8_t* values) const;
+
+    void ToVWC(const string& lemma, VerbWithContext* vwc) const;
+
+    uint64_t ToUInt64() const {
+        return static_cast<uint64_t>(lemma_id) << 32 | fields;
+    }
+
+    bool operator==(const PackedVWC& other) const {
+        return lemma_id == other.lemma_id && fields == other.fields;
+    }
+
+    bool operator!=(const PackedVWC& other) const {
+        return !(*this == other);
+    }
+
+    bool operator<(const PackedVWC& other) const {
+        return ToUInt64() < other.ToUInt64();
+    }
+};
+
+// For unordered containers of PackedVWCs.
+struct PackedVWCHash {
+    size_t operator()(const PackedVWC& vwc) const {
+        // The MurmurHash3 finalizer.
+        uint64_t h = vwc.ToUInt64();
+        h ^= h >> 33;
+        h *= 0xff51afd7ed558ccdull;
+        h ^= h >> 33;
+        h *= 0xc4ceb9fe1a85ec53ull;
+        h ^= h >> 33;
+        return static_cast<size_t>(h);
+    }
+};
+
+#endif  // CC_CORE_LING_VERB_PACKED_VWC_H_
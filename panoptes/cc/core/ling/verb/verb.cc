@@ -26,28 +26,32 @@ void Polarity::Init(bool p, throol ic) {
     is_contrary_ = ic;
 }
 
+struct Polarity::JSONFields {
+    typedef json::Schema<Polarity,
+        JSON_FIELD(Polarity, tf_),
+        JSON_FIELD(Polarity, is_contrary_)
+    > Schema;
+
+    static const Schema& Get() {
+        static const Schema schema("tf", "is_contrary");
+        return schema;
+    }
+};
+
 void Polarity::ToJSON(string* s) const {
-    string is_contrary_s;
-    json::ToJSON(s,
-        json::BOOL,  "tf",          tf_,
-        json::CHARS, "is_contrary", is_contrary_.ToStr()
-    );
+    json::ToJSON(*this, s);
 }
 
-bool Polarity::FromJSON(const string& s) {
-    string is_contrary_s;
-    if (!json::FromJSON(s,
-        json::BOOL, "tf",          &tf_,
-        json::STR,  "is_contrary", &is_contrary_s
-    )) {
-        return false;
-    }
+void Polarity::ToJSON(json::Writer* w) const {
+    JSONFields::Get().Write(*this, w);
+}
 
-    if (!is_contrary_.FromStr(is_contrary_s)) {
-        return false;
-    }
+bool Polarity::FromJSON(const string& s) {
+    return json::FromJSON(s, this);
+}
 
-    return true;
+bool Polarity::FromJSON(const json::Value& v) {
+    return JSONFields::Get().Read(v, this);
 }
 
 // -----------------------------------------------------------------------------
@@ -57,18 +61,32 @@ void Aspect::Init(bool is_perf, bool is_prog) {
     is_prog_ = is_prog;
 }
 
+struct Aspect::JSONFields {
+    typedef json::Schema<Aspect,
+        JSON_FIELD(Aspect, is_perf_),
+        JSON_FIELD(Aspect, is_prog_)
+    > Schema;
+
+    static const Schema& Get() {
+        static const Schema schema("is_perf", "is_prog");
+        return schema;
+    }
+};
+
 void Aspect::ToJSON(string* s) const {
-    json::ToJSON(s,
-        json::BOOL, "is_perf", is_perf_,
-        json::BOOL, "is_prog", is_prog_
-    );
+    json::ToJSON(*this, s);
+}
+
+void Aspect::ToJSON(json::Writer* w) const {
+    JSONFields::Get().Write(*this, w);
 }
 
 bool Aspect::FromJSON(const string& s) {
-    return json::FromJSON(s,
-        json::BOOL, "is_perf", &is_perf_,
-        json::BOOL, "is_prog", &is_prog_
-    );
+    return json::FromJSON(s, this);
+}
+
+bool Aspect::FromJSON(const json::Value& v) {
+    return JSONFields::Get().Read(v, this);
 }
 
 // -----------------------------------------------------------------------------
@@ -78,27 +96,32 @@ void Modality::Init(ModalFlavor f, bool ic) {
     is_cond_ = ic;
 }
 
+struct Modality::JSONFields {
+    typedef json::Schema<Modality,
+        JSON_ENUM_FIELD(Modality, flavor_, ModalFlavorStrings),
+        JSON_FIELD(Modality, is_cond_)
+    > Schema;
+
+    static const Schema& Get() {
+        static const Schema schema("flavor", "is_cond");
+        return schema;
+    }
+};
+
 void Modality::ToJSON(string* s) const {
-    json::ToJSON(s,
-        json::STR,  "flavor",  ModalFlavorStrings.GetString(flavor_),
-        json::BOOL, "is_cond", is_cond_
-    );
+    json::ToJSON(*this, s);
 }
 
-bool Modality::FromJSON(const string& s) {
-    string flavor_s;
-    if (!json::FromJSON(s,
-        json::STR,  "flavor",  &flavor_s,
-        json::BOOL, "is_cond", &is_cond_
-    )) {
-        return false;
-    }
+void Modality::ToJSON(json::Writer* w) const {
+    JSONFields::Get().Write(*this, w);
+}
 
-    if (!ModalFlavorStrings.MaybeGetEnumValue(flavor_s, &flavor_)) {
-        return false;
-    }
+bool Modality::FromJSON(const string& s) {
+    return json::FromJSON(s, this);
+}
 
-    return true;
+bool Modality::FromJSON(const json::Value& v) {
+    return JSONFields::Get().Read(v, this);
 }
 
 // -----------------------------------------------------------------------------
@@ -126,66 +149,39 @@ bool Verb::IsFinite() const {
     return verb_form_ == VF_FINITE;
 }
 
-void Verb::ToJSON(string* s) const {
-    string polarity_s;
-    polarity_.ToJSON(&polarity_s);
-
-    string aspect_s;
-    aspect_.ToJSON(&aspect_s);
+struct Verb::JSONFields {
+    typedef json::Schema<Verb,
+        JSON_FIELD(Verb, lemma_),
+        JSON_FIELD(Verb, polarity_),
+        JSON_ENUM_FIELD(Verb, tense_, TenseStrings),
+        JSON_FIELD(Verb, aspect_),
+        JSON_FIELD(Verb, modality_),
+        JSON_ENUM_FIELD(Verb, verb_form_, VerbFormStrings),
+        JSON_FIELD(Verb, is_pro_verb_)
+    > Schema;
+
+    static const Schema& Get() {
+        static const Schema schema(
+            "lemma", "polarity", "tense", "aspect", "modality", "verb_form",
+            "is_pro_verb");
+        return schema;
+    }
+};
 
-    string modality_s;
-    modality_.ToJSON(&modality_s);
+void Verb::ToJSON(string* s) const {
+    json::ToJSON(*this, s);
+}
 
-    json::ToJSON(s,
-        json::STR,    "lemma",       lemma_,
-        json::OBJECT, "polarity",    polarity_s,
-        json::STR,    "tense",       TenseStrings.GetString(tense_),
-        json::OBJECT, "aspect",      aspect_s,
-        json::OBJECT, "modality",    modality_s,
-        json::STR,    "verb_form",   VerbFormStrings.GetString(verb_form_),
-        json::BOOL,   "is_pro_verb", is_pro_verb_
-    );
+void Verb::ToJSON(json::Writer* w) const {
+    JSONFields::Get().Write(*this, w);
 }
 
 bool Verb::FromJSON(const string& s) {
-    string polarity_s;
-    string tense_s;
-    string aspect_s;
-    string modality_s;
-    string verb_form_s;
-    if (!json::FromJSON(s,
-        json::STR,    "lemma",       &lemma_,
-        json::OBJECT, "polarity",    &polarity_s,
-        json::STR,    "tense",       &tense_s,
-        json::OBJECT, "aspect",      &aspect_s,
-        json::OBJECT, "modality",    &modality_s,
-        json::STR,    "verb_form",   &verb_form_s,
-        json::BOOL,   "is_pro_verb", &is_pro_verb_
-    )) {
-        return false;
-    }
-
-    if (!polarity_.FromJSON(polarity_s)) {
-        return false;
-    }
-
-    if (!TenseStrings.MaybeGetEnumValue(tense_s, &tense_)) {
-        return false;
-    }
-
-    if (!aspect_.FromJSON(aspect_s)) {
-        return false;
-    }
-
-    if (!modality_.FromJSON(modality_s)) {
-        return false;
-    }
-
-    if (!VerbFormStrings.MaybeGetEnumValue(verb_form_s, &verb_form_)) {
-        return false;
-    }
+    return json::FromJSON(s, this);
+}
 
-    return true;
+bool Verb::FromJSON(const json::Value& v) {
+    return JSONFields::Get().Read(v, this);
 }
 
 bool Verb::HasUnsetFields() const {
@@ -5,6 +5,8 @@
 
 #include "cc/base/enum_strings.h"
 #include "cc/base/throol.h"
+#include "cc/format/json_tape.h"
+#include "cc/format/json_writer.h"
 
 using std::string;
 
@@ -19,9 +21,14 @@ class Polarity {
     void Init(bool p, throol ic);
 
     void ToJSON(string* s) const;
+    void ToJSON(json::Writer* w) const;
     bool FromJSON(const string& s);
+    bool FromJSON(const json::Value& v);
 
   private:
+    // JSON layout (see the .cc).
+    struct JSONFields;
+
     // "You said" vs "You didn't say".
     bool tf_;
 
@@ -43,9 +50,14 @@ class Aspect {
     void Init(bool is_perf, bool is_prog);
 
     void ToJSON(string* s) const;
+    void ToJSON(json::Writer* w) const;
     bool FromJSON(const string& s);
+    bool FromJSON(const json::Value& v);
 
   private:
+    // JSON layout (see the .cc).
+    struct JSONFields;
+
     bool is_perf_;
     bool is_prog_;
 };
@@ -94,9 +106,14 @@ class Modality {
     void Init(ModalFlavor f, bool ic);
 
     void ToJSON(string* s) const;
+    void ToJSON(json::Writer* w) const;
     bool FromJSON(const string& s);
+    bool FromJSON(const json::Value& v);
 
   private:
+    // JSON layout (see the .cc).
+    struct JSONFields;
+
     ModalFlavor flavor_;
     bool is_cond_;
 };
@@ -145,11 +162,16 @@ class Verb {
     bool IsFinite() const;
 
     void ToJSON(string* s) const;
+    void ToJSON(json::Writer* w) const;
     bool FromJSON(const string& s);
+    bool FromJSON(const json::Value& v);
 
     bool HasUnsetFields() const;
 
   private:
+    // JSON layout (see the .cc).
+    struct JSONFields;
+
     string lemma_;  // Blank if pro-verb.
     Polarity polarity_;
     Tense tense_;
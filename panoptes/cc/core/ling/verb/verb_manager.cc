@@ -1,18 +1,32 @@
 #include "verb_manager.h"
 
+#include "cc/base/metrics.h"
+
 bool VerbManager::Init(
         const string& conjugations_f, const string& modal_past_tense_f,
         const string& modalities_f, const string& verb_parses_f) {
-    if (!conjugator_.InitFromFile(conjugations_f)) {
-        return false;
+    {
+        ScopedLatency timer(
+            Metrics::GetHistogram("verb_manager.init.conjugator_ns"));
+        if (!conjugator_.InitFromFile(conjugations_f)) {
+            return false;
+        }
     }
 
-    if (!sayer_.Init(&conjugator_, modalities_f, modal_past_tense_f)) {
-        return false;
+    {
+        ScopedLatency timer(
+            Metrics::GetHistogram("verb_manager.init.sayer_ns"));
+        if (!sayer_.Init(&conjugator_, modalities_f, modal_past_tense_f)) {
+            return false;
+        }
     }
 
-    if (!parser_.Init(&conjugator_, verb_parses_f, &sayer_)) {
-        return false;
+    {
+        ScopedLatency timer(
+            Metrics::GetHistogram("verb_manager.init.parser_ns"));
+        if (!parser_.Init(&conjugator_, verb_parses_f, &sayer_)) {
+            return false;
+        }
     }
 
     return true;
@@ -33,9 +47,18 @@ VerbSayStatus VerbManager::Say(
     return sayer_.Say(vwc, r);
 }
 
+void VerbManager::SayBatch(const VerbWithContext* vwcs, size_t num_vwcs,
+                           vector<VerbSayResult>* rr,
+                           vector<VerbSayStatus>* statuses) const {
+    sayer_.SayBatch(vwcs, num_vwcs, rr, statuses);
+}
+
 void VerbManager::Parse(
         const VerbSayResult& vsr, vector<VerbWithContext>* vwcs) const {
-    printf("VerbManager::Parse()\n");
-    vsr.Dump();
     parser_.Parse(vsr, vwcs);
 }
+
+void VerbManager::ParseBatch(const VerbSayResult* vsrs, size_t num_vsrs,
+                             VerbParseArena* arena) const {
+    parser_.ParseBatch(vsrs, num_vsrs, arena);
+}
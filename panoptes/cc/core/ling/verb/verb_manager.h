@@ -4,12 +4,15 @@
 #include "cc/core/ling/verb/internal/conjugation/conjugator.h"
 #include "cc/core/ling/verb/internal/parsing/verb_parser.h"
 #include "cc/core/ling/verb/internal/saying/verb_sayer.h"
+#include "cc/core/ling/verb/verb_parse_arena.h"
 #include "cc/core/ling/verb/verb_say_result.h"
 #include "cc/core/ling/verb/verb_say_status.h"
 #include "cc/core/ling/verb/verb_with_context.h"
 
 class VerbManager {
   public:
+    const Conjugator& conjugator() const { return conjugator_; }
+
     bool Init(const string& conjugations_f, const string& modal_past_tense_f,
               const string& modalities_f, const string& verb_parses_f);
 
@@ -21,8 +24,17 @@ class VerbManager {
 
     VerbSayStatus Say(const VerbWithContext& vwc, VerbSayResult* r) const;
 
+    // Say many at once (see VerbSayer::SayBatch).
+    void SayBatch(const VerbWithContext* vwcs, size_t num_vwcs,
+                  vector<VerbSayResult>* rr,
+                  vector<VerbSayStatus>* statuses) const;
+
     void Parse(const VerbSayResult& vsr, vector<VerbWithContext>* vwcs) const;
 
+    // Parse many at once into a reusable arena (see VerbParseArena).
+    void ParseBatch(const VerbSayResult* vsrs, size_t num_vsrs,
+                    VerbParseArena* arena) const;
+
   private:
     Conjugator conjugator_;
     VerbSayer sayer_;
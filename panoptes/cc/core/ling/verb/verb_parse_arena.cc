@@ -0,0 +1,17 @@
+#include "verb_parse_arena.h"
+
+void VerbParseArena::Clear() {
+    verbs.clear();
+    offsets.clear();
+}
+
+void VerbParseArena::Reset() {
+    Clear();
+    lemmas.Clear();
+}
+
+void VerbParseArena::GetVerbWithContext(
+        size_t index, VerbWithContext* vwc) const {
+    const PackedVWC& verb = verbs[index];
+    verb.ToVWC(lemma(verb.lemma_id), vwc);
+}
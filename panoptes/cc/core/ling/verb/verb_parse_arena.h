@@ -0,0 +1,48 @@
+#ifndef CC_CORE_LING_VERB_VERB_PARSE_ARENA_H_
+#define CC_CORE_LING_VERB_VERB_PARSE_ARENA_H_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "cc/ds/string_interner.h"
+#include "cc/core/ling/verb/internal/conjugation/conjugator.h"
+#include "cc/core/ling/verb/packed_vwc.h"
+#include "cc/core/ling/verb/verb_with_context.h"
+
+using std::string;
+using std::vector;
+
+// Where VerbManager::ParseBatch() writes its results.  Keep one around and
+// reuse it: once its buffers have grown to fit and its lemmas have been seen,
+// parsing allocates nothing.
+struct VerbParseArena {
+    // The parses of input i are verbs[offsets[i]] up to verbs[offsets[i + 1]].
+    // Their lemma ids index lemmas.
+    vector<PackedVWC> verbs;
+    vector<size_t> offsets;
+
+    // Lemma id -> lemma.  Ids stay good across batches until Reset().
+    StringInterner lemmas;
+
+    // Scratch space for the parser.
+    vector<uint32_t> key;
+    IdentifyWordScratch identify_scratch;
+    vector<LemmaViewAndIndex> lemmas_indexes;
+    string scratch_lemma;
+
+    const string& lemma(uint32_t lemma_id) const {
+        return lemmas.strings()[lemma_id];
+    }
+
+    // Forget the results, keeping the lemmas and all buffers.
+    void Clear();
+
+    // Also forget the lemmas.
+    void Reset();
+
+    // Get a parse as a VerbWithContext.
+    void GetVerbWithContext(size_t index, VerbWithContext* vwc) const;
+};
+
+#endif  // CC_CORE_LING_VERB_VERB_PARSE_ARENA_H_
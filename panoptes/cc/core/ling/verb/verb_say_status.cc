@@ -0,0 +1,18 @@
+#include "verb_say_status.h"
+
+EnumStrings<VerbSayStatus> VerbSayStatusStrings = EnumStrings<VerbSayStatus>(
+    "OK "
+    "INVALID_REL_CLAUSES_CAN_ONLY_CONTAIN_FINITE "
+    "ERR_HAS_UNSET_FIELDS "
+    "INVALID_RELATIVE_PRO_VERB_CONFLICT "
+    "INVALID_CAN_ONLY_SPLIT_FINITE "
+    "INVALID_IF_NON_FINITE_MODALITY_MUST_BE_INDICATIVE "
+    "ERR_NO_VERB_WORDS "
+    "ERR_MULTIPLE_NOTS "
+    "INVALID_CONDITIONAL_FORM_OF_MODALITY_DNE "
+    "INVALID_CANT_HAVE_BOTH_MODALS_AND_NON_IND "
+    "INVALID_IMPERATIVES_ARE_2ND_PERSON "
+    "SURFACE_TENSE_NOT_OK_WITH_MOOD "
+    "INVALID_NON_FINITES_CANT_HAVE_MOODS_OR_MODALS "
+    "INVALID_MODAL_IS_UNKNOWN "
+    "ERR_CANT_CONJUGATE_LEMMA");
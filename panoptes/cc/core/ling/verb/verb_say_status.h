@@ -1,6 +1,8 @@
 #ifndef VERB_SAY_STATUS
 #define VERB_SAY_STATUS
 
+#include "cc/base/enum_strings.h"
+
 // OK is good.
 // ERR means avoidable programming error.
 // INVALID means bad (non-productive) verb configuration.
@@ -60,7 +62,12 @@ enum VerbSayStatus {
     // Surface saying.
 
     // No past tense form for the given modal.
-    VSS_INVALID_MODAL_IS_UNKNOWN = 13
+    VSS_INVALID_MODAL_IS_UNKNOWN = 13,
+
+    // No known verb ends like the lemma, so it can't be conjugated.
+    VSS_ERR_CANT_CONJUGATE_LEMMA = 14
 };
 
+extern EnumStrings<VerbSayStatus> VerbSayStatusStrings;
+
 #endif  // VERB_SAY_STATUS
@@ -1,5 +1,7 @@
 #include "verb_with_context.h"
 
+#include <cassert>
+
 #include "cc/format/json.h"
 #include "cc/core/ling/verb/internal/parsing/flat_vwc_fields.h"
 
@@ -32,9 +34,17 @@ void VerbWithContext::Init(
 
 void VerbWithContext::InitFromVector(
         const vector<uint8_t>& v, const vector<string>& lemmas) {
+    assert(v.size() == FLAT_NUM_FLATS);
+    InitFromArray(&v[0], lemmas);
+}
+
+void VerbWithContext::InitFromArray(
+        const uint8_t* v, const vector<string>& lemmas) {
     unsigned li = v[FLAT_LEMMA];
-    const string& lemma = lemmas[li];
+    InitFromArray(v, lemmas[li]);
+}
 
+void VerbWithContext::InitFromArray(const uint8_t* v, const string& lemma) {
     bool tf = static_cast<bool>(v[FLAT_TF]);
     throol is_contrary = *reinterpret_cast<const throol*>(&v[FLAT_IS_CONTRARY]);
     Polarity p;
@@ -66,6 +76,42 @@ void VerbWithContext::InitFromVector(
     sbj_handling_ = static_cast<SubjunctiveHandling>(v[FLAT_SBJ_HANDLING]);
 }
 
+bool VerbWithContext::ToVector(
+        const vector<string>& lemmas, vector<uint8_t>* v) const {
+    size_t li = 0;
+    while (li < lemmas.size() && lemmas[li] != verb_.lemma()) {
+        ++li;
+    }
+    if (li == lemmas.size()) {
+        return false;
+    }
+
+    v->resize(FLAT_NUM_FLATS);
+    ToArray(&(*v)[0]);
+    (*v)[FLAT_LEMMA] = static_cast<uint8_t>(li);
+    return true;
+}
+
+void VerbWithContext::ToArray(uint8_t* v) const {
+    v[FLAT_LEMMA] = 0;
+    v[FLAT_TF] = verb_.polarity().tf();
+    v[FLAT_IS_CONTRARY] = verb_.polarity().is_contrary().value();
+    v[FLAT_TENSE] = static_cast<uint8_t>(verb_.tense());
+    v[FLAT_IS_PERF] = verb_.aspect().is_perf();
+    v[FLAT_IS_PROG] = verb_.aspect().is_prog();
+    v[FLAT_FLAVOR] = static_cast<uint8_t>(verb_.modality().flavor());
+    v[FLAT_IS_COND] = verb_.modality().is_cond();
+    v[FLAT_VERB_FORM] = static_cast<uint8_t>(verb_.verb_form());
+    v[FLAT_IS_PRO_VERB] = verb_.is_pro_verb();
+    v[FLAT_VOICE] = static_cast<uint8_t>(voice_);
+    v[FLAT_CONJ] = static_cast<uint8_t>(conj_);
+    v[FLAT_IS_SPLIT] = is_split_;
+    v[FLAT_REL_CONT] = static_cast<uint8_t>(relative_cont_);
+    v[FLAT_CONTRACT_NOT] = contract_not_.value();
+    v[FLAT_SPLIT_INF] = split_inf_.value();
+    v[FLAT_SBJ_HANDLING] = static_cast<uint8_t>(sbj_handling_);
+}
+
 void VerbWithContext::InitFromVWC(
         const VerbWithContext& other, Conjugation new_conj) {
     *this = other;
@@ -76,76 +122,42 @@ bool VerbWithContext::IsFinite() const {
     return verb_.IsFinite();
 }
 
+struct VerbWithContext::JSONFields {
+    typedef json::Schema<VerbWithContext,
+        JSON_FIELD(VerbWithContext, verb_),
+        JSON_ENUM_FIELD(VerbWithContext, voice_, VoiceStrings),
+        JSON_ENUM_FIELD(VerbWithContext, conj_, ConjugationStrings),
+        JSON_FIELD(VerbWithContext, is_split_),
+        JSON_ENUM_FIELD(VerbWithContext, relative_cont_,
+                        RelativeContainmentStrings),
+        JSON_FIELD(VerbWithContext, contract_not_),
+        JSON_FIELD(VerbWithContext, split_inf_),
+        JSON_ENUM_FIELD(VerbWithContext, sbj_handling_,
+                        SubjunctiveHandlingStrings)
+    > Schema;
+
+    static const Schema& Get() {
+        static const Schema schema(
+            "verb", "voice", "conj", "is_split", "relative_cont",
+            "contract_not", "split_inf", "sbj_handling");
+        return schema;
+    }
+};
+
 void VerbWithContext::ToJSON(string* s) const {
-    string verb_s;
-    verb_.ToJSON(&verb_s);
-
-    json::ToJSON(s,
-        json::OBJECT, "verb",          verb_s,
-        json::STR,    "voice",         VoiceStrings.GetString(voice_),
-        json::STR,    "conj",          ConjugationStrings.GetString(conj_),
-        json::BOOL,   "is_split",      is_split_,
-        json::STR,    "relative_cont",
-            RelativeContainmentStrings.GetString(relative_cont_),
-        json::CHARS,  "contract_not",  contract_not_.ToStr(),
-        json::CHARS,  "split_inf",     split_inf_.ToStr(),
-        json::STR,    "sbj_handling",
-            SubjunctiveHandlingStrings.GetString(sbj_handling_)
-    );
+    json::ToJSON(*this, s);
 }
 
-bool VerbWithContext::FromJSON(const string& s) {
-    string verb_s;
-    string voice_s;
-    string conj_s;
-    string relative_cont_s;
-    string contract_not_s;
-    string split_inf_s;
-    string sbj_handling_s;
-    if (!json::FromJSON(s,
-        json::OBJECT, "verb",          &verb_s,
-        json::STR,    "voice",         &voice_s,
-        json::STR,    "conj",          &conj_s,
-        json::BOOL,   "is_split",      &is_split_,
-        json::STR,    "relative_cont", &relative_cont_s,
-        json::STR,    "contract_not",  &contract_not_s,
-        json::STR,    "split_inf",     &split_inf_s,
-        json::STR,    "sbj_handling",  &sbj_handling_s
-    )) {
-        return false;
-    }
-
-    if (!verb_.FromJSON(verb_s)) {
-        return false;
-    }
-
-    if (!VoiceStrings.MaybeGetEnumValue(voice_s, &voice_)) {
-        return false;
-    }
-
-    if (!ConjugationStrings.MaybeGetEnumValue(conj_s, &conj_)) {
-        return false;
-    }
-
-    if (!RelativeContainmentStrings.MaybeGetEnumValue(
-            relative_cont_s, &relative_cont_)) {
-        return false;
-    }
-
-    if (!contract_not_.FromStr(contract_not_s)) {
-        return false;
-    }
-
-    if (!split_inf_.FromStr(split_inf_s)) {
-        return false;
-    }
+void VerbWithContext::ToJSON(json::Writer* w) const {
+    JSONFields::Get().Write(*this, w);
+}
 
-    if (!SubjunctiveHandlingStrings.MaybeGetEnumValue(
-            sbj_handling_s, &sbj_handling_)) {
-        return false;
-    }
+bool VerbWithContext::FromJSON(const string& s) {
+    return json::FromJSON(s, this);
+}
 
-    return true;
+bool VerbWithContext::FromJSON(const json::Value& v) {
+    return JSONFields::Get().Read(v, this);
 }
 
 bool VerbWithContext::HasUnsetFields() const {
@@ -75,18 +75,35 @@ class VerbWithContext {
     void InitFromVector(const vector<uint8_t>& values,
                         const vector<string>& lemmas);
 
+    // Same, from FLAT_NUM_FLATS values.
+    void InitFromArray(const uint8_t* values, const vector<string>& lemmas);
+
+    // Same, with the lemma given (its field is ignored).
+    void InitFromArray(const uint8_t* values, const string& lemma);
+
+    // Inverse of InitFromVector().  Returns false if my lemma isn't in lemmas.
+    bool ToVector(const vector<string>& lemmas, vector<uint8_t>* values) const;
+
+    // Inverse of InitFromArray() with the lemma given (its field is set to 0).
+    void ToArray(uint8_t* values) const;
+
     void InitFromVWC(const VerbWithContext& other, Conjugation new_conj);
 
     bool IsFinite() const;
 
     void ToJSON(string* s) const;
+    void ToJSON(json::Writer* w) const;
     bool FromJSON(const string& s);
+    bool FromJSON(const json::Value& v);
 
     bool HasUnsetFields() const;
 
     bool IsPossibleAtSentenceRoot() const;
 
   private:
+    // JSON layout (see the .cc).
+    struct JSONFields;
+
     Verb verb_;
     Voice voice_;
     Conjugation conj_;
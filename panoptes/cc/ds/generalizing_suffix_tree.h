@@ -2,6 +2,7 @@
 #define CC_DS_GENERALIZING_SUFFIX_TREE_H_
 
 #include <cassert>
+#include <cstdint>
 #include <map>
 #include <string>
 #include <vector>
@@ -10,6 +11,8 @@ using std::map;
 using std::string;
 using std::vector;
 
+// Used while building the tree (key -> node), then compiled down into the flat
+// trie below.
 template <typename T>
 class GeneralizingSuffixTreeNode {
   public:
@@ -34,18 +37,56 @@ class GeneralizingSuffixTreeNode {
     T value_;
 };
 
+// Maps words to values by their longest known suffix.
+//
+// Stored as a trie over reversed words, flattened into arrays in breadth-first
+// order so that the children of every trie node are contiguous (their labels
+// in one array, their nodes in another).  A lookup walks the word from its last
+// character backwards, without allocating, and returns the value of the deepest
+// node it passed through that was a real node of the tree.
 template <typename T>
 class GeneralizingSuffixTree {
   public:
     void InitFromDict(const map<string, T>& str2val);
 
-    void Get(const string& suffix, T* value) const;
+    // Get the value of the word's longest known suffix.  Returns false if the
+    // tree has no suffix of it at all.
+    bool Get(const string& suffix, T* value) const;
 
     void DumpToString(string* s) const;
 
   private:
-    // substring of reversed string -> GeneralizingSuffixTreeNode.
-    map<string, GeneralizingSuffixTreeNode<T> > key2node_;
+    // Index of the root in nodes_.
+    static const uint32_t ROOT = 0;
+
+    struct TrieNode {
+        // Index in nodes_ (and labels_) of the first child.
+        uint32_t first_child;
+
+        // Children are at [first_child, first_child + num_children).
+        uint16_t num_children;
+
+        // Whether this prefix is a node of the tree (as opposed to just a step
+        // on the way to one).
+        bool has_value;
+
+        // Whether it's a leaf of the tree (for dumping).
+        bool is_leaf;
+
+        T value;
+    };
+
+    // Create flat trie from the tree's nodes (reversed suffix -> node).
+    void Compile(const map<string, GeneralizingSuffixTreeNode<T> >& key2node);
+
+    // Trie nodes in breadth-first order.
+    vector<TrieNode> nodes_;
+
+    // The character leading to each node from its parent (unused for root).
+    vector<char> labels_;
+
+    // Cold: the full keys held by each leaf, for dumping only.
+    map<uint32_t, vector<string> > leaf2keys_;
 };
 
 #include "generalizing_suffix_tree_impl.h"
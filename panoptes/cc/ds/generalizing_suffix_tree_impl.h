@@ -4,8 +4,10 @@
 #include "generalizing_suffix_tree.h"
 
 #include <cassert>
+#include <cstdint>
 #include <map>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "cc/base/logging.h"
@@ -52,7 +54,7 @@ void GeneralizingSuffixTree<T>::InitFromDict(const map<string, T>& str2val) {
     }
 
     // Loop around until done, splitting nodes to resolve conflicts.
-    key2node_.clear();
+    map<string, GeneralizingSuffixTreeNode<T> > key2node;
     unsigned round = 0;
     while (todos.size()) {
         DEBUG("[GeneralizingSuffixTree] Round %u has %zu todos.\n", round,
@@ -66,9 +68,9 @@ void GeneralizingSuffixTree<T>::InitFromDict(const map<string, T>& str2val) {
                 string ltr = reversed;
                 ltr = string(ltr.rbegin(), ltr.rend());
                 T value = str2val.find(ltr.substr(1))->second;
-                if (key2node_.find(key) == key2node_.end()) {
+                if (key2node.find(key) == key2node.end()) {
                     bool is_leaf = true;
-                    key2node_[key] = GeneralizingSuffixTreeNode<T>(
+                    key2node[key] = GeneralizingSuffixTreeNode<T>(
                         reversed, is_leaf, value);
                     break;
                 }
@@ -78,15 +80,16 @@ void GeneralizingSuffixTree<T>::InitFromDict(const map<string, T>& str2val) {
                 // value, which would screw up the lookup.  If node is internal,
                 // keep branching.
                 GeneralizingSuffixTreeNode<T>* node =
-                    &(key2node_.find(key)->second);
+                    &(key2node.find(key)->second);
                 if (!node->is_leaf()) {
                     continue;
                 }
 
                 // Leaf node: if we have the same value, we're good, but add
-                // myself to the keys (may need to split later).
+                // myself to the keys (may need to split later).  The full
+                // reversed string, as that is what gets retried on a split.
                 if (value == node->value()) {
-                    node->AddKey(key);
+                    node->AddKey(reversed);
                     break;
                 }
 
@@ -112,37 +115,134 @@ void GeneralizingSuffixTree<T>::InitFromDict(const map<string, T>& str2val) {
         ++round;
     }
 
-    for (auto& it : key2node_) {
+    for (auto& it : key2node) {
         GeneralizingSuffixTreeNode<T>* node = &it.second;
         if (!node->is_leaf()) {
             node->clear_keys();
         }
     }
+
+    Compile(key2node);
+}
+
+template <typename T>
+void GeneralizingSuffixTree<T>::Compile(
+        const map<string, GeneralizingSuffixTreeNode<T> >& key2node) {
+    // Build a pointer-style trie of every prefix of every key first.  Children
+    // are ordered by unsigned char, like the keys of the map.
+    struct TempNode {
+        map<unsigned char, size_t> children;
+        const GeneralizingSuffixTreeNode<T>* node;
+    };
+    vector<TempNode> temps(1);
+    temps[0].node = NULL;
+    for (auto& it : key2node) {
+        const string& key = it.first;
+        size_t x = 0;
+        for (size_t i = 0; i < key.size(); ++i) {
+            unsigned char c = static_cast<unsigned char>(key[i]);
+            auto jt = temps[x].children.find(c);
+            if (jt == temps[x].children.end()) {
+                temps.emplace_back(TempNode());
+                temps.back().node = NULL;
+                size_t child = temps.size() - 1;
+                temps[x].children[c] = child;
+                x = child;
+            } else {
+                x = jt->second;
+            }
+        }
+        temps[x].node = &it.second;
+    }
+
+    // Then lay it out breadth-first, so siblings end up next to each other.
+    vector<size_t> order;
+    order.reserve(temps.size());
+    order.emplace_back(0);
+    labels_.clear();
+    labels_.reserve(temps.size());
+    labels_.emplace_back('\0');
+    nodes_.clear();
+    nodes_.resize(temps.size());
+    leaf2keys_.clear();
+    for (size_t i = 0; i < order.size(); ++i) {
+        const TempNode& temp = temps[order[i]];
+        assert(temp.children.size() <= 0xFFFFu);
+        TrieNode* node = &nodes_[i];
+        node->first_child = static_cast<uint32_t>(order.size());
+        node->num_children = static_cast<uint16_t>(temp.children.size());
+        node->has_value = temp.node != NULL;
+        node->is_leaf = temp.node && temp.node->is_leaf();
+        node->value = temp.node ? temp.node->value() : T();
+        if (temp.node && temp.node->keys().size()) {
+            leaf2keys_[static_cast<uint32_t>(i)] = temp.node->keys();
+        }
+        for (auto& it : temp.children) {
+            order.emplace_back(it.second);
+            labels_.emplace_back(static_cast<char>(it.first));
+        }
+    }
 }
 
 template <typename T>
-void GeneralizingSuffixTree<T>::Get(const string& suffix, T* value) const {
-    string reversed = string(suffix.rbegin(), suffix.rend());
-    for (size_t i = 0; i < reversed.size(); ++i) {
-        // Narrowest scope first.
-        const string key = reversed.substr(0, reversed.size() - i);
-        const auto& it = key2node_.find(key);
-        if (it != key2node_.end()) {
-            *value = it->second.value();
-            return;
+bool GeneralizingSuffixTree<T>::Get(const string& suffix, T* value) const {
+    // Walk the word backwards (ie, the reversed word forwards), remembering the
+    // narrowest scope seen.  The root (empty suffix) is never a match.
+    bool found = false;
+    uint32_t x = ROOT;
+    for (size_t i = suffix.size(); i-- > 0; ) {
+        const TrieNode& node = nodes_[x];
+        const char c = suffix[i];
+        const char* first = &labels_[0] + node.first_child;
+        const char* last = first + node.num_children;
+        const char* label = first;
+        while (label != last && *label != c) {
+            ++label;
+        }
+        if (label == last) {
+            break;
+        }
+        x = node.first_child + static_cast<uint32_t>(label - first);
+        if (nodes_[x].has_value) {
+            *value = nodes_[x].value;
+            found = true;
         }
     }
-    assert(false);
+    return found;
 }
 
 template <typename T>
 void GeneralizingSuffixTree<T>::DumpToString(string* s) const {
     s->clear();
-    for (typename map<string, GeneralizingSuffixTreeNode<T> >::const_iterator it
-         = key2node_.begin(); it != key2node_.end(); ++it) {
-        string tmp;
-        it->second.DumpToString(&tmp);
-        *s += String::StringPrintf("%s = %s\n", it->first.c_str(), tmp.c_str());
+    if (nodes_.empty()) {
+        return;
+    }
+
+    // Depth-first with children in label order gives the keys in sorted order.
+    vector<std::pair<uint32_t, string> > stack;
+    stack.emplace_back(std::make_pair(ROOT, string()));
+    while (stack.size()) {
+        uint32_t x = stack.back().first;
+        string key = stack.back().second;
+        stack.pop_back();
+
+        const TrieNode& node = nodes_[x];
+        if (node.has_value) {
+            string tmp;
+            tmp += String::StringPrintf("%zu %d", node.value, node.is_leaf);
+            auto it = leaf2keys_.find(x);
+            if (it != leaf2keys_.end()) {
+                for (const string& leaf_key : it->second) {
+                    tmp += String::StringPrintf(" %s", leaf_key.c_str());
+                }
+            }
+            *s += String::StringPrintf("%s = %s\n", key.c_str(), tmp.c_str());
+        }
+
+        for (uint32_t i = node.num_children; i-- > 0; ) {
+            uint32_t child = node.first_child + i;
+            stack.emplace_back(std::make_pair(child, key + labels_[child]));
+        }
     }
 }
 
@@ -0,0 +1,51 @@
+#ifndef CC_DS_PACKED_KEY_MAP_H_
+#define CC_DS_PACKED_KEY_MAP_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+using std::vector;
+
+// Open-addressing (linear probing) hash map from 64-bit keys to small values,
+// for when keys can be packed into an integer.  All-ones is reserved to mark
+// empty slots and can't be used as a key.
+template <typename Value>
+class PackedKeyMap {
+  public:
+    PackedKeyMap();
+
+    size_t size() const { return size_; }
+
+    void Clear();
+
+    // Size the table for n entries.
+    void Reserve(size_t n);
+
+    // Returns NULL if not present.
+    const Value* Find(uint64_t key) const;
+
+    // Get the value, inserting a default one if not present.  The pointer is
+    // good until the next insert or erase.
+    Value* Get(uint64_t key);
+
+    // Returns whether it was present.
+    bool Erase(uint64_t key);
+
+    // Call f(key, value) on each entry, in no particular order.
+    template <typename F>
+    void ForEach(F f) const;
+
+  private:
+    size_t SlotOf(uint64_t key) const;
+
+    void Rehash(size_t num_slots);
+
+    vector<uint64_t> keys_;
+    vector<Value> values_;
+    size_t size_;
+};
+
+#include "packed_key_map_impl.h"
+
+#endif  // CC_DS_PACKED_KEY_MAP_H_
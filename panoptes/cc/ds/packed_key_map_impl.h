@@ -0,0 +1,138 @@
+#ifndef CC_DS_PACKED_KEY_MAP_IMPL_H_
+#define CC_DS_PACKED_KEY_MAP_IMPL_H_
+
+#include "packed_key_map.h"
+
+#include <cassert>
+
+#define PACKED_KEY_MAP_EMPTY (~0ull)
+#define PACKED_KEY_MAP_MIN_SLOTS 16
+
+template <typename Value>
+PackedKeyMap<Value>::PackedKeyMap() : size_(0) {
+    Rehash(PACKED_KEY_MAP_MIN_SLOTS);
+}
+
+template <typename Value>
+void PackedKeyMap<Value>::Clear() {
+    size_ = 0;
+    Rehash(PACKED_KEY_MAP_MIN_SLOTS);
+}
+
+template <typename Value>
+void PackedKeyMap<Value>::Reserve(size_t n) {
+    // Keep the load factor at most 1/2.
+    size_t num_slots = keys_.size();
+    while (num_slots < n * 2) {
+        num_slots *= 2;
+    }
+    if (num_slots != keys_.size()) {
+        Rehash(num_slots);
+    }
+}
+
+template <typename Value>
+size_t PackedKeyMap<Value>::SlotOf(uint64_t key) const {
+    // Finalizer of splitmix64: packed keys are far from uniform.
+    key ^= key >> 30;
+    key *= 0xbf58476d1ce4e5b9ull;
+    key ^= key >> 27;
+    key *= 0x94d049bb133111ebull;
+    key ^= key >> 31;
+    return static_cast<size_t>(key) & (keys_.size() - 1);
+}
+
+template <typename Value>
+void PackedKeyMap<Value>::Rehash(size_t num_slots) {
+    vector<uint64_t> old_keys(num_slots, PACKED_KEY_MAP_EMPTY);
+    vector<Value> old_values(num_slots);
+    old_keys.swap(keys_);
+    old_values.swap(values_);
+    for (size_t i = 0; i < old_keys.size(); ++i) {
+        if (old_keys[i] == PACKED_KEY_MAP_EMPTY) {
+            continue;
+        }
+        size_t x = SlotOf(old_keys[i]);
+        while (keys_[x] != PACKED_KEY_MAP_EMPTY) {
+            x = (x + 1) & (keys_.size() - 1);
+        }
+        keys_[x] = old_keys[i];
+        values_[x] = old_values[i];
+    }
+}
+
+template <typename Value>
+const Value* PackedKeyMap<Value>::Find(uint64_t key) const {
+    assert(key != PACKED_KEY_MAP_EMPTY);
+    for (size_t x = SlotOf(key); keys_[x] != PACKED_KEY_MAP_EMPTY;
+         x = (x + 1) & (keys_.size() - 1)) {
+        if (keys_[x] == key) {
+            return &values_[x];
+        }
+    }
+    return NULL;
+}
+
+template <typename Value>
+Value* PackedKeyMap<Value>::Get(uint64_t key) {
+    assert(key != PACKED_KEY_MAP_EMPTY);
+    if (keys_.size() < (size_ + 1) * 2) {
+        Rehash(keys_.size() * 2);
+    }
+
+    size_t x = SlotOf(key);
+    while (keys_[x] != PACKED_KEY_MAP_EMPTY) {
+        if (keys_[x] == key) {
+            return &values_[x];
+        }
+        x = (x + 1) & (keys_.size() - 1);
+    }
+
+    keys_[x] = key;
+    values_[x] = Value();
+    ++size_;
+    return &values_[x];
+}
+
+template <typename Value>
+bool PackedKeyMap<Value>::Erase(uint64_t key) {
+    assert(key != PACKED_KEY_MAP_EMPTY);
+    size_t mask = keys_.size() - 1;
+    size_t x = SlotOf(key);
+    while (keys_[x] != key) {
+        if (keys_[x] == PACKED_KEY_MAP_EMPTY) {
+            return false;
+        }
+        x = (x + 1) & mask;
+    }
+
+    // Shift later entries of the run back into the hole, so lookups never see
+    // a gap before their key (no tombstones).
+    size_t hole = x;
+    for (size_t y = (hole + 1) & mask; keys_[y] != PACKED_KEY_MAP_EMPTY;
+         y = (y + 1) & mask) {
+        size_t home = SlotOf(keys_[y]);
+        bool home_is_after_hole = ((y - home) & mask) < ((y - hole) & mask);
+        if (home_is_after_hole) {
+            continue;
+        }
+        keys_[hole] = keys_[y];
+        values_[hole] = values_[y];
+        hole = y;
+    }
+    keys_[hole] = PACKED_KEY_MAP_EMPTY;
+    --size_;
+    return true;
+}
+
+template <typename Value>
+template <typename F>
+void PackedKeyMap<Value>::ForEach(F f) const {
+    for (size_t i = 0; i < keys_.size(); ++i) {
+        if (keys_[i] != PACKED_KEY_MAP_EMPTY) {
+            f(keys_[i], values_[i]);
+        }
+    }
+}
+
+#endif  // CC_DS_PACKED_KEY_MAP_IMPL_H_
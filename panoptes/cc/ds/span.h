@@ -0,0 +1,31 @@
+#ifndef CC_DS_SPAN_H_
+#define CC_DS_SPAN_H_
+
+#include <cassert>
+#include <cstddef>
+
+// A read-only view of a run of contiguous values that someone else owns.
+template <typename T>
+class Span {
+  public:
+    Span() : data_(NULL), size_(0) {}
+    Span(const T* data, size_t size) : data_(data), size_(size) {}
+
+    const T* data() const { return data_; }
+    size_t size() const { return size_; }
+    bool empty() const { return !size_; }
+
+    const T* begin() const { return data_; }
+    const T* end() const { return data_ + size_; }
+
+    const T& operator[](size_t x) const {
+        assert(x < size_);
+        return data_[x];
+    }
+
+  private:
+    const T* data_;
+    size_t size_;
+};
+
+#endif  // CC_DS_SPAN_H_
@@ -0,0 +1,28 @@
+#include "string_interner.h"
+
+void StringInterner::Clear() {
+    string2id_.clear();
+    strings_.clear();
+}
+
+uint32_t StringInterner::Intern(const string& s) {
+    auto it = string2id_.find(s);
+    if (it != string2id_.end()) {
+        return it->second;
+    }
+
+    uint32_t id = static_cast<uint32_t>(strings_.size());
+    string2id_[s] = id;
+    strings_.emplace_back(s);
+    return id;
+}
+
+bool StringInterner::Find(const string& s, uint32_t* id) const {
+    auto it = string2id_.find(s);
+    if (it == string2id_.end()) {
+        return false;
+    }
+
+    *id = it->second;
+    return true;
+}
@@ -0,0 +1,33 @@
+#ifndef CC_DS_STRING_INTERNER_H_
+#define CC_DS_STRING_INTERNER_H_
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+using std::string;
+using std::unordered_map;
+using std::vector;
+
+// Gives each distinct string a small id, counting up from zero in the order
+// they are first seen.
+class StringInterner {
+  public:
+    const vector<string>& strings() const { return strings_; }
+    size_t size() const { return strings_.size(); }
+
+    void Clear();
+
+    // Get the string's id, adding it if new.
+    uint32_t Intern(const string& s);
+
+    // Returns false if it was never interned.
+    bool Find(const string& s, uint32_t* id) const;
+
+  private:
+    unordered_map<string, uint32_t> string2id_;
+    vector<string> strings_;
+};
+
+#endif  // CC_DS_STRING_INTERNER_H_
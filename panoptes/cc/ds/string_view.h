@@ -0,0 +1,64 @@
+#ifndef CC_DS_STRING_VIEW_H_
+#define CC_DS_STRING_VIEW_H_
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+using std::string;
+
+// A read-only view of a run of characters that someone else owns.
+class StringView {
+  public:
+    StringView() : data_(NULL), size_(0) {}
+    StringView(const char* data, size_t size) : data_(data), size_(size) {}
+    StringView(const char* s) : data_(s), size_(strlen(s)) {}
+    StringView(const string& s) : data_(s.data()), size_(s.size()) {}
+
+    const char* data() const { return data_; }
+    size_t size() const { return size_; }
+    bool empty() const { return !size_; }
+
+    const char* begin() const { return data_; }
+    const char* end() const { return data_ + size_; }
+
+    char operator[](size_t x) const {
+        assert(x < size_);
+        return data_[x];
+    }
+
+    string ToString() const { return string(data_, size_); }
+
+    // Set or add to the string, reusing its buffer.
+    void AssignTo(string* s) const { s->assign(data_, size_); }
+    void AppendTo(string* s) const { s->append(data_, size_); }
+
+  private:
+    const char* data_;
+    size_t size_;
+};
+
+inline bool operator==(const StringView& a, const StringView& b) {
+    return a.size() == b.size() && !memcmp(a.data(), b.data(), a.size());
+}
+
+inline bool operator!=(const StringView& a, const StringView& b) {
+    return !(a == b);
+}
+
+// For unordered containers keyed by views.
+struct StringViewHash {
+    size_t operator()(const StringView& s) const {
+        // FNV-1a.
+        uint64_t h = 14695981039346656037ull;
+        for (size_t i = 0; i < s.size(); ++i) {
+            h ^= static_cast<uint8_t>(s.data()[i]);
+            h *= 1099511628211ull;
+        }
+        return static_cast<size_t>(h);
+    }
+};
+
+#endif  // CC_DS_STRING_VIEW_H_
@@ -2,18 +2,94 @@
 #define CC_DS_TABLE_H_
 
 #include <map>
+#include <type_traits>
 #include <vector>
 
 using std::map;
 using std::vector;
 
+// Marks a slot of a dense key index that no key maps to.
+#define TABLE_NO_INDEX (~static_cast<size_t>(0))
+
+// Largest number of slots a dense key index may have (enum keys are expected
+// to be small and contiguous, counting from zero).
+#define TABLE_MAX_DENSE_KEYS 4096
+
+// Whether a key type is indexed by value in a flat array instead of a map.
+template <typename Key>
+struct TableKeyIsDense {
+    static const bool value = std::is_enum<Key>::value ||
+                              std::is_same<Key, bool>::value;
+};
+
+// Maps the row or column keys of a table to their index.
+template <typename Key, bool IsDense = TableKeyIsDense<Key>::value>
+class TableKeyIndex;
+
+// Arbitrary keys: a map lookup.
+template <typename Key>
+class TableKeyIndex<Key, false> {
+  public:
+    void Clear() { key2x_.clear(); }
+
+    bool Add(const Key& key, size_t x) {
+        key2x_[key] = x;
+        return true;
+    }
+
+    bool Find(const Key& key, size_t* x) const {
+        typename map<Key, size_t>::const_iterator it = key2x_.find(key);
+        if (it == key2x_.end()) {
+            return false;
+        }
+        *x = it->second;
+        return true;
+    }
+
+  private:
+    map<Key, size_t> key2x_;
+};
+
+// Enum and bool keys: a single indexed load.
+template <typename Key>
+class TableKeyIndex<Key, true> {
+  public:
+    void Clear() { key2x_.clear(); }
+
+    bool Add(const Key& key, size_t x) {
+        size_t slot = static_cast<size_t>(key);
+        if (TABLE_MAX_DENSE_KEYS <= slot) {
+            return false;
+        }
+        if (key2x_.size() <= slot) {
+            key2x_.resize(slot + 1, TABLE_NO_INDEX);
+        }
+        key2x_[slot] = x;
+        return true;
+    }
+
+    bool Find(const Key& key, size_t* x) const {
+        size_t slot = static_cast<size_t>(key);
+        if (key2x_.size() <= slot || key2x_[slot] == TABLE_NO_INDEX) {
+            return false;
+        }
+        *x = key2x_[slot];
+        return true;
+    }
+
+  private:
+    vector<size_t> key2x_;
+};
+
 template <typename RowKey, typename ColumnKey, typename Value>
 class Table {
   public:
     const vector<RowKey>& row_keys() const { return row_keys_; }
-    const map<RowKey, size_t>& row_key2x() const { return row_key2x_; }
+    const TableKeyIndex<RowKey>& row_key2x() const { return row_key2x_; }
     const vector<ColumnKey>& column_keys() const { return column_keys_; }
-    const map<RowKey, size_t>& column_key2x() const { return column_key2x_; }
+    const TableKeyIndex<ColumnKey>& column_key2x() const {
+        return column_key2x_;
+    }
     const vector<Value>& values() const { return values_; }
 
     // On invalid input, returns false and doesn't modify anything.
@@ -29,14 +105,18 @@ class Table {
     bool Set(const RowKey& row_key, const ColumnKey& column_key, const Value& v);
     Value* At(size_t row_index, size_t column_index) const;
 
+    // Like Get, but without copying (null if not found).
+    const Value* GetPointer(const RowKey& row_key,
+                            const ColumnKey& column_key) const;
+
   private:
     bool Find(const RowKey& row_key, const ColumnKey& column_key, size_t* x) const;
 
     vector<RowKey> row_keys_;
-    map<RowKey, size_t> row_key2x_;
+    TableKeyIndex<RowKey> row_key2x_;
 
     vector<ColumnKey> column_keys_;
-    map<ColumnKey, size_t> column_key2x_;
+    TableKeyIndex<ColumnKey> column_key2x_;
 
     vector<Value> values_;
 };
@@ -36,24 +36,30 @@ bool Table<RowKey, ColumnKey, Value>::Init(
         column_keys_set.insert(column_keys[i]);
     }
 
-    // Set and index row keys.
-    row_keys_.resize(row_keys.size());
-    row_key2x_.clear();
+    // Index row keys.
+    TableKeyIndex<RowKey> row_key2x;
     for (unsigned i = 0; i < row_keys.size(); ++i) {
-        const RowKey& rk = row_keys[i];
-        row_keys_[i] = rk;
-        row_key2x_[rk] = i;
+        if (!row_key2x.Add(row_keys[i], i)) {
+            ERROR("Table: Row key out of range.\n");
+            return false;
+        }
     }
 
-    // Set and index column keys.
-    column_keys_.resize(column_keys.size());
-    column_key2x_.clear();
+    // Index column keys.
+    TableKeyIndex<ColumnKey> column_key2x;
     for (unsigned i = 0; i < column_keys.size(); ++i) {
-        const ColumnKey& ck = column_keys[i];
-        column_keys_[i] = ck;
-        column_key2x_[ck] = i;
+        if (!column_key2x.Add(column_keys[i], i)) {
+            ERROR("Table: Column key out of range.\n");
+            return false;
+        }
     }
 
+    // Set row and column keys.
+    row_keys_ = row_keys;
+    row_key2x_ = row_key2x;
+    column_keys_ = column_keys;
+    column_key2x_ = column_key2x;
+
     // Clear the values.
     values_.clear();
     return true;
@@ -83,10 +89,10 @@ bool Table<RowKey, ColumnKey, Value>::InitWithValues(
 template <typename RowKey, typename ColumnKey, typename Value>
 void Table<RowKey, ColumnKey, Value>::Clear() {
     row_keys_.clear();
-    row_key2x_.clear();
+    row_key2x_.Clear();
 
     column_keys_.clear();
-    column_key2x_.clear();
+    column_key2x_.Clear();
 
     values_.clear();
 }
@@ -95,19 +101,16 @@ template <typename RowKey, typename ColumnKey, typename Value>
 bool Table<RowKey, ColumnKey, Value>::Find(
         const RowKey& row_key, const ColumnKey& column_key, size_t* x) const {
     // Get row index.
-    typename map<RowKey, size_t>::const_iterator it = row_key2x_.find(row_key);
-    if (it == row_key2x_.end()) {
+    size_t row_index;
+    if (!row_key2x_.Find(row_key, &row_index)) {
         return false;
     }
-    size_t row_index = it->second;
 
     // Get column index.
-    typename map<ColumnKey, size_t>::const_iterator jt =
-        column_key2x_.find(column_key);
-    if (jt == column_key2x_.end()) {
+    size_t column_index;
+    if (!column_key2x_.Find(column_key, &column_index)) {
         return false;
     }
-    size_t column_index = jt->second;
 
     // Get value index.
     size_t index = row_index * column_keys_.size() + column_index;
@@ -131,6 +134,17 @@ bool Table<RowKey, ColumnKey, Value>::Get(
     return true;
 }
 
+template <typename RowKey, typename ColumnKey, typename Value>
+const Value* Table<RowKey, ColumnKey, Value>::GetPointer(
+        const RowKey& row_key, const ColumnKey& column_key) const {
+    size_t x;
+    if (!Find(row_key, column_key, &x)) {
+        return NULL;
+    }
+
+    return &values_[x];
+}
+
 template <typename RowKey, typename ColumnKey, typename Value>
 Value* Table<RowKey, ColumnKey, Value>::At(
         size_t row_index, size_t column_index) const {
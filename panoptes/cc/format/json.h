@@ -3,342 +3,157 @@
 
 // JSON conversion.
 //
+// A class declares its JSON layout once, as a Schema: the list of its Fields
+// (member pointers as template arguments, each with the Codec of its type) and
+// their keys.  Writing and reading are generated from that list at compile
+// time and inlined, and keys are matched by a perfect hash precomputed when the
+// schema is first built.
+//
 // Usage:
-//   -> ToJSON(), VectorToJSON(), MapToJSON()
-//   <- ObjectFromJSON(), VectorFromJSON(), MapFromJSON()
+//   class Aspect {
+//       ...
+//       void ToJSON(json::Writer* w) const;
+//       bool FromJSON(const json::Value& v);
+//     private:
+//       struct JSONFields;
+//       bool is_perf_;
+//       bool is_prog_;
+//   };
+//
+//   struct Aspect::JSONFields {
+//       typedef json::Schema<Aspect,
+//           JSON_FIELD(Aspect, is_perf_),
+//           JSON_FIELD(Aspect, is_prog_)
+//       > Schema;
+//
+//       static const Schema& Get() {
+//           static const Schema schema("is_perf", "is_prog");
+//           return schema;
+//       }
+//   };
+//
+//   void Aspect::ToJSON(json::Writer* w) const {
+//       JSONFields::Get().Write(*this, w);
+//   }
+//
+//   bool Aspect::FromJSON(const json::Value& v) {
+//       return JSONFields::Get().Read(v, this);
+//   }
 //
-// For example, see json_test.cpp.
+// Then json::ToJSON(aspect, &s) and json::FromJSON(s, &aspect) convert whole
+// documents, and Aspect works as a field of other schemas, or inside vectors
+// and maps.
+//
+// Codecs (see json_impl.h) exist for bool, the integer and floating point
+// types, string, throol, vector<T>, map<string, T>, enums through their
+// EnumStrings (EnumCodec), and any class with the two methods above.
 
+#include <cstddef>
+#include <cstdint>
 #include <map>
 #include <string>
 #include <vector>
 
-#include "cc/base/unicode.h"
+#include "cc/base/enum_strings.h"
+#include "cc/base/throol.h"
+#include "cc/format/json_tape.h"
+#include "cc/format/json_writer.h"
 
 using std::map;
 using std::string;
 using std::vector;
 
-using unicode::CodePoint;
-
 namespace json {
 
-enum Type {
-    BOOL,
-    I8,
-    U8,
-    I16,
-    U16,
-    I32,
-    U32,
-    I64,
-    U64,
-    SIZET,
-
-    FLOAT,
-    DOUBLE,
-
-    CHARS,  // Caller takes ownership of allocated memory.  Will not contain the
-                    // full string if it contains \0s.
-    STR,
-
-    OBJECT,  // For raw strings (ie, children JSON objects).
-
-    NUM_JSON_TYPES
-};
-
-struct Entry {
-    Type type;
-    string key;
-    void* value;
-
-    Entry() : value(NULL) {}
+// -----------------------------------------------------------------------------
+// Codecs.
 
-    Entry(Type t, const string& k, void* v) {
-        type = t;
-        key = k;
-        value = v;
-    }
+// How a T is written and read:
+//   static void Write(const T& t, Writer* w);
+//   static bool Read(const Value& v, T* t);
+//
+// The primary template is for classes with ToJSON(Writer*) and
+// FromJSON(const Value&).
+template <typename T, typename Enable = void>
+struct Codec;
+
+// Enums, written as their names in the given EnumStrings.
+template <typename E, const EnumStrings<E>& Strings>
+struct EnumCodec {
+    static void Write(const E& e, Writer* w);
+    static bool Read(const Value& v, E* e);
 };
 
 // -----------------------------------------------------------------------------
-// To JSON.
-
-typedef void (*AppendType)(const void* p, string* r);
-
-extern AppendType APPEND_TYPE[NUM_JSON_TYPES];
-
-void AppendBool(const void* p, string* r);
-
-template <typename T>
-bool AppendInt(const void* p, string* r);
-
-template <typename T>
-bool AppendFloat(const void* p, string* r);
-
-void AppendChars(const void* p, string* r);
-
-void AppendStr(const void* p, string* r);
-
-void AppendObject(const void* p, string* r);
-
-void AppendEntry(const Entry& e, string* r);
-
-void EntriesToJSON(const vector<Entry>& v, string* s);
-
-template <typename T>
-void VectorToJSON(const vector<T>& v, Type type, string* s);
-
-template <typename Value>
-void MapToJSON(const map<string, Value>& m, Type type, string* s);
-
-void ToJSON(
-        string* s);
-
-template <typename V0>
-void ToJSON(
-        string* s,
-        Type t0, const string& n0, const V0& v0);
-
-template <typename V0, typename V1>
-void ToJSON(
-        string* s,
-        Type t0, const string& n0, const V0& v0,
-        Type t1, const string& n1, const V1& v1);
-
-template <typename V0, typename V1, typename V2>
-void ToJSON(
-        string* s,
-        Type t0, const string& n0, const V0& v0,
-        Type t1, const string& n1, const V1& v1,
-        Type t2, const string& n2, const V2& v2);
+// Schemas.
 
-template <typename V0, typename V1, typename V2, typename V3>
-void ToJSON(
-        string* s,
-        Type t0, const string& n0, const V0& v0,
-        Type t1, const string& n1, const V1& v1,
-        Type t2, const string& n2, const V2& v2,
-        Type t3, const string& n3, const V3& v3);
-
-template <typename V0, typename V1, typename V2, typename V3, typename V4>
-void ToJSON(
-        string* s,
-        Type t0, const string& n0, const V0& v0,
-        Type t1, const string& n1, const V1& v1,
-        Type t2, const string& n2, const V2& v2,
-        Type t3, const string& n3, const V3& v3,
-        Type t4, const string& n4, const V4& v4);
-
-template <typename V0, typename V1, typename V2, typename V3, typename V4,
-                    typename V5>
-void ToJSON(
-        string* s,
-        Type t0, const string& n0, const V0& v0,
-        Type t1, const string& n1, const V1& v1,
-        Type t2, const string& n2, const V2& v2,
-        Type t3, const string& n3, const V3& v3,
-        Type t4, const string& n4, const V4& v4,
-        Type t5, const string& n5, const V5& v5);
-
-template <typename V0, typename V1, typename V2, typename V3, typename V4,
-                    typename V5, typename V6>
-void ToJSON(
-        string* s,
-        Type t0, const string& n0, const V0& v0,
-        Type t1, const string& n1, const V1& v1,
-        Type t2, const string& n2, const V2& v2,
-        Type t3, const string& n3, const V3& v3,
-        Type t4, const string& n4, const V4& v4,
-        Type t5, const string& n5, const V5& v5,
-        Type t6, const string& n6, const V6& v6);
-
-template <typename V0, typename V1, typename V2, typename V3, typename V4,
-                    typename V5, typename V6, typename V7>
-void ToJSON(
-        string* s,
-        Type t0, const string& n0, const V0& v0,
-        Type t1, const string& n1, const V1& v1,
-        Type t2, const string& n2, const V2& v2,
-        Type t3, const string& n3, const V3& v3,
-        Type t4, const string& n4, const V4& v4,
-        Type t5, const string& n5, const V5& v5,
-        Type t6, const string& n6, const V6& v6,
-        Type t7, const string& n7, const V7& v7);
-
-template <typename V0, typename V1, typename V2, typename V3, typename V4,
-                    typename V5, typename V6, typename V7, typename V8>
-void ToJSON(
-        string* s,
-        Type t0, const string& n0, const V0& v0,
-        Type t1, const string& n1, const V1& v1,
-        Type t2, const string& n2, const V2& v2,
-        Type t3, const string& n3, const V3& v3,
-        Type t4, const string& n4, const V4& v4,
-        Type t5, const string& n5, const V5& v5,
-        Type t6, const string& n6, const V6& v6,
-        Type t7, const string& n7, const V7& v7,
-        Type t8, const string& n8, const V8& v8);
+// One field of class C: the member M, of type T.
+template <typename C, typename T, T C::*M, typename TCodec = Codec<T> >
+struct Field {
+    static void Write(const C& c, Writer* w);
+    static bool Read(const Value& v, C* c);
+};
 
-template <typename V0, typename V1, typename V2, typename V3, typename V4,
-                    typename V5, typename V6, typename V7, typename V8, typename V9>
-void ToJSON(
-        string* s,
-        Type t0, const string& n0, const V0& v0,
-        Type t1, const string& n1, const V1& v1,
-        Type t2, const string& n2, const V2& v2,
-        Type t3, const string& n3, const V3& v3,
-        Type t4, const string& n4, const V4& v4,
-        Type t5, const string& n5, const V5& v5,
-        Type t6, const string& n6, const V6& v6,
-        Type t7, const string& n7, const V7& v7,
-        Type t8, const string& n8, const V8& v8,
-        Type t9, const string& n9, const V9& v9);
+// The Field for member m of class C, using the Codec of its type.
+#define JSON_FIELD(C, m) json::Field<C, decltype(C::m), &C::m>
+
+// The Field for enum member m of class C, using its EnumStrings.
+#define JSON_ENUM_FIELD(C, m, strings) \
+    json::Field<C, decltype(C::m), &C::m, \
+                json::EnumCodec<decltype(C::m), strings> >
+
+// Slots in a schema's key hash table: a power of two, at least four per key,
+// so a perfect hash seed is found within a few tries.
+constexpr size_t NumHashSlots(size_t num_keys, size_t slots = 4) {
+    return num_keys * 4 <= slots ? slots : NumHashSlots(num_keys, slots * 2);
+}
+
+// Hash of a key under a seed.
+inline uint32_t HashKey(const char* s, size_t size, uint32_t seed);
+
+// Find a seed under which the keys hash to distinct slots (num_slots is a power
+// of two), and fill in slots with the key index of each (or 0xFF).  The keys
+// must be distinct.
+uint32_t FindPerfectHash(const char* const* keys, const size_t* key_sizes,
+                         size_t num_keys, size_t num_slots, uint8_t* slots);
+
+// The JSON layout of class C: an object of the given fields, written in order
+// and read in any order (each exactly once).
+template <typename C, typename... Fields>
+class Schema {
+  public:
+    static constexpr size_t NUM_FIELDS = sizeof...(Fields);
+
+    // Takes the fields' keys, in the same order.  They must outlive the schema
+    // (ie, be literals).
+    template <typename... Keys>
+    explicit Schema(Keys... keys);
+
+    void Write(const C& c, Writer* w) const;
+    bool Read(const Value& v, C* c) const;
+
+  private:
+    static constexpr size_t NUM_SLOTS = NumHashSlots(NUM_FIELDS);
+
+    // Index of the field with the given key, or NUM_FIELDS if none.
+    size_t FindField(const char* s, size_t size) const;
+
+    const char* keys_[NUM_FIELDS];
+    size_t key_sizes_[NUM_FIELDS];
+    uint32_t seed_;
+    uint8_t slots_[NUM_SLOTS];
+};
 
 // -----------------------------------------------------------------------------
-// From JSON.
-
-typedef bool (*ParseType)(const string& s, size_t* x, void* p);
-
-extern ParseType PARSE_TYPE[NUM_JSON_TYPES];
-
-bool IsFieldEndChar(CodePoint c);
-
-void ParseNonquotedNonescapedField(const string& s, size_t* x, string* field);
-
-bool ParseBool(const string& s, size_t* x, void* p);
-
-template <typename T>
-bool ParseInt(const string& s, size_t* x, void* p);
+// Documents.
 
+// Write t as a JSON document, replacing the contents of s.
 template <typename T>
-bool ParseFloat(const string& s, size_t* x, void* p);
-
-bool ParseQuotedAndEscaped(const string& s, size_t* x, string* field);
-
-bool ParseChars(const string& s, size_t* x, void* p);
-
-bool ParseStr(const string& s, size_t* x, void* p);
-
-bool ParseObject(const string& s, size_t* x, void* p);
-
-bool IsWhitespaceCharacter(CodePoint c);
-
-void RemoveWhitespace(const string& in, string* out);
-
-bool ReadKeyValue(const string& s, Type type, size_t* x,
-                                    string* key, void* value);
-
-bool EntriesFromJSON(const string& s, const map<string, Entry>& m);
+void ToJSON(const T& t, string* s);
 
+// Read t from a JSON document.
 template <typename T>
-bool VectorFromJSON(const string& s, Type type, vector<T>* v);
-
-template <typename Value>
-bool MapFromJSON(const string& s, Type type, map<string, Value>* m);
-
-bool FromJSON(
-        const string& s);
-
-template <typename V0>
-bool FromJSON(
-        const string& s,
-        Type t0, const string& n0, V0* v0);
-
-template <typename V0, typename V1>
-bool FromJSON(
-        const string& s,
-        Type t0, const string& n0, V0* v0,
-        Type t1, const string& n1, V1* v1);
-
-template <typename V0, typename V1, typename V2>
-bool FromJSON(
-        const string& s,
-        Type t0, const string& n0, V0* v0,
-        Type t1, const string& n1, V1* v1,
-        Type t2, const string& n2, V2* v2);
-
-template <typename V0, typename V1, typename V2, typename V3>
-bool FromJSON(
-        const string& s,
-        Type t0, const string& n0, V0* v0,
-        Type t1, const string& n1, V1* v1,
-        Type t2, const string& n2, V2* v2,
-        Type t3, const string& n3, V3* v3);
-
-template <typename V0, typename V1, typename V2, typename V3, typename V4>
-bool FromJSON(
-        const string& s,
-        Type t0, const string& n0, V0* v0,
-        Type t1, const string& n1, V1* v1,
-        Type t2, const string& n2, V2* v2,
-        Type t3, const string& n3, V3* v3,
-        Type t4, const string& n4, V4* v4);
-
-template <typename V0, typename V1, typename V2, typename V3, typename V4,
-                    typename V5>
-bool FromJSON(
-        const string& s,
-        Type t0, const string& n0, V0* v0,
-        Type t1, const string& n1, V1* v1,
-        Type t2, const string& n2, V2* v2,
-        Type t3, const string& n3, V3* v3,
-        Type t4, const string& n4, V4* v4,
-        Type t5, const string& n5, V5* v5);
-
-template <typename V0, typename V1, typename V2, typename V3, typename V4,
-                    typename V5, typename V6>
-bool FromJSON(
-        const string& s,
-        Type t0, const string& n0, V0* v0,
-        Type t1, const string& n1, V1* v1,
-        Type t2, const string& n2, V2* v2,
-        Type t3, const string& n3, V3* v3,
-        Type t4, const string& n4, V4* v4,
-        Type t5, const string& n5, V5* v5,
-        Type t6, const string& n6, V6* v6);
-
-template <typename V0, typename V1, typename V2, typename V3, typename V4,
-                    typename V5, typename V6, typename V7>
-bool FromJSON(
-        const string& s,
-        Type t0, const string& n0, V0* v0,
-        Type t1, const string& n1, V1* v1,
-        Type t2, const string& n2, V2* v2,
-        Type t3, const string& n3, V3* v3,
-        Type t4, const string& n4, V4* v4,
-        Type t5, const string& n5, V5* v5,
-        Type t6, const string& n6, V6* v6,
-        Type t7, const string& n7, V7* v7);
-
-template <typename V0, typename V1, typename V2, typename V3, typename V4,
-                    typename V5, typename V6, typename V7, typename V8>
-bool FromJSON(
-        const string& s,
-        Type t0, const string& n0, V0* v0,
-        Type t1, const string& n1, V1* v1,
-        Type t2, const string& n2, V2* v2,
-        Type t3, const string& n3, V3* v3,
-        Type t4, const string& n4, V4* v4,
-        Type t5, const string& n5, V5* v5,
-        Type t6, const string& n6, V6* v6,
-        Type t7, const string& n7, V7* v7,
-        Type t8, const string& n8, V8* v8);
-
-template <typename V0, typename V1, typename V2, typename V3, typename V4,
-                    typename V5, typename V6, typename V7, typename V8, typename V9>
-bool FromJSON(
-        const string& s,
-        Type t0, const string& n0, V0* v0,
-        Type t1, const string& n1, V1* v1,
-        Type t2, const string& n2, V2* v2,
-        Type t3, const string& n3, V3* v3,
-        Type t4, const string& n4, V4* v4,
-        Type t5, const string& n5, V5* v5,
-        Type t6, const string& n6, V6* v6,
-        Type t7, const string& n7, V7* v7,
-        Type t8, const string& n8, V8* v8,
-        Type t9, const string& n9, V9* v9);
+bool FromJSON(const string& s, T* t);
 
 // -----------------------------------------------------------------------------
 
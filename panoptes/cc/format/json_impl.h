@@ -3,364 +3,317 @@
 
 #include "json.h"
 
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <map>
 #include <string>
+#include <type_traits>
 #include <vector>
 
-#include "cc/base/string.h"
-#include "cc/base/unicode.h"
+#include "cc/base/logging.h"
 
+using std::enable_if;
+using std::is_floating_point;
+using std::is_integral;
+using std::is_same;
+using std::map;
+using std::numeric_limits;
 using std::string;
-using std::to_string;
 using std::vector;
 
-using unicode::CodePoint;
-using unicode::ReadNextUTF8;
-using unicode::ExpectNextUTF8;
-
 namespace json {
 
 // -----------------------------------------------------------------------------
-// To JSON.
+// Codecs.
 
-template <typename T>
-void AppendInt(const void* p, string* r) {
-    const T& n = *static_cast<const T*>(p);
-    *r += to_string(n);
-}
+template <typename T, typename Enable>
+struct Codec {
+    static void Write(const T& t, Writer* w) {
+        t.ToJSON(w);
+    }
+
+    static bool Read(const Value& v, T* t) {
+        return t->FromJSON(v);
+    }
+};
+
+template <>
+struct Codec<bool> {
+    static void Write(const bool& b, Writer* w) {
+        w->WriteBool(b);
+    }
+
+    static bool Read(const Value& v, bool* b) {
+        return v.GetBool(b);
+    }
+};
 
 template <typename T>
-void AppendFloat(const void* p, string* r) {
-    const T& f = *static_cast<const T*>(p);
-    *r += to_string(f);
-}
+struct Codec<T, typename enable_if<is_integral<T>::value &&
+                                   !is_same<T, bool>::value>::type> {
+    static void Write(const T& n, Writer* w) {
+        if (numeric_limits<T>::is_signed) {
+            w->WriteInt(static_cast<int64_t>(n));
+        } else {
+            w->WriteUInt(static_cast<uint64_t>(n));
+        }
+    }
+
+    static bool Read(const Value& v, T* n) {
+        if (numeric_limits<T>::is_signed) {
+            int64_t i;
+            if (!v.GetInt(&i) ||
+                    i < static_cast<int64_t>(numeric_limits<T>::min()) ||
+                    static_cast<int64_t>(numeric_limits<T>::max()) < i) {
+                return false;
+            }
+            *n = static_cast<T>(i);
+        } else {
+            uint64_t u;
+            if (!v.GetUInt(&u) ||
+                    static_cast<uint64_t>(numeric_limits<T>::max()) < u) {
+                return false;
+            }
+            *n = static_cast<T>(u);
+        }
+        return true;
+    }
+};
 
 template <typename T>
-void VectorToJSON(const vector<T>& v, Type type, string* s) {
-    *s += '[';
-    for (size_t i = 0; i < v.size(); ++i) {
-        APPEND_TYPE[type](static_cast<const void*>(&v[i]), s);
-        if (i < v.size() - 1) {
-            *s += ',';
+struct Codec<T, typename enable_if<is_floating_point<T>::value>::type> {
+    static void Write(const T& f, Writer* w) {
+        w->WriteDouble(static_cast<double>(f), numeric_limits<T>::max_digits10);
+    }
+
+    static bool Read(const Value& v, T* f) {
+        double d;
+        if (!v.GetDouble(&d)) {
+            return false;
         }
+        *f = static_cast<T>(d);
+        return true;
     }
-    *s += ']';
-}
+};
 
-template <typename Value>
-void MapToJSON(const map<string, Value>& m, Type type, string* s) {
-    vector<Entry> entries;
-    entries.reserve(m.size());
-    for (auto& it : m) {
-        void* value = static_cast<void*>(const_cast<Value*>(&it.second));
-        Entry e(type, it.first, value);
-        entries.emplace_back(e);
+template <>
+struct Codec<string> {
+    static void Write(const string& s, Writer* w) {
+        w->WriteString(s);
     }
 
-    string tmp;
-    EntriesToJSON(entries, &tmp);
-    *s += tmp;
-}
+    static bool Read(const Value& v, string* s) {
+        return v.GetString(s);
+    }
+};
+
+template <>
+struct Codec<throol> {
+    static void Write(const throol& t, Writer* w) {
+        w->WriteString(t.ToStr());
+    }
+
+    static bool Read(const Value& v, throol* t) {
+        string s;
+        return v.GetString(&s) && t->FromStr(s);
+    }
+};
 
 template <typename T>
-void* VoidPtr(const T& t) {
-        const void* p = static_cast<const void*>(&t);
-        return const_cast<void*>(p);
-}
+struct Codec<vector<T> > {
+    static void Write(const vector<T>& v, Writer* w) {
+        w->BeginArray();
+        for (auto& t : v) {
+            Codec<T>::Write(t, w);
+        }
+        w->EndArray();
+    }
 
-template <typename V0>
-void ToJSON(
-        string* s,
-        Type type0, const string& key0, const V0& value0) {
-    vector<Entry> v;
-    v.reserve(1);
-    v.emplace_back(Entry(type0, key0, VoidPtr(&value0)));
-    EntriesToJSON(v, s);
-}
+    static bool Read(const Value& v, vector<T>* out) {
+        out->clear();
+        if (!v.IsArray()) {
+            return false;
+        }
 
-template <typename V0, typename V1>
-void ToJSON(
-        string* s,
-        Type type0, const string& key0, const V0& value0,
-        Type type1, const string& key1, const V1& value1) {
-    vector<Entry> v;
-    v.reserve(2);
-    v.emplace_back(Entry(type0, key0, VoidPtr(&value0)));
-    v.emplace_back(Entry(type1, key1, VoidPtr(&value1)));
-    EntriesToJSON(v, s);
-}
+        out->resize(v.size());
+        size_t i = 0;
+        for (Value e = v.FirstChild(); e.IsValid(); e = e.Next()) {
+            if (!Codec<T>::Read(e, &(*out)[i++])) {
+                return false;
+            }
+        }
+        return true;
+    }
+};
 
-template <typename V0, typename V1, typename V2>
-void ToJSON(
-        string* s,
-        Type type0, const string& key0, const V0& value0,
-        Type type1, const string& key1, const V1& value1,
-        Type type2, const string& key2, const V2& value2) {
-    vector<Entry> v;
-    v.reserve(3);
-    v.emplace_back(Entry(type0, key0, VoidPtr(&value0)));
-    v.emplace_back(Entry(type1, key1, VoidPtr(&value1)));
-    v.emplace_back(Entry(type2, key2, VoidPtr(&value2)));
-    EntriesToJSON(v, s);
-}
+template <typename T>
+struct Codec<map<string, T> > {
+    static void Write(const map<string, T>& m, Writer* w) {
+        w->BeginObject();
+        for (auto& it : m) {
+            w->WriteKey(it.first);
+            Codec<T>::Write(it.second, w);
+        }
+        w->EndObject();
+    }
 
-template <typename V0, typename V1, typename V2, typename V3>
-void ToJSON(
-        string* s,
-        Type type0, const string& key0, const V0& value0,
-        Type type1, const string& key1, const V1& value1,
-        Type type2, const string& key2, const V2& value2,
-        Type type3, const string& key3, const V3& value3) {
-    vector<Entry> v;
-    v.reserve(4);
-    v.emplace_back(Entry(type0, key0, VoidPtr(&value0)));
-    v.emplace_back(Entry(type1, key1, VoidPtr(&value1)));
-    v.emplace_back(Entry(type2, key2, VoidPtr(&value2)));
-    v.emplace_back(Entry(type3, key3, VoidPtr(&value3)));
-    EntriesToJSON(v, s);
-}
+    static bool Read(const Value& v, map<string, T>* m) {
+        m->clear();
+        if (!v.IsObject()) {
+            return false;
+        }
 
-template <typename V0, typename V1, typename V2, typename V3, typename V4>
-void ToJSON(
-        string* s,
-        Type type0, const string& key0, const V0& value0,
-        Type type1, const string& key1, const V1& value1,
-        Type type2, const string& key2, const V2& value2,
-        Type type3, const string& key3, const V3& value3,
-        Type type4, const string& key4, const V4& value4) {
-    vector<Entry> v;
-    v.reserve(5);
-    v.emplace_back(Entry(type0, key0, VoidPtr(&value0)));
-    v.emplace_back(Entry(type1, key1, VoidPtr(&value1)));
-    v.emplace_back(Entry(type2, key2, VoidPtr(&value2)));
-    v.emplace_back(Entry(type3, key3, VoidPtr(&value3)));
-    v.emplace_back(Entry(type4, key4, VoidPtr(&value4)));
-    EntriesToJSON(v, s);
-}
+        string key;
+        for (Value k = v.FirstChild(); k.IsValid(); k = k.Next().Next()) {
+            if (!k.GetString(&key) || !Codec<T>::Read(k.Next(), &(*m)[key])) {
+                return false;
+            }
+        }
+        return true;
+    }
+};
 
-template <typename V0, typename V1, typename V2, typename V3, typename V4,
-                    typename V5>
-void ToJSON(
-        string* s,
-        Type type0, const string& key0, const V0& value0,
-        Type type1, const string& key1, const V1& value1,
-        Type type2, const string& key2, const V2& value2,
-        Type type3, const string& key3, const V3& value3,
-        Type type4, const string& key4, const V4& value4,
-        Type type5, const string& key5, const V5& value5) {
-    vector<Entry> v;
-    v.reserve(6);
-    v.emplace_back(Entry(type0, key0, VoidPtr(&value0)));
-    v.emplace_back(Entry(type1, key1, VoidPtr(&value1)));
-    v.emplace_back(Entry(type2, key2, VoidPtr(&value2)));
-    v.emplace_back(Entry(type3, key3, VoidPtr(&value3)));
-    v.emplace_back(Entry(type4, key4, VoidPtr(&value4)));
-    v.emplace_back(Entry(type5, key5, VoidPtr(&value5)));
-    EntriesToJSON(v, s);
+template <typename E, const EnumStrings<E>& Strings>
+void EnumCodec<E, Strings>::Write(const E& e, Writer* w) {
+    w->WriteString(Strings.GetString(e));
 }
 
-template <typename V0, typename V1, typename V2, typename V3, typename V4,
-                    typename V5, typename V6>
-void ToJSON(
-        string* s,
-        Type type0, const string& key0, const V0& value0,
-        Type type1, const string& key1, const V1& value1,
-        Type type2, const string& key2, const V2& value2,
-        Type type3, const string& key3, const V3& value3,
-        Type type4, const string& key4, const V4& value4,
-        Type type5, const string& key5, const V5& value5,
-        Type type6, const string& key6, const V6& value6) {
-    vector<Entry> v;
-    v.reserve(7);
-    v.emplace_back(Entry(type0, key0, VoidPtr(&value0)));
-    v.emplace_back(Entry(type1, key1, VoidPtr(&value1)));
-    v.emplace_back(Entry(type2, key2, VoidPtr(&value2)));
-    v.emplace_back(Entry(type3, key3, VoidPtr(&value3)));
-    v.emplace_back(Entry(type4, key4, VoidPtr(&value4)));
-    v.emplace_back(Entry(type5, key5, VoidPtr(&value5)));
-    v.emplace_back(Entry(type6, key6, VoidPtr(&value6)));
-    EntriesToJSON(v, s);
+template <typename E, const EnumStrings<E>& Strings>
+bool EnumCodec<E, Strings>::Read(const Value& v, E* e) {
+    string s;
+    return v.GetString(&s) && Strings.MaybeGetEnumValue(s, e);
 }
 
+// -----------------------------------------------------------------------------
+// Schemas.
 
-template <typename V0, typename V1, typename V2, typename V3, typename V4,
-                    typename V5, typename V6, typename V7>
-void ToJSON(
-        string* s,
-        Type type0, const string& key0, const V0& value0,
-        Type type1, const string& key1, const V1& value1,
-        Type type2, const string& key2, const V2& value2,
-        Type type3, const string& key3, const V3& value3,
-        Type type4, const string& key4, const V4& value4,
-        Type type5, const string& key5, const V5& value5,
-        Type type6, const string& key6, const V6& value6,
-        Type type7, const string& key7, const V7& value7) {
-    vector<Entry> v;
-    v.reserve(8);
-    v.emplace_back(Entry(type0, key0, VoidPtr(&value0)));
-    v.emplace_back(Entry(type1, key1, VoidPtr(&value1)));
-    v.emplace_back(Entry(type2, key2, VoidPtr(&value2)));
-    v.emplace_back(Entry(type3, key3, VoidPtr(&value3)));
-    v.emplace_back(Entry(type4, key4, VoidPtr(&value4)));
-    v.emplace_back(Entry(type5, key5, VoidPtr(&value5)));
-    v.emplace_back(Entry(type6, key6, VoidPtr(&value6)));
-    v.emplace_back(Entry(type7, key7, VoidPtr(&value7)));
-    EntriesToJSON(v, s);
-}
-
-template <typename V0, typename V1, typename V2, typename V3, typename V4,
-                    typename V5, typename V6, typename V7, typename V8>
-void ToJSON(
-        string* s,
-        Type type0, const string& key0, const V0& value0,
-        Type type1, const string& key1, const V1& value1,
-        Type type2, const string& key2, const V2& value2,
-        Type type3, const string& key3, const V3& value3,
-        Type type4, const string& key4, const V4& value4,
-        Type type5, const string& key5, const V5& value5,
-        Type type6, const string& key6, const V6& value6,
-        Type type7, const string& key7, const V7& value7,
-        Type type8, const string& key8, const V8& value8) {
-    vector<Entry> v;
-    v.reserve(9);
-    v.emplace_back(Entry(type0, key0, VoidPtr(&value0)));
-    v.emplace_back(Entry(type1, key1, VoidPtr(&value1)));
-    v.emplace_back(Entry(type2, key2, VoidPtr(&value2)));
-    v.emplace_back(Entry(type3, key3, VoidPtr(&value3)));
-    v.emplace_back(Entry(type4, key4, VoidPtr(&value4)));
-    v.emplace_back(Entry(type5, key5, VoidPtr(&value5)));
-    v.emplace_back(Entry(type6, key6, VoidPtr(&value6)));
-    v.emplace_back(Entry(type7, key7, VoidPtr(&value7)));
-    v.emplace_back(Entry(type8, key8, VoidPtr(&value8)));
-    EntriesToJSON(v, s);
+template <typename C, typename T, T C::*M, typename TCodec>
+void Field<C, T, M, TCodec>::Write(const C& c, Writer* w) {
+    TCodec::Write(c.*M, w);
 }
 
-template <typename V0, typename V1, typename V2, typename V3, typename V4,
-                    typename V5, typename V6, typename V7, typename V8, typename V9>
-void ToJSON(
-        string* s,
-        Type type0, const string& key0, const V0& value0,
-        Type type1, const string& key1, const V1& value1,
-        Type type2, const string& key2, const V2& value2,
-        Type type3, const string& key3, const V3& value3,
-        Type type4, const string& key4, const V4& value4,
-        Type type5, const string& key5, const V5& value5,
-        Type type6, const string& key6, const V6& value6,
-        Type type7, const string& key7, const V7& value7,
-        Type type8, const string& key8, const V8& value8,
-        Type type9, const string& key9, const V9& value9) {
-    vector<Entry> v;
-    v.reserve(10);
-    v.emplace_back(Entry(type0, key0, VoidPtr(&value0)));
-    v.emplace_back(Entry(type1, key1, VoidPtr(&value1)));
-    v.emplace_back(Entry(type2, key2, VoidPtr(&value2)));
-    v.emplace_back(Entry(type3, key3, VoidPtr(&value3)));
-    v.emplace_back(Entry(type4, key4, VoidPtr(&value4)));
-    v.emplace_back(Entry(type5, key5, VoidPtr(&value5)));
-    v.emplace_back(Entry(type6, key6, VoidPtr(&value6)));
-    v.emplace_back(Entry(type7, key7, VoidPtr(&value7)));
-    v.emplace_back(Entry(type8, key8, VoidPtr(&value8)));
-    v.emplace_back(Entry(type9, key9, VoidPtr(&value9)));
-    EntriesToJSON(v, s);
+template <typename C, typename T, T C::*M, typename TCodec>
+bool Field<C, T, M, TCodec>::Read(const Value& v, C* c) {
+    return TCodec::Read(v, &(c->*M));
 }
 
-// ----------------------------------------------------------------------------
-// From JSON.
+// Unrolls a schema's fields, from field I on.  Reads dispatch on the field
+// index through a chain of comparisons against constants, which compiles to a
+// switch.
+template <typename C, size_t I, typename... Fields>
+struct FieldChain {
+    static void Write(const char* const*, const size_t*, const C&, Writer*) {}
 
-template <typename T>
-bool ParseInt(const string& s, size_t* x, void* p) {
-    T n;
-    if (!String::ToInt(s, x, &n)) {
+    static bool Read(size_t, const Value&, C*) {
         return false;
     }
-
-    *static_cast<T*>(p) = n;
-    return true;
-}
-
-template <typename T>
-bool ParseFloat(const string& s, size_t* x, void* p) {
-    T f;
-    if (!String::ToFloat(s, x, &f)) {
-        return false;
+};
+
+template <typename C, size_t I, typename F, typename... Rest>
+struct FieldChain<C, I, F, Rest...> {
+    static void Write(const char* const* keys, const size_t* key_sizes,
+                      const C& c, Writer* w) {
+        w->WriteKey(keys[I], key_sizes[I]);
+        F::Write(c, w);
+        FieldChain<C, I + 1, Rest...>::Write(keys, key_sizes, c, w);
     }
 
-    *static_cast<T*>(p) = f;
-    return true;
+    static bool Read(size_t index, const Value& v, C* c) {
+        if (index == I) {
+            return F::Read(v, c);
+        }
+        return FieldChain<C, I + 1, Rest...>::Read(index, v, c);
+    }
+};
+
+inline uint32_t HashKey(const char* s, size_t size, uint32_t seed) {
+    // FNV-1a, offset by the seed.
+    uint32_t h = 2166136261u ^ (seed * 0x9E3779B9u);
+    for (size_t i = 0; i < size; ++i) {
+        h ^= static_cast<uint8_t>(s[i]);
+        h *= 16777619u;
+    }
+    return h ^ (h >> 15);
 }
 
-template <typename T>
-bool VectorFromJSON(const string& orig_s, Type type, vector<T>* v) {
-    v->clear();
+template <typename C, typename... Fields>
+constexpr size_t Schema<C, Fields...>::NUM_FIELDS;
 
-    string s;
-    RemoveWhitespace(orig_s, &s);
+template <typename C, typename... Fields>
+constexpr size_t Schema<C, Fields...>::NUM_SLOTS;
 
-    // Read "[".
-    size_t x = 0;
-    CodePoint c;
-    if (!ExpectNextUTF8(s, &x, &c, '[')) {
-        return false;
-    }
-
-    while (true) {
-        // Parse an entry.
-        T t;
-        if (!PARSE_TYPE[type](s, &x, &t)) {
-            return false;
-        }
-        v->emplace_back(t);
+template <typename C, typename... Fields>
+template <typename... Keys>
+Schema<C, Fields...>::Schema(Keys... keys) {
+    static_assert(sizeof...(Keys) == sizeof...(Fields),
+                  "Schemas take one key per field.");
+    static_assert(sizeof...(Fields) <= 64, "Too many fields to track.");
 
-        if (!ReadNextUTF8(s, &x, &c)) {
-            return c == ']';
-        }
-        if (c == ',') {
-            ;
-        } else if (c == ']') {
-            break;
-        } else {
-            return false;
-        }
+    const char* const tmp[] = {keys...};
+    for (size_t i = 0; i < NUM_FIELDS; ++i) {
+        keys_[i] = tmp[i];
+        key_sizes_[i] = strlen(tmp[i]);
     }
 
-    if (!ExpectNextUTF8(s, &x, &c, ']')) {
-        return false;
-    }
+    seed_ = FindPerfectHash(keys_, key_sizes_, NUM_FIELDS, NUM_SLOTS, slots_);
+}
 
-    return true;
+template <typename C, typename... Fields>
+size_t Schema<C, Fields...>::FindField(const char* s, size_t size) const {
+    uint8_t index = slots_[HashKey(s, size, seed_) & (NUM_SLOTS - 1)];
+    if (index == 0xFF || key_sizes_[index] != size ||
+            memcmp(keys_[index], s, size)) {
+        return NUM_FIELDS;
+    }
+    return index;
 }
 
-template <typename Value>
-bool MapFromJSON(const string& orig_s, Type type, map<string, Value>* m) {
-    m->clear();
+template <typename C, typename... Fields>
+void Schema<C, Fields...>::Write(const C& c, Writer* w) const {
+    w->BeginObject();
+    FieldChain<C, 0, Fields...>::Write(keys_, key_sizes_, c, w);
+    w->EndObject();
+}
 
-    string s;
-    RemoveWhitespace(orig_s, &s);
+template <typename C, typename... Fields>
+bool Schema<C, Fields...>::Read(const Value& v, C* c) const {
+    if (!v.IsObject()) {
+        ERROR("[JSON] Expected { is missing.\n");
+        return false;
+    }
 
-    // Read "{".
-    size_t x = 0;
-    CodePoint c;
-    if (!ExpectNextUTF8(s, &x, &c, '{')) {
+    if (v.size() != 2 * NUM_FIELDS) {
+        ERROR("[JSON] Expected %zu fields, got %zu.\n", NUM_FIELDS,
+              v.size() / 2);
         return false;
     }
 
-    while (true) {
-        // Parse an entry.
-        string key;
-        Value value;
-        if (!ReadKeyValue(s, type, &x, &key, &value)) {
+    uint64_t seen = 0;
+    string tmp;
+    for (Value k = v.FirstChild(); k.IsValid(); k = k.Next().Next()) {
+        const char* s;
+        size_t size;
+        if (!k.GetStringView(&s, &size, &tmp)) {
+            ERROR("[JSON] Parsing field key failed.\n");
             return false;
         }
-        (*m)[key] = value;
 
-        // Read "," (continue) or "}" (done).
-        if (!ReadNextUTF8(s, &x, &c)) {
-            return c == '}';
+        size_t index = FindField(s, size);
+        if (index == NUM_FIELDS) {
+            ERROR("[JSON] Unknown key: [%s].\n", string(s, size).c_str());
+            return false;
         }
-        if (c == '}') {
-            break;
-        } else if (c == ',') {
-            ;
-        } else {
+
+        uint64_t bit = 1ull << index;
+        if (seen & bit) {
+            ERROR("[JSON] Duplicate key: [%s].\n", keys_[index]);
+            return false;
+        }
+        seen |= bit;
+
+        if (!FieldChain<C, 0, Fields...>::Read(index, k.Next(), c)) {
+            ERROR("[JSON] Parsing field [%s] failed.\n", keys_[index]);
             return false;
         }
     }
@@ -368,189 +321,24 @@ bool MapFromJSON(const string& orig_s, Type type, map<string, Value>* m) {
     return true;
 }
 
-template <typename V0>
-bool FromJSON(
-        const string& s,
-        Type type0, const string& key0, V0* value0) {
-    map<string, Entry> m;
-    m[key0] = Entry(type0, key0, static_cast<void*>(value0));
-    return EntriesFromJSON(s, m);
-}
-
-template <typename V0, typename V1>
-bool FromJSON(
-        const string& s,
-        Type type0, const string& key0, V0* value0,
-        Type type1, const string& key1, V1* value1) {
-    map<string, Entry> m;
-    m[key0] = Entry(type0, key0, static_cast<void*>(value0));
-    m[key1] = Entry(type1, key1, static_cast<void*>(value1));
-    return EntriesFromJSON(s, m);
-}
-
-template <typename V0, typename V1, typename V2>
-bool FromJSON(
-        const string& s,
-        Type type0, const string& key0, V0* value0,
-        Type type1, const string& key1, V1* value1,
-        Type type2, const string& key2, V2* value2) {
-    map<string, Entry> m;
-    m[key0] = Entry(type0, key0, static_cast<void*>(value0));
-    m[key1] = Entry(type1, key1, static_cast<void*>(value1));
-    m[key2] = Entry(type2, key2, static_cast<void*>(value2));
-    return EntriesFromJSON(s, m);
-}
-
-template <typename V0, typename V1, typename V2, typename V3>
-bool FromJSON(
-        const string& s,
-        Type type0, const string& key0, V0* value0,
-        Type type1, const string& key1, V1* value1,
-        Type type2, const string& key2, V2* value2,
-        Type type3, const string& key3, V3* value3) {
-    map<string, Entry> m;
-    m[key0] = Entry(type0, key0, static_cast<void*>(value0));
-    m[key1] = Entry(type1, key1, static_cast<void*>(value1));
-    m[key2] = Entry(type2, key2, static_cast<void*>(value2));
-    m[key3] = Entry(type3, key3, static_cast<void*>(value3));
-    return EntriesFromJSON(s, m);
-}
-
-template <typename V0, typename V1, typename V2, typename V3, typename V4>
-bool FromJSON(
-        const string& s,
-        Type type0, const string& key0, V0* value0,
-        Type type1, const string& key1, V1* value1,
-        Type type2, const string& key2, V2* value2,
-        Type type3, const string& key3, V3* value3,
-        Type type4, const string& key4, V4* value4) {
-    map<string, Entry> m;
-    m[key0] = Entry(type0, key0, static_cast<void*>(value0));
-    m[key1] = Entry(type1, key1, static_cast<void*>(value1));
-    m[key2] = Entry(type2, key2, static_cast<void*>(value2));
-    m[key3] = Entry(type3, key3, static_cast<void*>(value3));
-    m[key4] = Entry(type4, key4, static_cast<void*>(value4));
-    return EntriesFromJSON(s, m);
-}
-
-template <typename V0, typename V1, typename V2, typename V3, typename V4,
-                    typename V5>
-bool FromJSON(
-        const string& s,
-        Type type0, const string& key0, V0* value0,
-        Type type1, const string& key1, V1* value1,
-        Type type2, const string& key2, V2* value2,
-        Type type3, const string& key3, V3* value3,
-        Type type4, const string& key4, V4* value4,
-        Type type5, const string& key5, V5* value5) {
-    map<string, Entry> m;
-    m[key0] = Entry(type0, key0, static_cast<void*>(value0));
-    m[key1] = Entry(type1, key1, static_cast<void*>(value1));
-    m[key2] = Entry(type2, key2, static_cast<void*>(value2));
-    m[key3] = Entry(type3, key3, static_cast<void*>(value3));
-    m[key4] = Entry(type4, key4, static_cast<void*>(value4));
-    m[key5] = Entry(type5, key5, static_cast<void*>(value5));
-    return EntriesFromJSON(s, m);
-}
-
-template <typename V0, typename V1, typename V2, typename V3, typename V4,
-                    typename V5, typename V6>
-bool FromJSON(
-        const string& s,
-        Type type0, const string& key0, V0* value0,
-        Type type1, const string& key1, V1* value1,
-        Type type2, const string& key2, V2* value2,
-        Type type3, const string& key3, V3* value3,
-        Type type4, const string& key4, V4* value4,
-        Type type5, const string& key5, V5* value5,
-        Type type6, const string& key6, V6* value6) {
-    map<string, Entry> m;
-    m[key0] = Entry(type0, key0, static_cast<void*>(value0));
-    m[key1] = Entry(type1, key1, static_cast<void*>(value1));
-    m[key2] = Entry(type2, key2, static_cast<void*>(value2));
-    m[key3] = Entry(type3, key3, static_cast<void*>(value3));
-    m[key4] = Entry(type4, key4, static_cast<void*>(value4));
-    m[key5] = Entry(type5, key5, static_cast<void*>(value5));
-    m[key6] = Entry(type6, key6, static_cast<void*>(value6));
-    return EntriesFromJSON(s, m);
-}
-
-template <typename V0, typename V1, typename V2, typename V3, typename V4,
-                    typename V5, typename V6, typename V7>
-bool FromJSON(
-        const string& s,
-        Type type0, const string& key0, V0* value0,
-        Type type1, const string& key1, V1* value1,
-        Type type2, const string& key2, V2* value2,
-        Type type3, const string& key3, V3* value3,
-        Type type4, const string& key4, V4* value4,
-        Type type5, const string& key5, V5* value5,
-        Type type6, const string& key6, V6* value6,
-        Type type7, const string& key7, V7* value7) {
-    map<string, Entry> m;
-    m[key0] = Entry(type0, key0, static_cast<void*>(value0));
-    m[key1] = Entry(type1, key1, static_cast<void*>(value1));
-    m[key2] = Entry(type2, key2, static_cast<void*>(value2));
-    m[key3] = Entry(type3, key3, static_cast<void*>(value3));
-    m[key4] = Entry(type4, key4, static_cast<void*>(value4));
-    m[key5] = Entry(type5, key5, static_cast<void*>(value5));
-    m[key6] = Entry(type6, key6, static_cast<void*>(value6));
-    m[key7] = Entry(type7, key7, static_cast<void*>(value7));
-    return EntriesFromJSON(s, m);
-}
+// -----------------------------------------------------------------------------
+// Documents.
 
-template <typename V0, typename V1, typename V2, typename V3, typename V4,
-                    typename V5, typename V6, typename V7, typename V8>
-bool FromJSON(
-        const string& s,
-        Type type0, const string& key0, V0* value0,
-        Type type1, const string& key1, V1* value1,
-        Type type2, const string& key2, V2* value2,
-        Type type3, const string& key3, V3* value3,
-        Type type4, const string& key4, V4* value4,
-        Type type5, const string& key5, V5* value5,
-        Type type6, const string& key6, V6* value6,
-        Type type7, const string& key7, V7* value7,
-        Type type8, const string& key8, V8* value8) {
-    map<string, Entry> m;
-    m[key0] = Entry(type0, key0, static_cast<void*>(value0));
-    m[key1] = Entry(type1, key1, static_cast<void*>(value1));
-    m[key2] = Entry(type2, key2, static_cast<void*>(value2));
-    m[key3] = Entry(type3, key3, static_cast<void*>(value3));
-    m[key4] = Entry(type4, key4, static_cast<void*>(value4));
-    m[key5] = Entry(type5, key5, static_cast<void*>(value5));
-    m[key6] = Entry(type6, key6, static_cast<void*>(value6));
-    m[key7] = Entry(type7, key7, static_cast<void*>(value7));
-    m[key8] = Entry(type8, key8, static_cast<void*>(value8));
-    return EntriesFromJSON(s, m);
+template <typename T>
+void ToJSON(const T& t, string* s) {
+    s->clear();
+    Writer w(s);
+    Codec<T>::Write(t, &w);
 }
 
-template <typename V0, typename V1, typename V2, typename V3, typename V4,
-                    typename V5, typename V6, typename V7, typename V8, typename V9>
-bool FromJSON(
-        const string& s,
-        Type type0, const string& key0, V0* value0,
-        Type type1, const string& key1, V1* value1,
-        Type type2, const string& key2, V2* value2,
-        Type type3, const string& key3, V3* value3,
-        Type type4, const string& key4, V4* value4,
-        Type type5, const string& key5, V5* value5,
-        Type type6, const string& key6, V6* value6,
-        Type type7, const string& key7, V7* value7,
-        Type type8, const string& key8, V8* value8,
-        Type type9, const string& key9, V9* value9) {
-    map<string, Entry> m;
-    m[key0] = Entry(type0, key0, static_cast<void*>(value0));
-    m[key1] = Entry(type1, key1, static_cast<void*>(value1));
-    m[key2] = Entry(type2, key2, static_cast<void*>(value2));
-    m[key3] = Entry(type3, key3, static_cast<void*>(value3));
-    m[key4] = Entry(type4, key4, static_cast<void*>(value4));
-    m[key5] = Entry(type5, key5, static_cast<void*>(value5));
-    m[key6] = Entry(type6, key6, static_cast<void*>(value6));
-    m[key7] = Entry(type7, key7, static_cast<void*>(value7));
-    m[key8] = Entry(type8, key8, static_cast<void*>(value8));
-    m[key9] = Entry(type9, key9, static_cast<void*>(value9));
-    return EntriesFromJSON(s, m);
+template <typename T>
+bool FromJSON(const string& s, T* t) {
+    Tape tape;
+    if (!tape.Init(s)) {
+        ERROR("[JSON] Malformed document.\n");
+        return false;
+    }
+    return Codec<T>::Read(tape.root(), t);
 }
 
 // -----------------------------------------------------------------------------
@@ -0,0 +1,479 @@
+#include "json_tape.h"
+
+#include <cassert>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "cc/base/unicode.h"
+
+using std::string;
+using std::vector;
+
+using unicode::AppendUTF8;
+using unicode::CodePoint;
+
+// Containers nested deeper than this are rejected (parsing recurses).
+#define JSON_TAPE_MAX_DEPTH 512
+
+// Longest number text read by GetDouble().
+#define JSON_TAPE_MAX_NUMBER_LEN 64
+
+namespace json {
+
+// -----------------------------------------------------------------------------
+// Value.
+
+const TapeNode& Value::node() const {
+    assert(IsValid());
+    return tape_->nodes()[index_];
+}
+
+NodeKind Value::kind() const {
+    return static_cast<NodeKind>(node().kind);
+}
+
+bool Value::IsBool() const {
+    NodeKind k = kind();
+    return k == NK_TRUE || k == NK_FALSE;
+}
+
+size_t Value::size() const {
+    return node().size;
+}
+
+const char* Value::data() const {
+    return tape_->data() + node().begin;
+}
+
+size_t Value::length() const {
+    const TapeNode& n = node();
+    return n.end - n.begin;
+}
+
+void Value::GetRaw(string* s) const {
+    s->assign(data(), length());
+}
+
+Value Value::FirstChild() const {
+    const TapeNode& n = node();
+    return Value(tape_, index_ + 1, n.next);
+}
+
+Value Value::Next() const {
+    return Value(tape_, node().next, end_);
+}
+
+bool Value::Find(const char* key, Value* value) const {
+    if (!IsObject()) {
+        return false;
+    }
+
+    size_t key_size = strlen(key);
+    for (Value k = FirstChild(); k.IsValid(); k = k.Next().Next()) {
+        if (k.Equals(key, key_size)) {
+            *value = k.Next();
+            return true;
+        }
+    }
+    return false;
+}
+
+bool Value::Equals(const char* s, size_t size) const {
+    if (!IsString()) {
+        return false;
+    }
+
+    const TapeNode& n = node();
+    if (!n.has_escapes) {
+        return length() == size && !memcmp(data(), s, size);
+    }
+
+    string tmp;
+    return GetString(&tmp) && tmp.size() == size &&
+           !memcmp(tmp.data(), s, size);
+}
+
+bool Value::GetString(string* s) const {
+    if (!IsString()) {
+        return false;
+    }
+
+    s->clear();
+    if (!node().has_escapes) {
+        s->assign(data(), length());
+        return true;
+    }
+    return Unescape(data(), length(), s);
+}
+
+bool Value::GetStringView(const char** s, size_t* size, string* tmp) const {
+    if (!IsString()) {
+        return false;
+    }
+
+    if (!node().has_escapes) {
+        *s = data();
+        *size = length();
+        return true;
+    }
+
+    if (!GetString(tmp)) {
+        return false;
+    }
+    *s = tmp->data();
+    *size = tmp->size();
+    return true;
+}
+
+bool Value::GetBool(bool* b) const {
+    if (!IsBool()) {
+        return false;
+    }
+
+    *b = kind() == NK_TRUE;
+    return true;
+}
+
+static bool ParseDigits(const char* s, size_t size, uint64_t* n) {
+    if (!size) {
+        return false;
+    }
+
+    uint64_t r = 0;
+    for (size_t i = 0; i < size; ++i) {
+        char c = s[i];
+        if (c < '0' || '9' < c) {
+            return false;
+        }
+        uint64_t digit = static_cast<uint64_t>(c - '0');
+        if ((~0ull - digit) / 10 < r) {
+            return false;
+        }
+        r = r * 10 + digit;
+    }
+    *n = r;
+    return true;
+}
+
+bool Value::GetUInt(uint64_t* n) const {
+    return IsNumber() && ParseDigits(data(), length(), n);
+}
+
+bool Value::GetInt(int64_t* n) const {
+    if (!IsNumber()) {
+        return false;
+    }
+
+    const char* s = data();
+    size_t size = length();
+    bool negative = size && *s == '-';
+    if (negative) {
+        ++s;
+        --size;
+    }
+
+    uint64_t u;
+    uint64_t max = static_cast<uint64_t>(INT64_MAX) + (negative ? 1 : 0);
+    if (!ParseDigits(s, size, &u) || max < u) {
+        return false;
+    }
+    *n = negative ? static_cast<int64_t>(0 - u) : static_cast<int64_t>(u);
+    return true;
+}
+
+bool Value::GetDouble(double* d) const {
+    if (!IsNumber()) {
+        return false;
+    }
+
+    // The buffer need not be terminated after the number, so copy it.
+    char buf[JSON_TAPE_MAX_NUMBER_LEN + 1];
+    size_t size = length();
+    if (!size || JSON_TAPE_MAX_NUMBER_LEN < size) {
+        return false;
+    }
+    memcpy(buf, data(), size);
+    buf[size] = '\0';
+
+    char* end;
+    *d = strtod(buf, &end);
+    return end == buf + size;
+}
+
+// -----------------------------------------------------------------------------
+// Tape.
+
+Value Tape::root() const {
+    return Value(this, 0, nodes_.size());
+}
+
+void Tape::SkipWhitespace(size_t* x) const {
+    while (*x < size_) {
+        char c = data_[*x];
+        if (c != ' ' && c != '\n' && c != '\r' && c != '\t') {
+            break;
+        }
+        ++(*x);
+    }
+}
+
+bool Tape::Expect(size_t* x, char c) const {
+    SkipWhitespace(x);
+    if (*x == size_ || data_[*x] != c) {
+        return false;
+    }
+    ++(*x);
+    return true;
+}
+
+static TapeNode MakeNode(NodeKind kind, size_t begin) {
+    TapeNode n;
+    n.kind = static_cast<uint8_t>(kind);
+    n.has_escapes = false;
+    n.size = 0;
+    n.begin = begin;
+    n.end = begin;
+    n.next = 0;
+    return n;
+}
+
+bool Tape::ParseLiteral(size_t* x, const char* literal, NodeKind kind) {
+    size_t len = strlen(literal);
+    if (size_ - *x < len || memcmp(data_ + *x, literal, len)) {
+        return false;
+    }
+    TapeNode n = MakeNode(kind, *x);
+    *x += len;
+    n.end = *x;
+    n.next = nodes_.size() + 1;
+    nodes_.emplace_back(n);
+    return true;
+}
+
+bool Tape::ParseNumber(size_t* x) {
+    size_t begin = *x;
+    while (*x < size_) {
+        char c = data_[*x];
+        if (!(('0' <= c && c <= '9') || c == '-' || c == '+' || c == '.' ||
+              c == 'e' || c == 'E')) {
+            break;
+        }
+        ++(*x);
+    }
+    if (*x == begin) {
+        return false;
+    }
+    TapeNode n = MakeNode(NK_NUMBER, begin);
+    n.end = *x;
+    n.next = nodes_.size() + 1;
+    nodes_.emplace_back(n);
+    return true;
+}
+
+bool Tape::ParseString(size_t* x) {
+    // Skip the opening quote.
+    ++(*x);
+
+    TapeNode n = MakeNode(NK_STRING, *x);
+    while (*x < size_) {
+        char c = data_[*x];
+        if (c == '"') {
+            n.end = *x;
+            ++(*x);
+            n.next = nodes_.size() + 1;
+            nodes_.emplace_back(n);
+            return true;
+        } else if (c == '\\') {
+            n.has_escapes = true;
+            *x += 2;
+        } else {
+            ++(*x);
+        }
+    }
+    return false;
+}
+
+bool Tape::ParseValue(size_t* x, size_t depth) {
+    SkipWhitespace(x);
+    if (*x == size_) {
+        return false;
+    }
+
+    char c = data_[*x];
+    if (c == '"') {
+        return ParseString(x);
+    } else if (c == 't') {
+        return ParseLiteral(x, "true", NK_TRUE);
+    } else if (c == 'f') {
+        return ParseLiteral(x, "false", NK_FALSE);
+    } else if (c == 'n') {
+        return ParseLiteral(x, "null", NK_NULL);
+    } else if (c != '{' && c != '[') {
+        return ParseNumber(x);
+    }
+
+    if (JSON_TAPE_MAX_DEPTH <= depth) {
+        return false;
+    }
+
+    // A container.  Children are appended after it, so refer to it by index
+    // (the vector may grow).
+    bool is_object = c == '{';
+    char close = is_object ? '}' : ']';
+    size_t index = nodes_.size();
+    nodes_.emplace_back(MakeNode(is_object ? NK_OBJECT : NK_ARRAY, *x));
+    ++(*x);
+
+    uint32_t size = 0;
+    SkipWhitespace(x);
+    if (*x < size_ && data_[*x] == close) {
+        ++(*x);
+    } else {
+        while (true) {
+            if (is_object) {
+                SkipWhitespace(x);
+                if (*x == size_ || data_[*x] != '"' || !ParseString(x) ||
+                        !Expect(x, ':')) {
+                    return false;
+                }
+                ++size;
+            }
+
+            if (!ParseValue(x, depth + 1)) {
+                return false;
+            }
+            ++size;
+
+            SkipWhitespace(x);
+            if (*x == size_) {
+                return false;
+            }
+            c = data_[*x];
+            ++(*x);
+            if (c == close) {
+                break;
+            } else if (c != ',') {
+                return false;
+            }
+        }
+    }
+
+    TapeNode* n = &nodes_[index];
+    n->size = size;
+    n->end = *x;
+    n->next = nodes_.size();
+    return true;
+}
+
+bool Tape::Init(const char* data, size_t size) {
+    data_ = data;
+    size_ = size;
+    nodes_.clear();
+
+    // Most documents here are small objects of short strings.
+    nodes_.reserve(size / 8 + 1);
+
+    size_t x = 0;
+    if (!ParseValue(&x, 0)) {
+        nodes_.clear();
+        return false;
+    }
+
+    SkipWhitespace(&x);
+    if (x != size_) {
+        nodes_.clear();
+        return false;
+    }
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+// Unescaping.
+
+static bool ReadHex4(const char* s, size_t size, size_t* x, CodePoint* n) {
+    if (size - *x < 4) {
+        return false;
+    }
+    *n = 0;
+    for (size_t i = 0; i < 4; ++i) {
+        char c = s[(*x)++];
+        CodePoint d;
+        if ('0' <= c && c <= '9') {
+            d = static_cast<CodePoint>(c - '0');
+        } else if ('a' <= c && c <= 'f') {
+            d = static_cast<CodePoint>(c - 'a' + 10);
+        } else if ('A' <= c && c <= 'F') {
+            d = static_cast<CodePoint>(c - 'A' + 10);
+        } else {
+            return false;
+        }
+        *n = *n * 16 + d;
+    }
+    return true;
+}
+
+bool Unescape(const char* s, size_t size, string* out) {
+    size_t x = 0;
+    while (x < size) {
+        char c = s[x++];
+        if (c != '\\') {
+            *out += c;
+            continue;
+        }
+
+        if (x == size) {
+            return false;
+        }
+        c = s[x++];
+        switch (c) {
+        case '"':
+        case '\\':
+        case '/':
+            *out += c;
+            break;
+        case 'b':
+            *out += '\b';
+            break;
+        case 'f':
+            *out += '\f';
+            break;
+        case 'n':
+            *out += '\n';
+            break;
+        case 'r':
+            *out += '\r';
+            break;
+        case 't':
+            *out += '\t';
+            break;
+        case 'u': {
+            CodePoint n;
+            if (!ReadHex4(s, size, &x, &n)) {
+                return false;
+            }
+            // Combine a UTF-16 surrogate pair.
+            if (0xD800 <= n && n < 0xDC00 && size - x >= 6 && s[x] == '\\' &&
+                    s[x + 1] == 'u') {
+                size_t y = x + 2;
+                CodePoint low;
+                if (ReadHex4(s, size, &y, &low) && 0xDC00 <= low &&
+                        low < 0xE000) {
+                    n = 0x10000 + ((n - 0xD800) << 10) + (low - 0xDC00);
+                    x = y;
+                }
+            }
+            AppendUTF8(n, out);
+            break;
+        }
+        default:
+            return false;
+        }
+    }
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+
+}  // namespace json
@@ -0,0 +1,148 @@
+#ifndef CC_FORMAT_JSON_TAPE_H_
+#define CC_FORMAT_JSON_TAPE_H_
+
+// Single-pass JSON tokenizer.
+//
+// A Tape tokenizes a whole document once into a flat array of nodes (in
+// document order, containers before their children) holding offsets into the
+// original buffer, which is never copied.  Values are cheap views into the
+// tape, so a document is read top-down by handing child views to the code
+// that knows what they are, without re-tokenizing or copying any text.
+//
+// Usage:
+//   Tape tape;
+//   if (!tape.Init(s)) { ...malformed... }
+//   Value root = tape.root();
+//   Value v;
+//   if (root.Find("key", &v) && v.IsArray()) {
+//       for (Value e = v.FirstChild(); e.IsValid(); e = e.Next()) { ... }
+//   }
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+using std::string;
+using std::vector;
+
+namespace json {
+
+enum NodeKind {
+    NK_OBJECT,
+    NK_ARRAY,
+    NK_STRING,
+    NK_NUMBER,
+    NK_TRUE,
+    NK_FALSE,
+    NK_NULL
+};
+
+struct TapeNode {
+    uint8_t kind;         // NodeKind.
+    uint8_t has_escapes;  // Strings only: whether unescaping is needed.
+    uint32_t size;        // Containers only: number of children (an object's
+                          // keys and values both count).
+    size_t begin;         // Offset of the text (strings: after the quote).
+    size_t end;           // Offset past the text (strings: at the quote).
+    size_t next;          // Tape index past this node and its descendants.
+};
+
+class Tape;
+
+// View of one value in a Tape.  The Tape must outlive it.
+class Value {
+  public:
+    Value() : tape_(NULL), index_(0), end_(0) {}
+
+    Value(const Tape* tape, size_t index, size_t end) :
+        tape_(tape), index_(index), end_(end) {}
+
+    // False for the views past the last child of a container.
+    bool IsValid() const { return tape_ && index_ < end_; }
+
+    NodeKind kind() const;
+
+    bool IsObject() const { return kind() == NK_OBJECT; }
+    bool IsArray() const { return kind() == NK_ARRAY; }
+    bool IsString() const { return kind() == NK_STRING; }
+    bool IsNumber() const { return kind() == NK_NUMBER; }
+    bool IsBool() const;
+    bool IsNull() const { return kind() == NK_NULL; }
+
+    // Number of children of an array, or of keys and values of an object.
+    size_t size() const;
+
+    // Raw text of the value in the original buffer, exactly as written
+    // (strings: without the quotes, still escaped).
+    const char* data() const;
+    size_t length() const;
+    void GetRaw(string* s) const;
+
+    // Iterate a container's children.  An object's children alternate between
+    // keys (strings) and their values.
+    Value FirstChild() const;
+    Value Next() const;
+
+    // Find the value of a key in an object.  Linear in the object's size.
+    bool Find(const char* key, Value* value) const;
+
+    // Compare a string's contents (unescaped) with the given bytes.
+    bool Equals(const char* s, size_t size) const;
+
+    // Typed reads.  Return false on the wrong kind or a malformed value.
+    bool GetString(string* s) const;
+
+    // A string's contents without copying them, unless they have escapes (then
+    // unescaped into tmp, which s points into).
+    bool GetStringView(const char** s, size_t* size, string* tmp) const;
+
+    bool GetBool(bool* b) const;
+    bool GetInt(int64_t* n) const;
+    bool GetUInt(uint64_t* n) const;
+    bool GetDouble(double* d) const;
+
+  private:
+    const TapeNode& node() const;
+
+    const Tape* tape_;
+    size_t index_;
+    size_t end_;  // Tape index past the parent's descendants.
+};
+
+class Tape {
+  public:
+    Tape() : data_(NULL), size_(0) {}
+
+    // Tokenize a document.  The buffer must outlive the tape and any views
+    // into it.  Returns false if it is not exactly one well-formed value
+    // (surrounding whitespace aside).
+    bool Init(const char* data, size_t size);
+    bool Init(const string& s) { return Init(s.data(), s.size()); }
+
+    // The document's top-level value.
+    Value root() const;
+
+    const char* data() const { return data_; }
+    const vector<TapeNode>& nodes() const { return nodes_; }
+
+  private:
+    void SkipWhitespace(size_t* x) const;
+    bool Expect(size_t* x, char c) const;
+    bool ParseLiteral(size_t* x, const char* literal, NodeKind kind);
+    bool ParseNumber(size_t* x);
+    bool ParseString(size_t* x);
+    bool ParseValue(size_t* x, size_t depth);
+
+    const char* data_;
+    size_t size_;
+    vector<TapeNode> nodes_;
+};
+
+// Unescape the contents of a JSON string (without its quotes), appending to
+// out.  Returns false on a bad escape sequence.
+bool Unescape(const char* s, size_t size, string* out);
+
+}  // namespace json
+
+#endif  // CC_FORMAT_JSON_TAPE_H_
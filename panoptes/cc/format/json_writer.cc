@@ -0,0 +1,279 @@
+#include "json_writer.h"
+
+#include <unistd.h>
+#include <cassert>
+#include <cerrno>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+using std::string;
+using std::vector;
+
+namespace json {
+
+Writer::Writer(string* out) {
+    Init(ST_BUFFER);
+    out_ = out;
+}
+
+Writer::Writer(FILE* file) {
+    Init(ST_FILE);
+    file_ = file;
+}
+
+Writer::Writer(int fd) {
+    Init(ST_FD);
+    fd_ = fd;
+}
+
+Writer::~Writer() {
+    Flush();
+}
+
+void Writer::Init(SinkType sink) {
+    sink_ = sink;
+    out_ = &buf_;
+    file_ = NULL;
+    fd_ = -1;
+    ok_ = true;
+    after_key_ = false;
+    if (sink != ST_BUFFER) {
+        buf_.reserve(JSON_WRITER_BUFFER_SIZE + JSON_WRITER_BUFFER_SIZE / 4);
+    }
+}
+
+// -----------------------------------------------------------------------------
+// Containers.
+
+void Writer::BeginValue() {
+    if (after_key_) {
+        after_key_ = false;
+        return;
+    }
+
+    if (has_items_.empty()) {
+        return;
+    }
+
+    if (has_items_.back()) {
+        *out_ += ',';
+    } else {
+        has_items_.back() = true;
+    }
+}
+
+void Writer::BeginObject() {
+    BeginValue();
+    *out_ += '{';
+    has_items_.emplace_back(false);
+}
+
+void Writer::EndObject() {
+    assert(!has_items_.empty() && !after_key_);
+    has_items_.pop_back();
+    *out_ += '}';
+    MaybeFlush();
+}
+
+void Writer::BeginArray() {
+    BeginValue();
+    *out_ += '[';
+    has_items_.emplace_back(false);
+}
+
+void Writer::EndArray() {
+    assert(!has_items_.empty() && !after_key_);
+    has_items_.pop_back();
+    *out_ += ']';
+    MaybeFlush();
+}
+
+// -----------------------------------------------------------------------------
+// Values.
+
+void Writer::AppendEscaped(const char* s, size_t size) {
+    *out_ += '"';
+
+    // Copy runs of characters that need no escaping in one go.
+    size_t run_begin = 0;
+    for (size_t i = 0; i < size; ++i) {
+        unsigned char c = static_cast<unsigned char>(s[i]);
+        if (c != '"' && c != '\\' && 0x20 <= c) {
+            continue;
+        }
+
+        out_->append(s + run_begin, i - run_begin);
+        run_begin = i + 1;
+
+        switch (c) {
+        case '"':
+            *out_ += "\\\"";
+            break;
+        case '\\':
+            *out_ += "\\\\";
+            break;
+        case '\b':
+            *out_ += "\\b";
+            break;
+        case '\f':
+            *out_ += "\\f";
+            break;
+        case '\n':
+            *out_ += "\\n";
+            break;
+        case '\r':
+            *out_ += "\\r";
+            break;
+        case '\t':
+            *out_ += "\\t";
+            break;
+        default: {
+            char tmp[8];
+            snprintf(tmp, sizeof(tmp), "\\u%04x", static_cast<unsigned>(c));
+            *out_ += tmp;
+            break;
+        }
+        }
+    }
+    out_->append(s + run_begin, size - run_begin);
+
+    *out_ += '"';
+}
+
+void Writer::WriteKey(const char* s) {
+    WriteKey(s, strlen(s));
+}
+
+void Writer::WriteKey(const char* s, size_t size) {
+    assert(!has_items_.empty() && !after_key_);
+    BeginValue();
+    AppendEscaped(s, size);
+    *out_ += ':';
+    after_key_ = true;
+}
+
+void Writer::WriteKey(const string& s) {
+    WriteKey(s.data(), s.size());
+}
+
+void Writer::WriteString(const char* s) {
+    WriteString(s, strlen(s));
+}
+
+void Writer::WriteString(const char* s, size_t size) {
+    BeginValue();
+    AppendEscaped(s, size);
+    MaybeFlush();
+}
+
+void Writer::WriteString(const string& s) {
+    WriteString(s.data(), s.size());
+}
+
+void Writer::WriteBool(bool b) {
+    BeginValue();
+    *out_ += b ? "true" : "false";
+    MaybeFlush();
+}
+
+void Writer::AppendDigits(uint64_t n) {
+    char tmp[24];
+    size_t x = sizeof(tmp);
+    do {
+        tmp[--x] = static_cast<char>('0' + n % 10);
+        n /= 10;
+    } while (n);
+    out_->append(tmp + x, sizeof(tmp) - x);
+}
+
+void Writer::WriteInt(int64_t n) {
+    BeginValue();
+    if (n < 0) {
+        // Negate in unsigned, as -INT64_MIN overflows.
+        *out_ += '-';
+        AppendDigits(0 - static_cast<uint64_t>(n));
+    } else {
+        AppendDigits(static_cast<uint64_t>(n));
+    }
+    MaybeFlush();
+}
+
+void Writer::WriteUInt(uint64_t n) {
+    BeginValue();
+    AppendDigits(n);
+    MaybeFlush();
+}
+
+void Writer::WriteDouble(double d, int precision) {
+    if (!std::isfinite(d)) {
+        WriteNull();
+        return;
+    }
+
+    BeginValue();
+    char tmp[32];
+    int size = snprintf(tmp, sizeof(tmp), "%.*g", precision, d);
+    out_->append(tmp, static_cast<size_t>(size));
+    MaybeFlush();
+}
+
+void Writer::WriteNull() {
+    BeginValue();
+    *out_ += "null";
+    MaybeFlush();
+}
+
+void Writer::WriteRaw(const char* s, size_t size) {
+    BeginValue();
+    out_->append(s, size);
+    MaybeFlush();
+}
+
+void Writer::WriteRaw(const string& s) {
+    WriteRaw(s.data(), s.size());
+}
+
+// -----------------------------------------------------------------------------
+// Output.
+
+void Writer::MaybeFlush() {
+    if (sink_ != ST_BUFFER && JSON_WRITER_BUFFER_SIZE <= buf_.size()) {
+        Flush();
+    }
+}
+
+bool Writer::Flush() {
+    if (sink_ == ST_BUFFER || buf_.empty()) {
+        return ok_;
+    }
+
+    if (sink_ == ST_FILE) {
+        if (fwrite(buf_.data(), 1, buf_.size(), file_) != buf_.size() ||
+                fflush(file_)) {
+            ok_ = false;
+        }
+    } else {
+        const char* p = buf_.data();
+        size_t size = buf_.size();
+        while (size) {
+            ssize_t r = write(fd_, p, size);
+            if (r < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                ok_ = false;
+                break;
+            }
+            p += r;
+            size -= static_cast<size_t>(r);
+        }
+    }
+
+    buf_.clear();
+    return ok_;
+}
+
+}  // namespace json
@@ -0,0 +1,124 @@
+#ifndef CC_FORMAT_JSON_WRITER_H_
+#define CC_FORMAT_JSON_WRITER_H_
+
+// Streaming JSON writer.
+//
+// Serializes straight into its sink as it is called, so nothing is built up
+// per value and copied into its parent: a growable buffer receives the final
+// document directly, and a stream or file descriptor receives it through one
+// fixed-size buffer.  Output is compact (no whitespace).
+//
+// Usage:
+//   string s;
+//   Writer w(&s);
+//   w.BeginObject();
+//   w.WriteKey("lemma");
+//   w.WriteString(lemma);
+//   w.WriteKey("forms");
+//   w.BeginArray();
+//   for (auto& form : forms) { w.WriteString(form); }
+//   w.EndArray();
+//   w.EndObject();
+//
+// Commas and colons are inserted automatically.  Calls must nest properly (the
+// writer asserts on this, but does not validate it in release builds).
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+using std::string;
+using std::vector;
+
+// Bytes buffered before flushing to a stream or file descriptor.
+#define JSON_WRITER_BUFFER_SIZE (64 * 1024)
+
+namespace json {
+
+class Writer {
+  public:
+    // Append to a growable buffer (which keeps its existing contents).
+    explicit Writer(string* out);
+
+    // Write through an internal buffer to a stream or file descriptor, flushed
+    // when it fills, on Flush(), and on destruction.  The writer does not take
+    // ownership.
+    explicit Writer(FILE* file);
+    explicit Writer(int fd);
+
+    Writer(const Writer&) = delete;
+    Writer& operator=(const Writer&) = delete;
+
+    ~Writer();
+
+    void BeginObject();
+    void EndObject();
+    void BeginArray();
+    void EndArray();
+
+    // The key of the next value in the current object.
+    void WriteKey(const char* s);
+    void WriteKey(const char* s, size_t size);
+    void WriteKey(const string& s);
+
+    void WriteString(const char* s);
+    void WriteString(const char* s, size_t size);
+    void WriteString(const string& s);
+
+    void WriteBool(bool b);
+    void WriteInt(int64_t n);
+    void WriteUInt(uint64_t n);
+
+    // Written with enough significant digits to read back exactly (17 for
+    // doubles, 9 for floats).  Non-finite values are written as null.
+    void WriteDouble(double d, int precision = 17);
+
+    void WriteNull();
+
+    // A value that is already serialized JSON, written as is.
+    void WriteRaw(const char* s, size_t size);
+    void WriteRaw(const string& s);
+
+    // Push buffered output to the stream or file descriptor (no-op for a
+    // growable buffer).  Returns false if any write so far has failed.
+    bool Flush();
+
+    bool ok() const { return ok_; }
+
+  private:
+    enum SinkType {
+        ST_BUFFER,
+        ST_FILE,
+        ST_FD
+    };
+
+    void Init(SinkType sink);
+
+    // Write the comma separating this value from the previous one, if any.
+    void BeginValue();
+
+    // Flush once the buffer is full (streams and file descriptors only).
+    void MaybeFlush();
+
+    void AppendEscaped(const char* s, size_t size);
+    void AppendDigits(uint64_t n);
+
+    SinkType sink_;
+    string* out_;  // Where output goes: the caller's buffer or buf_.
+    string buf_;
+    FILE* file_;
+    int fd_;
+    bool ok_;
+
+    // For each open container, whether it has an item yet.
+    vector<uint8_t> has_items_;
+
+    // Whether a key was just written, so its value follows without a comma.
+    bool after_key_;
+};
+
+}  // namespace json
+
+#endif  // CC_FORMAT_JSON_WRITER_H_
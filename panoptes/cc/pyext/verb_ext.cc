@@ -1,17 +1,541 @@
 #include <Python.h>
 
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "cc/base/metrics.h"
 #include "cc/base/warning.h"
+#include "cc/core/ling/verb/verb_manager.h"
+#include "cc/core/ling/verb/verb_parse_arena.h"
+
+using std::pair;
+using std::string;
+using std::vector;
+
+// The Python C API macros are full of C-style casts.
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wold-style-cast"
 
 namespace {
 
+// Field indexes are 0-14 (see ConjugationSpec::GetField()).
+#define NUM_VERB_FIELDS 15
+
+// The engine behind every call, set up once by init().  Never freed, as calls
+// that released the GIL may still be using it at exit.
+VerbManager* VERB_MANAGER = NULL;
+
+const VerbManager* GetVerbManager() {
+    if (!VERB_MANAGER) {
+        PyErr_SetString(PyExc_RuntimeError, "verb_ext.init() was not called.");
+    }
+    return VERB_MANAGER;
+}
+
+// -----------------------------------------------------------------------------
+// Python -> C++.  Each returns false with a Python exception set.
+
+bool GetString(PyObject* obj, string* s) {
+    char* data;
+    Py_ssize_t size;
+    if (PyString_Check(obj)) {
+        if (PyString_AsStringAndSize(obj, &data, &size) < 0) {
+            return false;
+        }
+        s->assign(data, static_cast<size_t>(size));
+        return true;
+    }
+
+    if (PyUnicode_Check(obj)) {
+        PyObject* utf8 = PyUnicode_AsUTF8String(obj);
+        if (!utf8) {
+            return false;
+        }
+        bool ok = PyString_AsStringAndSize(utf8, &data, &size) == 0;
+        if (ok) {
+            s->assign(data, static_cast<size_t>(size));
+        }
+        Py_DECREF(utf8);
+        return ok;
+    }
+
+    PyErr_SetString(PyExc_TypeError, "Expected a string.");
+    return false;
+}
+
+bool GetStrings(PyObject* obj, vector<string>* ss) {
+    PyObject* seq = PySequence_Fast(obj, "Expected a list of strings.");
+    if (!seq) {
+        return false;
+    }
+
+    Py_ssize_t size = PySequence_Fast_GET_SIZE(seq);
+    PyObject** items = PySequence_Fast_ITEMS(seq);
+    ss->resize(static_cast<size_t>(size));
+    bool ok = true;
+    for (Py_ssize_t i = 0; ok && i < size; ++i) {
+        ok = GetString(items[i], &(*ss)[static_cast<size_t>(i)]);
+    }
+    Py_DECREF(seq);
+    return ok;
+}
+
+bool GetUnsigned(PyObject* obj, unsigned* u) {
+    long n = PyInt_AsLong(obj);
+    if (n == -1 && PyErr_Occurred()) {
+        return false;
+    }
+    // Out of range values are passed through as an invalid index.
+    *u = n < 0 || NUM_VERB_FIELDS < n ? NUM_VERB_FIELDS :
+                                        static_cast<unsigned>(n);
+    return true;
+}
+
+// Get a (a, b) argument pair.
+bool GetPair(PyObject* obj, PyObject** a, PyObject** b) {
+    if (!PyTuple_Check(obj) || PyTuple_GET_SIZE(obj) != 2) {
+        PyErr_SetString(PyExc_TypeError, "Expected a pair.");
+        return false;
+    }
+    *a = PyTuple_GET_ITEM(obj, 0);
+    *b = PyTuple_GET_ITEM(obj, 1);
+    return true;
+}
+
+// Look up a key of a dict (borrowed).
+PyObject* GetItem(PyObject* dict, const char* key) {
+    if (!PyDict_Check(dict)) {
+        PyErr_SetString(PyExc_TypeError, "Expected a dict.");
+        return NULL;
+    }
+    PyObject* value = PyDict_GetItemString(dict, key);
+    if (!value) {
+        PyErr_Format(PyExc_KeyError, "Missing key [%s].", key);
+    }
+    return value;
+}
+
+bool GetStringItem(PyObject* dict, const char* key, string* s) {
+    PyObject* value = GetItem(dict, key);
+    return value && GetString(value, s);
+}
+
+bool GetBoolItem(PyObject* dict, const char* key, bool* b) {
+    PyObject* value = GetItem(dict, key);
+    if (!value) {
+        return false;
+    }
+    if (!PyBool_Check(value)) {
+        PyErr_Format(PyExc_TypeError, "Expected a bool for [%s].", key);
+        return false;
+    }
+    *b = value == Py_True;
+    return true;
+}
+
+bool GetThroolItem(PyObject* dict, const char* key, throol* t) {
+    string s;
+    if (!GetStringItem(dict, key, &s)) {
+        return false;
+    }
+    if (!t->FromStr(s)) {
+        PyErr_Format(PyExc_ValueError, "Bad throol for [%s].", key);
+        return false;
+    }
+    return true;
+}
+
+template <typename E>
+bool GetEnumItem(PyObject* dict, const char* key,
+                 const EnumStrings<E>& enum_strings, E* e) {
+    string s;
+    if (!GetStringItem(dict, key, &s)) {
+        return false;
+    }
+    if (!enum_strings.MaybeGetEnumValue(s, e)) {
+        PyErr_Format(PyExc_ValueError, "Bad value for [%s].", key);
+        return false;
+    }
+    return true;
+}
+
+// Get a nested dict item.
+template <typename T>
+bool GetDictItem(PyObject* dict, const char* key,
+                 bool (*get)(PyObject*, T*), T* t) {
+    PyObject* value = GetItem(dict, key);
+    return value && get(value, t);
+}
+
+// Dicts are laid out as in the ToJSON() methods.
+bool GetPolarity(PyObject* dict, Polarity* polarity) {
+    bool tf;
+    throol is_contrary;
+    if (!GetBoolItem(dict, "tf", &tf) ||
+            !GetThroolItem(dict, "is_contrary", &is_contrary)) {
+        return false;
+    }
+    polarity->Init(tf, is_contrary);
+    return true;
+}
+
+bool GetAspect(PyObject* dict, Aspect* aspect) {
+    bool is_perf;
+    bool is_prog;
+    if (!GetBoolItem(dict, "is_perf", &is_perf) ||
+            !GetBoolItem(dict, "is_prog", &is_prog)) {
+        return false;
+    }
+    aspect->Init(is_perf, is_prog);
+    return true;
+}
+
+bool GetModality(PyObject* dict, Modality* modality) {
+    ModalFlavor flavor;
+    bool is_cond;
+    if (!GetEnumItem(dict, "flavor", ModalFlavorStrings, &flavor) ||
+            !GetBoolItem(dict, "is_cond", &is_cond)) {
+        return false;
+    }
+    modality->Init(flavor, is_cond);
+    return true;
+}
+
+bool GetVerb(PyObject* dict, Verb* verb) {
+    string lemma;
+    Polarity polarity;
+    Tense tense;
+    Aspect aspect;
+    Modality modality;
+    VerbForm verb_form;
+    bool is_pro_verb;
+    if (!GetStringItem(dict, "lemma", &lemma) ||
+            !GetDictItem(dict, "polarity", GetPolarity, &polarity) ||
+            !GetEnumItem(dict, "tense", TenseStrings, &tense) ||
+            !GetDictItem(dict, "aspect", GetAspect, &aspect) ||
+            !GetDictItem(dict, "modality", GetModality, &modality) ||
+            !GetEnumItem(dict, "verb_form", VerbFormStrings, &verb_form) ||
+            !GetBoolItem(dict, "is_pro_verb", &is_pro_verb)) {
+        return false;
+    }
+    verb->Init(lemma, polarity, tense, aspect, modality, verb_form,
+               is_pro_verb);
+    return true;
+}
+
+bool GetVerbWithContext(PyObject* dict, VerbWithContext* vwc) {
+    Verb verb;
+    Voice voice;
+    Conjugation conj;
+    bool is_split;
+    RelativeContainment relative_cont;
+    throol contract_not;
+    throol split_inf;
+    SubjunctiveHandling sbj_handling;
+    if (!GetDictItem(dict, "verb", GetVerb, &verb) ||
+            !GetEnumItem(dict, "voice", VoiceStrings, &voice) ||
+            !GetEnumItem(dict, "conj", ConjugationStrings, &conj) ||
+            !GetBoolItem(dict, "is_split", &is_split) ||
+            !GetEnumItem(dict, "relative_cont", RelativeContainmentStrings,
+                         &relative_cont) ||
+            !GetThroolItem(dict, "contract_not", &contract_not) ||
+            !GetThroolItem(dict, "split_inf", &split_inf) ||
+            !GetEnumItem(dict, "sbj_handling", SubjunctiveHandlingStrings,
+                         &sbj_handling)) {
+        return false;
+    }
+
+    vwc->Init(verb, voice, conj, is_split, relative_cont, contract_not,
+              split_inf, sbj_handling);
+    return true;
+}
+
+bool GetVerbSayResult(PyObject* obj, VerbSayResult* vsr) {
+    PyObject* pre_words;
+    PyObject* main_words;
+    return GetPair(obj, &pre_words, &main_words) &&
+           GetStrings(pre_words, &vsr->pre_words) &&
+           GetStrings(main_words, &vsr->main_words);
+}
+
+// Convert each item of a list.
+template <typename T>
+bool GetEach(PyObject* obj, bool (*get)(PyObject*, T*), vector<T>* tt) {
+    PyObject* seq = PySequence_Fast(obj, "Expected a list.");
+    if (!seq) {
+        return false;
+    }
+
+    Py_ssize_t size = PySequence_Fast_GET_SIZE(seq);
+    PyObject** items = PySequence_Fast_ITEMS(seq);
+    tt->resize(static_cast<size_t>(size));
+    bool ok = true;
+    for (Py_ssize_t i = 0; ok && i < size; ++i) {
+        ok = get(items[i], &(*tt)[static_cast<size_t>(i)]);
+    }
+    Py_DECREF(seq);
+    return ok;
+}
+
+// -----------------------------------------------------------------------------
+// C++ -> Python.  Each returns NULL with a Python exception set.
+
+PyObject* NewString(const string& s) {
+    return PyString_FromStringAndSize(
+        s.data(), static_cast<Py_ssize_t>(s.size()));
+}
+
+PyObject* NewStringList(const vector<string>& ss) {
+    PyObject* list = PyList_New(static_cast<Py_ssize_t>(ss.size()));
+    if (!list) {
+        return NULL;
+    }
+    for (size_t i = 0; i < ss.size(); ++i) {
+        PyObject* s = NewString(ss[i]);
+        if (!s) {
+            Py_DECREF(list);
+            return NULL;
+        }
+        PyList_SET_ITEM(list, static_cast<Py_ssize_t>(i), s);
+    }
+    return list;
+}
+
+// Set a dict item, taking the value's reference.
+bool SetItem(PyObject* dict, const char* key, PyObject* value) {
+    if (!value) {
+        return false;
+    }
+    int r = PyDict_SetItemString(dict, key, value);
+    Py_DECREF(value);
+    return !r;
+}
+
+PyObject* NewBool(bool b) {
+    return PyBool_FromLong(b);
+}
+
+PyObject* NewPolarityDict(const Polarity& polarity) {
+    PyObject* dict = PyDict_New();
+    bool ok = dict &&
+        SetItem(dict, "tf", NewBool(polarity.tf())) &&
+        SetItem(dict, "is_contrary",
+                PyString_FromString(polarity.is_contrary().ToStr()));
+    if (!ok) {
+        Py_XDECREF(dict);
+        return NULL;
+    }
+    return dict;
+}
+
+PyObject* NewAspectDict(const Aspect& aspect) {
+    PyObject* dict = PyDict_New();
+    bool ok = dict &&
+        SetItem(dict, "is_perf", NewBool(aspect.is_perf())) &&
+        SetItem(dict, "is_prog", NewBool(aspect.is_prog()));
+    if (!ok) {
+        Py_XDECREF(dict);
+        return NULL;
+    }
+    return dict;
+}
+
+PyObject* NewModalityDict(const Modality& modality) {
+    PyObject* dict = PyDict_New();
+    bool ok = dict &&
+        SetItem(dict, "flavor",
+                NewString(ModalFlavorStrings.GetString(modality.flavor()))) &&
+        SetItem(dict, "is_cond", NewBool(modality.is_cond()));
+    if (!ok) {
+        Py_XDECREF(dict);
+        return NULL;
+    }
+    return dict;
+}
+
+PyObject* NewVerbDict(const Verb& verb) {
+    PyObject* dict = PyDict_New();
+    bool ok = dict &&
+        SetItem(dict, "lemma", NewString(verb.lemma())) &&
+        SetItem(dict, "polarity", NewPolarityDict(verb.polarity())) &&
+        SetItem(dict, "tense",
+                NewString(TenseStrings.GetString(verb.tense()))) &&
+        SetItem(dict, "aspect", NewAspectDict(verb.aspect())) &&
+        SetItem(dict, "modality", NewModalityDict(verb.modality())) &&
+        SetItem(dict, "verb_form",
+                NewString(VerbFormStrings.GetString(verb.verb_form()))) &&
+        SetItem(dict, "is_pro_verb", NewBool(verb.is_pro_verb()));
+    if (!ok) {
+        Py_XDECREF(dict);
+        return NULL;
+    }
+    return dict;
+}
+
+PyObject* NewVerbWithContextDict(const VerbWithContext& vwc) {
+    PyObject* dict = PyDict_New();
+    bool ok = dict &&
+        SetItem(dict, "verb", NewVerbDict(vwc.verb())) &&
+        SetItem(dict, "voice",
+                NewString(VoiceStrings.GetString(vwc.voice()))) &&
+        SetItem(dict, "conj",
+                NewString(ConjugationStrings.GetString(vwc.conj()))) &&
+        SetItem(dict, "is_split", NewBool(vwc.is_split())) &&
+        SetItem(dict, "relative_cont", NewString(
+            RelativeContainmentStrings.GetString(vwc.relative_cont()))) &&
+        SetItem(dict, "contract_not",
+                PyString_FromString(vwc.contract_not().ToStr())) &&
+        SetItem(dict, "split_inf",
+                PyString_FromString(vwc.split_inf().ToStr())) &&
+        SetItem(dict, "sbj_handling", NewString(
+            SubjunctiveHandlingStrings.GetString(vwc.sbj_handling())));
+    if (!ok) {
+        Py_XDECREF(dict);
+        return NULL;
+    }
+    return dict;
+}
+
+// (pre words, main words).
+PyObject* NewVerbSayResultTuple(const VerbSayResult& vsr) {
+    PyObject* pre_words = NewStringList(vsr.pre_words);
+    PyObject* main_words = NewStringList(vsr.main_words);
+    PyObject* tuple = NULL;
+    if (pre_words && main_words) {
+        tuple = PyTuple_Pack(2, pre_words, main_words);
+    }
+    Py_XDECREF(pre_words);
+    Py_XDECREF(main_words);
+    return tuple;
+}
+
+// List of (lemma, field index).
+PyObject* NewLemmasIndexesList(const vector<LemmaAndIndex>& lemmas_idxs) {
+    PyObject* list = PyList_New(static_cast<Py_ssize_t>(lemmas_idxs.size()));
+    if (!list) {
+        return NULL;
+    }
+    for (size_t i = 0; i < lemmas_idxs.size(); ++i) {
+        const LemmaAndIndex& li = lemmas_idxs[i];
+        PyObject* item = Py_BuildValue(
+            "(s#I)", li.lemma.data(), static_cast<int>(li.lemma.size()),
+            static_cast<unsigned>(li.index));
+        if (!item) {
+            Py_DECREF(list);
+            return NULL;
+        }
+        PyList_SET_ITEM(list, static_cast<Py_ssize_t>(i), item);
+    }
+    return list;
+}
+
+// List of VerbWithContext dicts for parses [begin, end_excl) of the arena.
+PyObject* NewParsesList(const VerbParseArena& arena, size_t begin,
+                        size_t end_excl) {
+    PyObject* list = PyList_New(static_cast<Py_ssize_t>(end_excl - begin));
+    if (!list) {
+        return NULL;
+    }
+    VerbWithContext vwc;
+    for (size_t i = begin; i < end_excl; ++i) {
+        arena.GetVerbWithContext(i, &vwc);
+        PyObject* dict = NewVerbWithContextDict(vwc);
+        if (!dict) {
+            Py_DECREF(list);
+            return NULL;
+        }
+        PyList_SET_ITEM(list, static_cast<Py_ssize_t>(i - begin), dict);
+    }
+    return list;
+}
+
+// -----------------------------------------------------------------------------
+// The C++ side, run without the GIL.
+
+bool IsLemmaOk(const string& lemma) {
+    if (lemma.empty()) {
+        return false;
+    }
+    for (char c : lemma) {
+        if (!('a' <= c && c <= 'z') && !('A' <= c && c <= 'Z')) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool Conjugate(const VerbManager& vm, const string& lemma,
+               unsigned field_index, string* conjugated) {
+    if (!IsLemmaOk(lemma) || NUM_VERB_FIELDS <= field_index) {
+        return false;
+    }
+    return vm.conjugator().Conjugate(lemma, field_index, conjugated);
+}
+
+// Get a (lemma, field index) pair.
+bool GetConjugateArgs(PyObject* obj, pair<string, unsigned>* args) {
+    PyObject* lemma;
+    PyObject* field_index;
+    return GetPair(obj, &lemma, &field_index) &&
+           GetString(lemma, &args->first) &&
+           GetUnsigned(field_index, &args->second);
+}
+
+// -----------------------------------------------------------------------------
+
 char VERB_EXT_DOC[] =
-    "Verb handling in C++ for performance reasons.\n";
+    "Verb handling in C++ for performance reasons.\n"
+    "\n"
+    "Call init() first.  The *_many() variants take a list and return a list\n"
+    "of what the single versions would, releasing the GIL while in C++.\n"
+    "\n"
+    "VerbWithContext dicts are laid out as in VerbWithContext::ToJSON().\n";
+
+char INIT_DOC[] =
+    "(conjugations_f, modal_past_tense_f, modalities_f, verb_parses_f) ->\n"
+    "bool.\n"
+    "\n"
+    "Load the verb engine.  Only once.  If verb_parses_f does not exist, the\n"
+    "parse tables are generated (slow) and saved there.\n";
+
+PyObject* init(PyObject* self, PyObject* args) {
+    UNUSED(self);
+    if (VERB_MANAGER) {
+        PyErr_SetString(PyExc_RuntimeError,
+                        "verb_ext.init() was already called.");
+        return NULL;
+    }
+
+    const char* conjugations_f;
+    const char* modal_past_tense_f;
+    const char* modalities_f;
+    const char* verb_parses_f;
+    if (!PyArg_ParseTuple(args, "ssss", &conjugations_f, &modal_past_tense_f,
+                          &modalities_f, &verb_parses_f)) {
+        return NULL;
+    }
+
+    VerbManager* vm = new VerbManager();
+    bool ok;
+    Py_BEGIN_ALLOW_THREADS
+    ok = vm->Init(conjugations_f, modal_past_tense_f, modalities_f,
+                  verb_parses_f);
+    Py_END_ALLOW_THREADS
+    if (!ok) {
+        delete vm;
+        Py_RETURN_FALSE;
+    }
+
+    VERB_MANAGER = vm;
+    Py_RETURN_TRUE;
+}
 
 char CONJUGATE_DOC[] =
     "(lemma, verb field index) -> conjugated verb word or None on error.\n"
     "\n"
-    "Lemma must be alpha.  Returns None on invalid lemma or invalid field\n"
-    "index.\n"
+    "Lemma must be alpha.  Returns None on invalid lemma (including one that\n"
+    "ends unlike any known verb) or invalid field index.\n"
     "\n"
     "Verb field index is\n"
     "* 0 lemma\n"
@@ -22,8 +546,59 @@ char CONJUGATE_DOC[] =
 
 PyObject* conjugate(PyObject* self, PyObject* args) {
     UNUSED(self);
-    UNUSED(args);
-    return NULL;  // XXX
+    const VerbManager* vm = GetVerbManager();
+    pair<string, unsigned> lemma_index;
+    if (!vm || !GetConjugateArgs(args, &lemma_index)) {
+        return NULL;
+    }
+
+    string conjugated;
+    if (!Conjugate(*vm, lemma_index.first, lemma_index.second,
+                   &conjugated)) {
+        Py_RETURN_NONE;
+    }
+    return NewString(conjugated);
+}
+
+char CONJUGATE_MANY_DOC[] =
+    "list of (lemma, verb field index) -> list of conjugate().\n";
+
+PyObject* conjugate_many(PyObject* self, PyObject* arg) {
+    UNUSED(self);
+    const VerbManager* vm = GetVerbManager();
+    vector<pair<string, unsigned> > lemmas_indexes;
+    if (!vm || !GetEach(arg, GetConjugateArgs, &lemmas_indexes)) {
+        return NULL;
+    }
+
+    vector<string> conjugated(lemmas_indexes.size());
+    vector<uint8_t> oks(lemmas_indexes.size());
+    Py_BEGIN_ALLOW_THREADS
+    for (size_t i = 0; i < lemmas_indexes.size(); ++i) {
+        oks[i] = Conjugate(*vm, lemmas_indexes[i].first,
+                           lemmas_indexes[i].second, &conjugated[i]);
+    }
+    Py_END_ALLOW_THREADS
+
+    PyObject* list = PyList_New(static_cast<Py_ssize_t>(conjugated.size()));
+    if (!list) {
+        return NULL;
+    }
+    for (size_t i = 0; i < conjugated.size(); ++i) {
+        PyObject* item;
+        if (oks[i]) {
+            item = NewString(conjugated[i]);
+            if (!item) {
+                Py_DECREF(list);
+                return NULL;
+            }
+        } else {
+            Py_INCREF(Py_None);
+            item = Py_None;
+        }
+        PyList_SET_ITEM(list, static_cast<Py_ssize_t>(i), item);
+    }
+    return list;
 }
 
 char LEMMATIZE_DOC[] =
@@ -36,28 +611,124 @@ char LEMMATIZE_DOC[] =
     "* 3-8 nonpast: 1st person singular, 2s, 3s, 1st plural, 2p, 3p\n"
     "* 9-14 past: 1st person singular, 2s, 3s, 1st plural, 2p, 3p\n";
 
-PyObject* lemmatize(PyObject* self, PyObject* args) {
+PyObject* lemmatize(PyObject* self, PyObject* arg) {
     UNUSED(self);
-    UNUSED(args);
-    return NULL;  // XXX
+    const VerbManager* vm = GetVerbManager();
+    string word;
+    if (!vm || !GetString(arg, &word)) {
+        return NULL;
+    }
+
+    vector<LemmaAndIndex> lemmas_idxs;
+    vm->conjugator().IdentifyWord(word, true, &lemmas_idxs);
+    return NewLemmasIndexesList(lemmas_idxs);
+}
+
+char LEMMATIZE_MANY_DOC[] =
+    "list of conjugated verb words -> list of lemmatize().\n";
+
+PyObject* lemmatize_many(PyObject* self, PyObject* arg) {
+    UNUSED(self);
+    const VerbManager* vm = GetVerbManager();
+    vector<string> words;
+    if (!vm || !GetStrings(arg, &words)) {
+        return NULL;
+    }
+
+    vector<vector<LemmaAndIndex> > lemmas_idxs(words.size());
+    Py_BEGIN_ALLOW_THREADS
+    IdentifyWordScratch scratch;
+    for (size_t i = 0; i < words.size(); ++i) {
+        vm->conjugator().IdentifyWord(words[i], true, &scratch,
+                                      &lemmas_idxs[i]);
+    }
+    Py_END_ALLOW_THREADS
+
+    PyObject* list = PyList_New(static_cast<Py_ssize_t>(words.size()));
+    if (!list) {
+        return NULL;
+    }
+    for (size_t i = 0; i < words.size(); ++i) {
+        PyObject* item = NewLemmasIndexesList(lemmas_idxs[i]);
+        if (!item) {
+            Py_DECREF(list);
+            return NULL;
+        }
+        PyList_SET_ITEM(list, static_cast<Py_ssize_t>(i), item);
+    }
+    return list;
 }
 
 char SAY_DOC[] =
-    "VerbWithContext as dict -> (pre words, main words) or None.\n";
+    "VerbWithContext as dict -> (pre words, main words) or None.\n"
+    "\n"
+    "None if the verb is invalid, or its lemma can't be conjugated.\n";
 
-PyObject* say(PyObject* self, PyObject* args) {
+PyObject* say(PyObject* self, PyObject* arg) {
     UNUSED(self);
-    UNUSED(args);
-    return NULL;  // XXX
+    const VerbManager* vm = GetVerbManager();
+    VerbWithContext vwc;
+    if (!vm || !GetVerbWithContext(arg, &vwc)) {
+        return NULL;
+    }
+
+    VerbSayResult vsr;
+    if (vm->Say(vwc, &vsr) != VSS_OK) {
+        Py_RETURN_NONE;
+    }
+    return NewVerbSayResultTuple(vsr);
+}
+
+char SAY_MANY_DOC[] =
+    "list of VerbWithContext dicts -> list of say().\n";
+
+PyObject* say_many(PyObject* self, PyObject* arg) {
+    UNUSED(self);
+    const VerbManager* vm = GetVerbManager();
+    vector<VerbWithContext> vwcs;
+    if (!vm || !GetEach(arg, GetVerbWithContext, &vwcs)) {
+        return NULL;
+    }
+
+    vector<VerbSayResult> vsrs;
+    vector<VerbSayStatus> statuses;
+    Py_BEGIN_ALLOW_THREADS
+    vm->SayBatch(vwcs.data(), vwcs.size(), &vsrs, &statuses);
+    Py_END_ALLOW_THREADS
+
+    PyObject* list = PyList_New(static_cast<Py_ssize_t>(vsrs.size()));
+    if (!list) {
+        return NULL;
+    }
+    for (size_t i = 0; i < vsrs.size(); ++i) {
+        PyObject* item;
+        if (statuses[i] == VSS_OK) {
+            item = NewVerbSayResultTuple(vsrs[i]);
+            if (!item) {
+                Py_DECREF(list);
+                return NULL;
+            }
+        } else {
+            Py_INCREF(Py_None);
+            item = Py_None;
+        }
+        PyList_SET_ITEM(list, static_cast<Py_ssize_t>(i), item);
+    }
+    return list;
 }
 
 char IS_VALID_DOC[] =
     "VerbWithContext -> bool.\n";
 
-PyObject* is_valid(PyObject* self, PyObject* args) {
+PyObject* is_valid(PyObject* self, PyObject* arg) {
     UNUSED(self);
-    UNUSED(args);
-    return NULL;  // XXX
+    const VerbManager* vm = GetVerbManager();
+    VerbWithContext vwc;
+    if (!vm || !GetVerbWithContext(arg, &vwc)) {
+        return NULL;
+    }
+
+    return NewBool(vm->IsValid(vwc));
 }
 
 char PARSE_DOC[] =
@@ -65,20 +736,97 @@ char PARSE_DOC[] =
 
 PyObject* parse(PyObject* self, PyObject* args) {
     UNUSED(self);
-    UNUSED(args);
-    return NULL;  // XXX
+    const VerbManager* vm = GetVerbManager();
+    VerbSayResult vsr;
+    if (!vm || !GetVerbSayResult(args, &vsr)) {
+        return NULL;
+    }
+
+    VerbParseArena arena;
+    vm->ParseBatch(&vsr, 1, &arena);
+    return NewParsesList(arena, arena.offsets[0], arena.offsets[1]);
 }
 
+char PARSE_MANY_DOC[] =
+    "list of (pre words, main words) -> list of parse().\n";
+
+PyObject* parse_many(PyObject* self, PyObject* arg) {
+    UNUSED(self);
+    const VerbManager* vm = GetVerbManager();
+    vector<VerbSayResult> vsrs;
+    if (!vm || !GetEach(arg, GetVerbSayResult, &vsrs)) {
+        return NULL;
+    }
+
+    VerbParseArena arena;
+    Py_BEGIN_ALLOW_THREADS
+    vm->ParseBatch(vsrs.data(), vsrs.size(), &arena);
+    Py_END_ALLOW_THREADS
+
+    PyObject* list = PyList_New(static_cast<Py_ssize_t>(vsrs.size()));
+    if (!list) {
+        return NULL;
+    }
+    for (size_t i = 0; i < vsrs.size(); ++i) {
+        PyObject* item = NewParsesList(arena, arena.offsets[i],
+                                       arena.offsets[i + 1]);
+        if (!item) {
+            Py_DECREF(list);
+            return NULL;
+        }
+        PyList_SET_ITEM(list, static_cast<Py_ssize_t>(i), item);
+    }
+    return list;
+}
+
+char METRICS_DOC[] =
+    "-> str.\n"
+    "\n"
+    "Snapshot of the engine's counters and latency histograms, as JSON.\n";
+
+PyObject* metrics(PyObject* self, PyObject* arg) {
+    UNUSED(self);
+    UNUSED(arg);
+    string s;
+    Metrics::ToJSON(&s);
+    return NewString(s);
+}
+
+char METRICS_TEXT_DOC[] =
+    "-> str.\n"
+    "\n"
+    "Same as metrics(), as one line per metric.\n";
+
+PyObject* metrics_text(PyObject* self, PyObject* arg) {
+    UNUSED(self);
+    UNUSED(arg);
+    string s;
+    Metrics::ToText(&s);
+    return NewString(s);
+}
+
+// Single-argument functions take it directly (METH_O), skipping the argument
+// tuple.
 PyMethodDef VERB_EXT_METHODS[] = {
+    {"init", init, METH_VARARGS, INIT_DOC},
     {"conjugate", conjugate, METH_VARARGS, CONJUGATE_DOC},
-    {"lemmatize", lemmatize, METH_VARARGS, LEMMATIZE_DOC},
-    {"say", say, METH_VARARGS, SAY_DOC},
-    {"is_valid", is_valid, METH_VARARGS, IS_VALID_DOC},
+    {"conjugate_many", conjugate_many, METH_O, CONJUGATE_MANY_DOC},
+    {"lemmatize", lemmatize, METH_O, LEMMATIZE_DOC},
+    {"lemmatize_many", lemmatize_many, METH_O, LEMMATIZE_MANY_DOC},
+    {"say", say, METH_O, SAY_DOC},
+    {"say_many", say_many, METH_O, SAY_MANY_DOC},
+    {"is_valid", is_valid, METH_O, IS_VALID_DOC},
     {"parse", parse, METH_VARARGS, PARSE_DOC},
+    {"parse_many", parse_many, METH_O, PARSE_MANY_DOC},
+    {"metrics", metrics, METH_NOARGS, METRICS_DOC},
+    {"metrics_text", metrics_text, METH_NOARGS, METRICS_TEXT_DOC},
+    {NULL, NULL, 0, NULL}
 };
 
 }  // namespace
 
+#pragma clang diagnostic pop
+
 #pragma clang diagnostic push
 #pragma clang diagnostic ignored "-Wmissing-prototypes"
 PyMODINIT_FUNC initverb_ext(void) {